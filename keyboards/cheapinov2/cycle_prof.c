@@ -0,0 +1,77 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-subsystem time accounting: storage, main-loop/debounce brackets and a
+// host driver proxy that times every USB report send.
+
+#include "quantum.h"
+#include "host.h"
+#include "host_driver.h"
+#include "cycle_prof.h"
+
+#ifdef CYCLE_PROF
+
+cycle_prof_t cycle_prof[PROF_COUNT];
+uint32_t     cycle_prof_start[PROF_COUNT];
+
+const cycle_prof_t *cycle_prof_get(void) {
+    return cycle_prof;
+}
+
+void cycle_prof_reset(void) {
+    memset(cycle_prof, 0, sizeof(cycle_prof));
+}
+
+// Report sends pass through this copy of the protocol's driver
+static host_driver_t *prof_real_driver = NULL;
+static host_driver_t  prof_driver;
+
+static void prof_send_keyboard(report_keyboard_t *report) {
+    CYCLE_PROF_SCOPE(PROF_USB_SEND);
+    prof_real_driver->send_keyboard(report);
+}
+
+static void prof_send_nkro(report_nkro_t *report) {
+    CYCLE_PROF_SCOPE(PROF_USB_SEND);
+    prof_real_driver->send_nkro(report);
+}
+
+static void prof_send_mouse(report_mouse_t *report) {
+    CYCLE_PROF_SCOPE(PROF_USB_SEND);
+    prof_real_driver->send_mouse(report);
+}
+
+static void prof_send_extra(report_extra_t *report) {
+    CYCLE_PROF_SCOPE(PROF_USB_SEND);
+    prof_real_driver->send_extra(report);
+}
+
+// The protocol sets its driver after keyboard_init(), so wrap it on first sight
+static void prof_wrap_driver(void) {
+    host_driver_t *driver = host_get_driver();
+    if (driver == NULL || driver == &prof_driver) return;
+    prof_real_driver          = driver;
+    prof_driver               = *driver;
+    prof_driver.send_keyboard = prof_send_keyboard;
+    prof_driver.send_nkro     = prof_send_nkro;
+    prof_driver.send_mouse    = prof_send_mouse;
+    prof_driver.send_extra    = prof_send_extra;
+    host_set_driver(&prof_driver);
+}
+
+// debounce() runs between matrix_scan_custom() (which opens the probe) and here
+void matrix_scan_kb(void) {
+    CYCLE_PROF_END(PROF_DEBOUNCE);
+    matrix_scan_user();
+}
+
+void housekeeping_task_kb(void) {
+    static bool looping = false;
+    if (looping) CYCLE_PROF_END(PROF_LOOP);
+    looping = true;
+    CYCLE_PROF_BEGIN(PROF_LOOP);
+    prof_wrap_driver();
+    housekeeping_task_user();
+}
+
+#endif
@@ -0,0 +1,94 @@
+//
+// Per-subsystem time accounting (RP2040 1 MHz timer)
+//
+// With CYCLE_PROF = yes in the keymap's rules.mk, begin/end probes around
+// each subsystem add the elapsed µs to its total, max and call count; without
+// it every probe compiles to nothing. Times are inclusive: a probe nested in
+// another (USB send inside process_record_user, LED push inside a deferred
+// callback) is counted in both. Single µs readings are coarse, but the timer
+// free-runs independent of the probes, so totals over many calls are exact
+// on average. PROF_LOOP is one main-loop pass (housekeeping to housekeeping):
+// compare the other totals against it to see where the loop time goes.
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// Subsystems in report order (tools/toby_hid.py prof mirrors the names)
+#define CYCLE_PROF_IDS(X)                                  \
+    X(PROF_LOOP, "main loop")                              \
+    X(PROF_SCAN_ROWS, "scan: rows -> cols")                \
+    X(PROF_SCAN_COLS, "scan: cols -> rows")                \
+    X(PROF_ENCODER, "fix_encoder_action")                  \
+    X(PROF_GHOSTING, "fix_ghosting")                       \
+    X(PROF_DEBOUNCE, "debounce")                           \
+    X(PROF_PRE_RECORD, "pre_process_record_user")          \
+    X(PROF_COMBO, "  combo_index_process")                 \
+    X(PROF_RECORD, "process_record_user")                  \
+    X(PROF_AUTOCORRECT, "  process_autocorrect_ac")        \
+    X(PROF_MOUSE, "  mouse_engine_process")                \
+    X(PROF_DEFER, "defer_exec callbacks")                  \
+    X(PROF_LED, "LED push")                                \
+    X(PROF_USB_SEND, "USB send")
+
+#define CYCLE_PROF_ENUM(id, name) id,
+enum { CYCLE_PROF_IDS(CYCLE_PROF_ENUM) PROF_COUNT };
+#undef CYCLE_PROF_ENUM
+
+typedef struct {
+    uint32_t total_us;
+    uint32_t count;
+    uint32_t max_us;
+} cycle_prof_t;
+
+#ifdef CYCLE_PROF
+
+#    include "quantum.h"
+
+// Probe clock; the host harness (tests/host) substitutes the CPU cycle counter
+#    ifndef CYCLE_PROF_CLOCK
+#        define CYCLE_PROF_CLOCK() (TIMER->TIMERAWL)
+#    endif
+
+extern cycle_prof_t cycle_prof[PROF_COUNT];
+extern uint32_t     cycle_prof_start[PROF_COUNT];
+
+static inline void cycle_prof_begin(uint8_t id) {
+    cycle_prof_start[id] = CYCLE_PROF_CLOCK();
+}
+
+static inline void cycle_prof_end(uint8_t id) {
+    uint32_t us = CYCLE_PROF_CLOCK() - cycle_prof_start[id];
+    cycle_prof[id].total_us += us;
+    cycle_prof[id].count++;
+    if (us > cycle_prof[id].max_us) cycle_prof[id].max_us = us;
+}
+
+// Scope probe: ends on every return path of the enclosing block
+static inline void cycle_prof_scope_end(uint8_t *id) {
+    cycle_prof_end(*id);
+}
+
+#    define CYCLE_PROF_BEGIN(id) cycle_prof_begin(id)
+#    define CYCLE_PROF_END(id) cycle_prof_end(id)
+#    define CYCLE_PROF_SCOPE(id) \
+        uint8_t _cycle_prof_scope __attribute__((cleanup(cycle_prof_scope_end), unused)) = (cycle_prof_begin(id), (id))
+// Probe one call and yield its result
+#    define CYCLE_PROF_CALL(id, call)                \
+        ({                                           \
+            cycle_prof_begin(id);                    \
+            __typeof__(call) _cycle_prof_r = (call); \
+            cycle_prof_end(id);                      \
+            _cycle_prof_r;                           \
+        })
+
+const cycle_prof_t *cycle_prof_get(void);
+void                cycle_prof_reset(void);
+
+#else
+#    define CYCLE_PROF_BEGIN(id) ((void)0)
+#    define CYCLE_PROF_END(id) ((void)0)
+#    define CYCLE_PROF_SCOPE(id) ((void)0)
+#    define CYCLE_PROF_CALL(id, call) (call)
+#endif
@@ -1,5 +1,6 @@
 #include "matrix.h"
 #include "quantum.h"
+#include "hot_path.h"
 
 #define COL_SHIFTER ((uint16_t)1)
 
@@ -32,7 +33,7 @@ void turned(bool clockwise) {
     }
 }
 
-void fix_encoder_action(matrix_row_t current_matrix[]) {
+void HOT_FUNC(fix_encoder_action)(matrix_row_t current_matrix[]) {
     matrix_row_t encoder_row = current_matrix[ENC_ROW];
 
     if (encoder_row & (COL_SHIFTER << ENC_BUTTON_COL)) {
@@ -5,6 +5,7 @@
 #include "matrix.h"
 #include "quantum.h"
 #include "print.h"
+#include "hot_path.h"
 
 // This is just to be able to declare constants as they appear in the qmk console
 #define rev(b) \
@@ -41,11 +42,11 @@ void printBits(uint16_t n)
 }
 */
 
-bool bit_pattern_set(uint16_t number, uint16_t bitPattern) {
+bool HOT_FUNC(bit_pattern_set)(uint16_t number, uint16_t bitPattern) {
     return !(~number & bitPattern);
 }
 
-void fix_ghosting_instance(
+void HOT_FUNC(fix_ghosting_instance)(
         matrix_row_t current_matrix[],
         unsigned short row_num_with_possible_error_cause,
         uint16_t possible_error_cause,
@@ -59,7 +60,7 @@ void fix_ghosting_instance(
     }
 }
 
-void fix_ghosting_column(
+void HOT_FUNC(fix_ghosting_column)(
         matrix_row_t matrix[],
         uint16_t possible_error_cause,
         uint16_t possible_error,
@@ -80,7 +81,7 @@ void fix_ghosting_column(
 // For QWERTY layout, key combo a+s+e also outputs q. This suppresses the q, and other similar ghosts
 // These are observed ghosts(following a pattern). TODO: need to fix this for v3
 // Might need to add 2 diodes(one in each direction) for every row, to increase voltage drop.
-void fix_ghosting(matrix_row_t matrix[]) {
+void HOT_FUNC(fix_ghosting)(matrix_row_t matrix[]) {
     fix_ghosting_column(matrix,
                         rev(0B0110000000000000),
                         rev(0B1010000000000000),
@@ -0,0 +1,20 @@
+//
+// SRAM-resident hot path (RP2040)
+//
+// With SRAM_HOT_PATH = yes in rules.mk, functions marked HOT_FUNC() go to
+// .time_critical.<name> and tables marked HOT_DATA(name) to .data.hot.<name>.
+// The RP2040 linker script copies both into SRAM at boot (the same mechanism
+// as pico-sdk's __not_in_flash_func), so the scan path no longer competes
+// with rgblight/USB code for the 16 KB XIP cache.
+// SRAM cost: tools/sram_report.py <build>.map
+//
+
+#pragma once
+
+#ifdef SRAM_HOT_PATH
+#    define HOT_FUNC(name) __attribute__((section(".time_critical." #name), noinline)) name
+#    define HOT_DATA(name) __attribute__((section(".data.hot." #name)))
+#else
+#    define HOT_FUNC(name) name
+#    define HOT_DATA(name)
+#endif
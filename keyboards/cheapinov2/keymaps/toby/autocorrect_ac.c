@@ -0,0 +1,158 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Aho-Corasick autocorrect: one automaton step per key.
+
+#include QMK_KEYBOARD_H
+#include "autocorrect_ac.h"
+#include "autocorrect_ac_data.h"
+#include "autocorrect_learn.h"
+#include "out_queue.h"
+#include "string_out.h"
+
+#define AC_SYM_QUOTE    26
+#define AC_SYM_BOUNDARY 27
+#define AC_ROOT         0
+
+// Symbol for a key: a-z, ', word boundary; AC_SYM_NONE resets, AC_SYM_BACK steps back
+#define AC_SYM_NONE 0xFF
+#define AC_SYM_BACK 0xFE
+
+static bool ac_enabled = true;
+
+// States after each recent key, so backspace can step back (ring buffer)
+static ac_state_t ac_hist[AUTOCORRECT_MAX_LENGTH];
+static uint8_t    ac_hist_pos = 0;
+static uint8_t    ac_hist_len = 0;
+static ac_state_t ac_state    = AC_ROOT;
+
+static inline bool ac_goto(ac_state_t s, uint8_t sym, ac_state_t *next) {
+    uint32_t bits = pgm_read_dword(&ac_children[s]);
+    if (!(bits & (1ul << sym))) return false;
+    *next = (ac_state_t)(ac_read_state(&ac_first[s]) + __builtin_popcount(bits & ((1ul << sym) - 1)));
+    return true;
+}
+
+static ac_state_t ac_step(ac_state_t s, uint8_t sym) {
+    ac_state_t next;
+    while (!ac_goto(s, sym, &next)) {
+        if (s == AC_ROOT) return AC_ROOT;
+        s = ac_read_state(&ac_fail[s]);
+    }
+    return next;
+}
+
+static void ac_reset(ac_state_t s) {
+    ac_state    = s;
+    ac_hist_len = 0;
+}
+
+static void ac_push(ac_state_t s) {
+    ac_hist[ac_hist_pos] = ac_state;
+    ac_hist_pos          = (ac_hist_pos + 1) % AUTOCORRECT_MAX_LENGTH;
+    if (ac_hist_len < AUTOCORRECT_MAX_LENGTH) ac_hist_len++;
+    ac_state = s;
+}
+
+static void ac_pop(void) {
+    if (ac_hist_len == 0) {
+        ac_state = AC_ROOT;
+        return;
+    }
+    ac_hist_pos = (ac_hist_pos + AUTOCORRECT_MAX_LENGTH - 1) % AUTOCORRECT_MAX_LENGTH;
+    ac_hist_len--;
+    ac_state = ac_hist[ac_hist_pos];
+}
+
+static uint8_t ac_symbol_for(uint16_t keycode) {
+    switch (keycode) {
+        case KC_A ... KC_Z:
+            return (uint8_t)(keycode - KC_A);
+        case KC_QUOT:
+            return AC_SYM_QUOTE;
+        case KC_1 ... KC_0:
+        case KC_ENT:
+        case KC_TAB ... KC_SCLN:
+        case KC_GRV ... KC_SLSH:
+            return AC_SYM_BOUNDARY;
+        case KC_BSPC:
+            return AC_SYM_BACK;
+        default:
+            return AC_SYM_NONE;
+    }
+}
+
+void autocorrect_ac_init(void) {
+    // Boot is a word start, like QMK's buffer primed with a space
+    ac_reset(ac_step(AC_ROOT, AC_SYM_BOUNDARY));
+}
+
+bool process_autocorrect_ac(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return true;
+
+    switch (keycode) {
+        case AC_TOGG: ac_enabled = !ac_enabled; ac_reset(AC_ROOT); return false;
+        case AC_ON:   ac_enabled = true;        ac_reset(AC_ROOT); return false;
+        case AC_OFF:  ac_enabled = false;                          return false;
+    }
+
+    // Tap keycode of mod-tap/layer-tap keys; holds don't type anything
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        if (record->tap.count == 0) return true;
+        keycode = IS_QK_MOD_TAP(keycode) ? QK_MOD_TAP_GET_TAP_KEYCODE(keycode) : QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    // Shortcuts (anything but Shift) end the word without a boundary
+    uint8_t sym = ac_symbol_for(keycode);
+    if ((get_mods() | get_oneshot_mods()) & ~MOD_MASK_SHIFT) sym = AC_SYM_NONE;
+
+    // The learner watches typing whether or not corrections are on
+    switch (sym) {
+        case AC_SYM_NONE:     ac_learn_reset();     break;
+        case AC_SYM_BACK:     ac_learn_backspace(); break;
+        case AC_SYM_BOUNDARY: ac_learn_boundary();  break;
+        case AC_SYM_QUOTE:    ac_learn_char('\''); break;
+        default:              ac_learn_char((char)('a' + sym)); break;
+    }
+    if (!ac_enabled) return true;
+
+    if (sym == AC_SYM_NONE) {
+        ac_reset(AC_ROOT);
+        return true;
+    }
+    if (sym == AC_SYM_BACK) {
+        ac_pop();
+        return true;
+    }
+
+    ac_push(ac_step(ac_state, sym));
+    uint16_t out = pgm_read_word(&ac_output[ac_state]);
+    if (!out) return true;
+
+    // Typo matched: erase, type the replacement, continue after a fresh word start
+    ac_correction_t fix;
+    memcpy_P(&fix, &ac_corrections[out - 1], sizeof(fix));
+    // Key events wait while output is queued, so the queue is normally idle
+    // here; if it is not, the typo stays
+    if (string_out_busy() || out_queue_room() < 2 * fix.backspaces) {
+        out_queue_drop();
+        return true;
+    }
+    for (uint8_t i = 0; i < fix.backspaces; i++) {
+        out_queue_tap(KC_BSPC, OUT_SRC_STRING);
+        out_queue_char(OUT_SRC_STRING);
+    }
+    ac_learn_reset();
+    if (fix.boundary_end) {
+        // The boundary key goes out behind the fix, with the user's Shift
+        // (queued reports carry only their own modifiers)
+        uint16_t kc = keycode;
+        if ((get_mods() | get_oneshot_mods()) & MOD_MASK_SHIFT) kc = LSFT(kc);
+        string_out_then(&ac_text[fix.text], kc);
+        ac_reset(ac_step(AC_ROOT, AC_SYM_BOUNDARY));
+    } else {
+        // The typo's last letter is replaced, not sent
+        string_out(&ac_text[fix.text]);
+        ac_reset(AC_ROOT);
+    }
+    return false;
+}
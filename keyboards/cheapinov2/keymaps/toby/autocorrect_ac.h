@@ -0,0 +1,27 @@
+// Aho-Corasick autocorrect for Cheapino keymap (toby)
+// Replaces QMK's autocorrect (backward trie walk over the typed buffer on
+// every key) with a flash-resident automaton generated from
+// autocorrect_dictionary.txt by autocorrect_gen.py. Each key advances one
+// state; failure links are bounded by AUTOCORRECT_MAX_LENGTH, so per-key cost
+// does not grow with the number of entries.
+//
+// Regenerate after editing the dictionary:
+//   python3 autocorrect_gen.py   (writes autocorrect_ac_data.h)
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// One dictionary entry's fix, applied when its typo is matched
+typedef struct {
+    uint8_t  backspaces;    // characters to erase
+    uint8_t  boundary_end;  // typo ends in ':' - let the boundary key through afterwards
+    uint16_t text;          // offset of the replacement in ac_text
+} ac_correction_t;
+
+// Start at a word boundary, so ':'-anchored typos match the first word
+// after boot. Call from keyboard_post_init_user().
+void autocorrect_ac_init(void);
+
+// Call early in process_record_user(). Returns false when the key was
+// consumed (correction applied or AC_TOGG/AC_ON/AC_OFF handled).
+bool process_autocorrect_ac(uint16_t keycode, keyrecord_t *record);
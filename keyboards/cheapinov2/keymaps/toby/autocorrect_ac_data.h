@@ -0,0 +1,98 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Generated by autocorrect_gen.py from autocorrect_dictionary.txt - do not edit.
+
+#pragma once
+
+// Autocorrection dictionary (13 entries):
+//   :teh:     -> the
+//   :adn:     -> and
+//   :recieve: -> receive
+//   :adress:  -> address
+//   :htis:    -> this
+//   :taht:    -> that
+//   :jsut:    -> just
+//   :hte:     -> the
+//   :widht:   -> width
+//   :fitler:  -> filter
+//   :lenght:  -> length
+//   :thier:   -> their
+//   :datt:    -> dann
+
+#define AC_STATE_COUNT 69
+#define AC_CORRECTION_COUNT 13
+#define AUTOCORRECT_MAX_LENGTH 9
+// Flash: 690 bytes of states, 101 bytes of corrections
+typedef uint16_t ac_state_t;
+#define ac_read_state(p) pgm_read_word(p)
+
+// Child bitmap per state: bit 0-25 = a-z, 26 = ', 27 = word boundary
+static const uint32_t ac_children[69] PROGMEM = {
+    0x8000000, 0x04A0AA9, 0x0000008, 0x0000001, 0x0000100, 0x0080000,
+    0x0040000, 0x0000010, 0x0000010, 0x0000091, 0x0000100, 0x0022000,
+    0x0080000, 0x0080000, 0x0000110, 0x0100000, 0x0002000, 0x0000004,
+    0x0000080, 0x0000080, 0x0000100, 0x0000008, 0x8000000, 0x0000010,
+    0x0080000, 0x0000800, 0x8000000, 0x0040000, 0x0080000, 0x0000040,
+    0x0000100, 0x0080000, 0x8000000, 0x0000010, 0x0000080, 0x0000000,
+    0x0040000, 0x8000000, 0x0000010, 0x0000000, 0x8000000, 0x8000000,
+    0x0000080, 0x0000010, 0x8000000, 0x0000000, 0x0020000, 0x0080000,
+    0x0040000, 0x0000000, 0x0020000, 0x0000000, 0x0000000, 0x0080000,
+    0x0200000, 0x0000000, 0x8000000, 0x8000000, 0x8000000, 0x8000000,
+    0x8000000, 0x0000010, 0x0000000, 0x0000000, 0x0000000, 0x0000000,
+    0x0000000, 0x8000000, 0x0000000,
+};
+
+// First child per state (children are contiguous, ordered by symbol)
+static const ac_state_t ac_first[69] PROGMEM = {
+    1, 2, 11, 12, 13, 14, 15, 16, 17, 18, 21, 22,
+    24, 25, 26, 28, 29, 30, 31, 32, 33, 34, 35, 36,
+    37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 0,
+    48, 49, 50, 0, 51, 52, 53, 54, 55, 0, 56, 57,
+    58, 0, 59, 0, 0, 60, 61, 0, 62, 63, 64, 65,
+    66, 67, 0, 0, 0, 0, 0, 68, 0,
+};
+
+// Failure link per state
+static const ac_state_t ac_fail[69] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 1, 0, 1, 1, 0, 0, 1, 0, 0, 0, 0,
+    0, 0, 1, 1, 1, 1, 1, 0, 1,
+};
+
+// Output per state: 0 = none, else 1 + correction index
+static const uint16_t ac_output[69] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2,
+    0, 0, 0, 8, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 13, 0, 5, 7, 0, 0, 6, 0, 0, 0, 0,
+    0, 0, 12, 9, 4, 10, 11, 0, 3,
+};
+
+// {backspaces, boundary_end, offset into ac_text}
+static const ac_correction_t ac_corrections[13] PROGMEM = {
+    {2, 1, 0},
+    {2, 1, 3},
+    {4, 1, 6},
+    {4, 1, 11},
+    {4, 1, 17},
+    {3, 1, 22},
+    {3, 1, 26},
+    {3, 1, 30},
+    {2, 1, 34},
+    {4, 1, 37},
+    {2, 1, 34},
+    {3, 1, 42},
+    {2, 1, 46},
+};
+
+static const char ac_text[49] PROGMEM = {
+    0x68, 0x65, 0x00, 0x6E, 0x64, 0x00, 0x65, 0x69, 0x76, 0x65, 0x00, 0x64, 0x72, 0x65, 0x73, 0x73,
+    0x00, 0x74, 0x68, 0x69, 0x73, 0x00, 0x68, 0x61, 0x74, 0x00, 0x75, 0x73, 0x74, 0x00, 0x74, 0x68,
+    0x65, 0x00, 0x74, 0x68, 0x00, 0x6C, 0x74, 0x65, 0x72, 0x00, 0x65, 0x69, 0x72, 0x00, 0x6E, 0x6E,
+    0x00,
+};
@@ -1,60 +0,0 @@
-// Copyright 2025 QMK
-// SPDX-License-Identifier: GPL-2.0-or-later
-
-/*******************************************************************************
-  88888888888 888      d8b                .d888 d8b 888               d8b
-      888     888      Y8P               d88P"  Y8P 888               Y8P
-      888     888                        888        888
-      888     88888b.  888 .d8888b       888888 888 888  .d88b.       888 .d8888b
-      888     888 "88b 888 88K           888    888 888 d8P  Y8b      888 88K
-      888     888  888 888 "Y8888b.      888    888 888 88888888      888 "Y8888b.
-      888     888  888 888      X88      888    888 888 Y8b.          888      X88
-      888     888  888 888  88888P'      888    888 888  "Y8888       888  88888P'
-                                                        888                 888
-                                                        888                 888
-                                                        888                 888
-     .d88b.   .d88b.  88888b.   .d88b.  888d888 8888b.  888888 .d88b.   .d88888
-    d88P"88b d8P  Y8b 888 "88b d8P  Y8b 888P"      "88b 888   d8P  Y8b d88" 888
-    888  888 88888888 888  888 88888888 888    .d888888 888   88888888 888  888
-    Y88b 888 Y8b.     888  888 Y8b.     888    888  888 Y88b. Y8b.     Y88b 888
-     "Y88888  "Y8888  888  888  "Y8888  888    "Y888888  "Y888 "Y8888   "Y88888
-         888
-    Y8b d88P
-     "Y88P"
-*******************************************************************************/
-
-#pragma once
-
-// Autocorrection dictionary (13 entries):
-//   :teh:     -> the
-//   :adn:     -> and
-//   :recieve: -> receive
-//   :adress:  -> address
-//   :htis:    -> this
-//   :taht:    -> that
-//   :jsut:    -> just
-//   :hte:     -> the
-//   :widht:   -> width
-//   :fitler:  -> filter
-//   :lenght:  -> length
-//   :thier:   -> their
-//   :datt:    -> dann
-
-#define AUTOCORRECT_MIN_LENGTH 5 // ":teh:"
-#define AUTOCORRECT_MAX_LENGTH 9 // ":recieve:"
-#define DICTIONARY_SIZE 186
-
-static const uint8_t autocorrect_data[DICTIONARY_SIZE] PROGMEM = {
-    0x2C, 0x00, 0x48, 0x15, 0x00, 0x0B, 0x31, 0x00, 0x11, 0x39, 0x00, 0x15, 0x41, 0x00, 0x16, 0x5E,
-    0x00, 0x17, 0x7C, 0x00, 0x00, 0x57, 0x1C, 0x00, 0x19, 0x24, 0x00, 0x00, 0x0B, 0x2C, 0x00, 0x83,
-    0x74, 0x68, 0x65, 0x00, 0x08, 0x0C, 0x06, 0x08, 0x15, 0x2C, 0x00, 0x84, 0x65, 0x69, 0x76, 0x65,
-    0x00, 0x08, 0x17, 0x2C, 0x00, 0x82, 0x68, 0x65, 0x00, 0x07, 0x04, 0x2C, 0x00, 0x82, 0x6E, 0x64,
-    0x00, 0x08, 0x00, 0x4C, 0x4A, 0x00, 0x0F, 0x53, 0x00, 0x00, 0x0B, 0x17, 0x2C, 0x00, 0x83, 0x65,
-    0x69, 0x72, 0x00, 0x17, 0x0C, 0x09, 0x2C, 0x00, 0x84, 0x6C, 0x74, 0x65, 0x72, 0x00, 0x4C, 0x65,
-    0x00, 0x16, 0x6F, 0x00, 0x00, 0x17, 0x0B, 0x2C, 0x00, 0x84, 0x74, 0x68, 0x69, 0x73, 0x00, 0x08,
-    0x15, 0x07, 0x04, 0x2C, 0x00, 0x84, 0x64, 0x72, 0x65, 0x73, 0x73, 0x00, 0x4B, 0x86, 0x00, 0x17,
-    0xA9, 0x00, 0x18, 0xB1, 0x00, 0x00, 0x44, 0x90, 0x00, 0x07, 0x98, 0x00, 0x0A, 0xA0, 0x00, 0x00,
-    0x17, 0x2C, 0x00, 0x83, 0x68, 0x61, 0x74, 0x00, 0x0C, 0x1A, 0x2C, 0x00, 0x82, 0x74, 0x68, 0x00,
-    0x11, 0x08, 0x0F, 0x2C, 0x00, 0x82, 0x74, 0x68, 0x00, 0x04, 0x07, 0x2C, 0x00, 0x82, 0x6E, 0x6E,
-    0x00, 0x16, 0x0D, 0x2C, 0x00, 0x83, 0x75, 0x73, 0x74, 0x00
-};
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+# Copyright 2024 Toby
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Compile autocorrect_dictionary.txt into an Aho-Corasick automaton.
+
+Usage (from this directory):
+  python3 autocorrect_gen.py [autocorrect_dictionary.txt] [autocorrect_ac_data.h]
+
+Dictionary format (same as QMK autocorrect): one `typo -> correction` per line,
+`#` comments. Typos use a-z and ', with `:` marking a word boundary at the start
+and/or end (e.g. `:teh:`).
+
+Encoding (read by autocorrect_ac.c): states are numbered breadth-first so the
+children of a state are contiguous. Each state stores a 28-bit child bitmap
+(a-z, ', boundary), the index of its first child, its failure link and its
+output (longest typo ending here). goto(s, c) = first[s] + popcount(bitmap[s]
+below c): one lookup, independent of dictionary size.
+"""
+
+import sys
+from collections import deque
+from pathlib import Path
+
+SYMBOLS = "abcdefghijklmnopqrstuvwxyz':"
+BOUNDARY = SYMBOLS.index(":")
+
+
+def parse(path):
+    entries = []
+    seen = {}
+    for lineno, raw in enumerate(Path(path).read_text(encoding="utf-8").splitlines(), 1):
+        line = raw.split("#", 1)[0].strip()
+        if not line:
+            continue
+        if "->" not in line:
+            sys.exit(f"{path}:{lineno}: expected 'typo -> correction'")
+        typo, correction = (part.strip() for part in line.split("->", 1))
+        typo = typo.lower()
+        bad = set(typo) - set(SYMBOLS)
+        if bad or not typo.strip(":"):
+            sys.exit(f"{path}:{lineno}: invalid typo {typo!r}")
+        if ":" in typo.strip(":"):
+            sys.exit(f"{path}:{lineno}: ':' only allowed at word start/end in {typo!r}")
+        if not correction or not correction.isascii():
+            sys.exit(f"{path}:{lineno}: correction must be non-empty ASCII")
+        if typo in seen:
+            sys.exit(f"{path}:{lineno}: duplicate typo {typo!r} (line {seen[typo]})")
+        seen[typo] = lineno
+        entries.append((typo, correction))
+    return entries
+
+
+def build(entries):
+    # Trie with nodes as {symbol: child}
+    children = [{}]
+    terminal = [None]
+    for idx, (typo, _) in enumerate(entries):
+        node = 0
+        for ch in typo:
+            sym = SYMBOLS.index(ch)
+            if sym not in children[node]:
+                children[node][sym] = len(children)
+                children.append({})
+                terminal.append(None)
+            node = children[node][sym]
+        terminal[node] = idx
+
+    # Breadth-first renumbering: children of each state become contiguous
+    order = [0]
+    queue = deque([0])
+    while queue:
+        node = queue.popleft()
+        for sym in sorted(children[node]):
+            order.append(children[node][sym])
+            queue.append(children[node][sym])
+    new_id = {old: new for new, old in enumerate(order)}
+    kids = [{sym: new_id[c] for sym, c in children[old].items()} for old in order]
+    term = [terminal[old] for old in order]
+
+    # Failure links and outputs (own typo, else longest suffix typo)
+    n = len(order)
+    fail = [0] * n
+    out = [None] * n
+    queue = deque()
+    for sym, c in kids[0].items():
+        queue.append(c)
+        out[c] = term[c]
+    while queue:
+        s = queue.popleft()
+        for sym, c in sorted(kids[s].items()):
+            f = fail[s]
+            while f and sym not in kids[f]:
+                f = fail[f]
+            fail[c] = kids[f][sym] if sym in kids[f] and kids[f][sym] != c else 0
+            out[c] = term[c] if term[c] is not None else out[fail[c]]
+            queue.append(c)
+    return kids, fail, out
+
+
+def check_conflicts(entries, kids, out):
+    # A typo that ends inside another one would fire before the longer one completes
+    for typo, _ in entries:
+        s = 0
+        for ch in typo[:-1]:
+            s = kids[s][SYMBOLS.index(ch)]
+            if out[s] is not None:
+                sys.exit(f"typo {entries[out[s]][0]!r} is contained in {typo!r}; remove one of them")
+
+
+def corrections(entries):
+    result = []
+    for typo, correction in entries:
+        boundary_end = typo.endswith(":")
+        letters = typo.strip(":")
+        i = 0
+        while i < min(len(letters), len(correction)) and letters[i] == correction[i]:
+            i += 1
+        if boundary_end:
+            # All letters were sent; the boundary key passes through afterwards
+            backspaces = len(letters) - i
+        else:
+            # The last letter is the key being processed and is swallowed
+            i = min(i, len(letters) - 1)
+            backspaces = len(letters) - 1 - i
+        result.append((backspaces, boundary_end, correction[i:]))
+    return result
+
+
+def c_array(ctype, name, values, per_line, fmt):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt.format(v) for v in values[i : i + per_line]) + ",")
+    return f"static const {ctype} {name}[{len(values)}] PROGMEM = {{\n" + "\n".join(lines) + "\n};\n"
+
+
+def main():
+    here = Path(__file__).resolve().parent
+    src = Path(sys.argv[1]) if len(sys.argv) > 1 else here / "autocorrect_dictionary.txt"
+    dst = Path(sys.argv[2]) if len(sys.argv) > 2 else here / "autocorrect_ac_data.h"
+
+    entries = parse(src)
+    if not entries:
+        sys.exit(f"{src}: no entries")
+    kids, fail, out = build(entries)
+    check_conflicts(entries, kids, out)
+    fixes = corrections(entries)
+
+    n = len(kids)
+    state_t = "uint16_t" if n <= 0xFFFF else "uint32_t"
+    bitmap = [sum(1 << sym for sym in k) for k in kids]
+    first = [min(k.values()) if k else 0 for k in kids]
+    output = [0 if o is None else o + 1 for o in out]
+
+    # Replacements share storage with any earlier one they are a tail of
+    text = bytearray()
+    tails = {}
+    fix_rows = []
+    for backspaces, boundary_end, s in fixes:
+        s = s.encode("ascii")
+        if s not in tails:
+            for i in range(len(s) + 1):
+                tails.setdefault(s[i:], len(text) + i)
+            text += s + b"\0"
+        if backspaces > 255 or tails[s] > 0xFFFF:
+            sys.exit("correction too long")
+        fix_rows.append(f"    {{{backspaces}, {int(boundary_end)}, {tails[s]}}},")
+
+    max_len = max(len(t) for t, _ in entries)
+    width = max(len(t) for t, _ in entries)
+    state_bytes = n * (4 + 2 * (2 if state_t == "uint16_t" else 4) + 2)
+
+    h = []
+    h.append("// Copyright 2024 Toby\n// SPDX-License-Identifier: GPL-2.0-or-later\n")
+    h.append("// Generated by autocorrect_gen.py from autocorrect_dictionary.txt - do not edit.\n")
+    h.append("#pragma once\n")
+    h.append(f"// Autocorrection dictionary ({len(entries)} entries):")
+    h.extend(f"//   {t:<{width}} -> {c}" for t, c in entries)
+    h.append("")
+    h.append(f"#define AC_STATE_COUNT {n}")
+    h.append(f"#define AC_CORRECTION_COUNT {len(entries)}")
+    h.append(f"#define AUTOCORRECT_MAX_LENGTH {max_len}")
+    h.append(f"// Flash: {state_bytes} bytes of states, {len(entries) * 4 + len(text)} bytes of corrections")
+    h.append(f"typedef {state_t} ac_state_t;")
+    h.append(f"#define ac_read_state(p) {'pgm_read_word' if state_t == 'uint16_t' else 'pgm_read_dword'}(p)\n")
+    h.append("// Child bitmap per state: bit 0-25 = a-z, 26 = ', 27 = word boundary")
+    h.append(c_array("uint32_t", "ac_children", bitmap, 6, "0x{:07X}"))
+    h.append("// First child per state (children are contiguous, ordered by symbol)")
+    h.append(c_array("ac_state_t", "ac_first", first, 12, "{}"))
+    h.append("// Failure link per state")
+    h.append(c_array("ac_state_t", "ac_fail", fail, 12, "{}"))
+    h.append("// Output per state: 0 = none, else 1 + correction index")
+    h.append(c_array("uint16_t", "ac_output", output, 12, "{}"))
+    h.append("// {backspaces, boundary_end, offset into ac_text}")
+    h.append(f"static const ac_correction_t ac_corrections[{len(entries)}] PROGMEM = {{")
+    h.extend(fix_rows)
+    h.append("};\n")
+    h.append(c_array("char", "ac_text", list(text), 16, "0x{:02X}"))
+    dst.write_text("\n".join(h), encoding="utf-8")
+    print(f"{dst.name}: {len(entries)} entries, {n} states, {state_bytes + len(entries) * 4 + len(text)} bytes")
+
+
+if __name__ == "__main__":
+    main()
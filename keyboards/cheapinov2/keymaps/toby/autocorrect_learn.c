@@ -0,0 +1,213 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Autocorrect learner: (typo -> correction) pairs from backspace corrections.
+
+#include QMK_KEYBOARD_H
+#include "autocorrect_learn.h"
+#include "cycle_prof.h"
+#include "user_eeprom.h"
+#include "ee_cache.h"
+#include "toby_hid.h"
+
+#define LEARN_MAGIC 0xA7
+
+// Persisted image in the EEPROM user datablock
+typedef struct {
+    uint8_t      magic;
+    uint8_t      word_max;  // LEARN_WORD_MAX when written; other layouts are dropped
+    uint8_t      count;
+    uint8_t      reserved;
+    learn_pair_t pairs[LEARN_SAVED];
+} learn_image_t;
+
+_Static_assert(sizeof(learn_image_t) <= EE_AC_LEARN_SIZE, "learned pairs exceed their EEPROM region");
+_Static_assert(EE_USER_DATA_END <= EECONFIG_USER_DATA_SIZE, "EECONFIG_USER_DATA_SIZE too small");
+
+static learn_pair_t learn_slots[LEARN_SLOTS];
+static learn_image_t learn_saved;  // what the flash holds, to skip identical writes
+static deferred_token learn_flush_token = INVALID_DEFERRED_TOKEN;
+
+// Word being typed; after a boundary it stays in last_word until the next key,
+// so a backspace right after the boundary reopens it as a whole-word typo
+static char    word[LEARN_WORD_MAX];
+static uint8_t word_len = 0;
+static bool    word_overflow = false;
+static char    last_word[LEARN_WORD_MAX];
+static uint8_t last_len = 0;
+
+// Snapshot taken at the first backspace of an edit, and how far it was erased
+static char    typo[LEARN_WORD_MAX];
+static uint8_t typo_len = 0;
+static uint8_t typo_kept = 0;
+static bool    typo_whole = false;
+
+static void learn_word_clear(void) {
+    word_len      = 0;
+    word_overflow = false;
+    typo_len      = 0;
+}
+
+// --- Table -------------------------------------------------------------------
+
+static void learn_flush_now(void) {
+    learn_image_t img;
+    memset(&img, 0, sizeof(img));
+    img.magic    = LEARN_MAGIC;
+    img.word_max = LEARN_WORD_MAX;
+
+    // Most frequent pairs that reached LEARN_SAVE_MIN (selection, table is tiny)
+    bool taken[LEARN_SLOTS] = {false};
+    while (img.count < LEARN_SAVED) {
+        int8_t best = -1;
+        for (uint8_t i = 0; i < LEARN_SLOTS; i++) {
+            if (taken[i] || learn_slots[i].count < LEARN_SAVE_MIN) continue;
+            if (best < 0 || learn_slots[i].count > learn_slots[best].count) best = (int8_t)i;
+        }
+        if (best < 0) break;
+        taken[best]            = true;
+        img.pairs[img.count++] = learn_slots[best];
+    }
+
+    if (memcmp(&img, &learn_saved, sizeof(img)) == 0) return;
+    learn_saved = img;
+    ee_cache_write(&learn_saved, EE_AC_LEARN_OFFSET, sizeof(learn_saved));
+}
+
+static uint32_t learn_flush_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    learn_flush_token = INVALID_DEFERRED_TOKEN;
+    learn_flush_now();
+    return 0;
+}
+
+// Batch writes: the first change arms one timer, later changes ride along
+static void learn_schedule_flush(void) {
+    if (learn_flush_token != INVALID_DEFERRED_TOKEN) return;
+    learn_flush_token = defer_exec(LEARN_FLUSH_MS, learn_flush_cb, NULL);
+}
+
+static void learn_record(const char *bad, const char *good, uint8_t flags) {
+    int8_t hit = -1, victim = 0;
+    for (uint8_t i = 0; i < LEARN_SLOTS; i++) {
+        learn_pair_t *p = &learn_slots[i];
+        if (p->count && memcmp(p->typo, bad, LEARN_WORD_MAX) == 0 && memcmp(p->fix, good, LEARN_WORD_MAX) == 0) {
+            hit = (int8_t)i;
+            break;
+        }
+        if (p->count < learn_slots[victim].count) victim = (int8_t)i;
+    }
+
+    learn_pair_t *p;
+    if (hit >= 0) {
+        p = &learn_slots[hit];
+        if (p->count == UINT8_MAX) {
+            // Age everything so new pairs can still climb
+            for (uint8_t i = 0; i < LEARN_SLOTS; i++) learn_slots[i].count >>= 1;
+        }
+        p->count++;
+        p->flags |= flags;
+    } else {
+        p = &learn_slots[victim];
+        memcpy(p->typo, bad, LEARN_WORD_MAX);
+        memcpy(p->fix, good, LEARN_WORD_MAX);
+        p->count = 1;
+        p->flags = flags;
+    }
+    if (p->count >= LEARN_SAVE_MIN) learn_schedule_flush();
+}
+
+void ac_learn_init(void) {
+    ee_cache_read(&learn_saved, EE_AC_LEARN_OFFSET, sizeof(learn_saved));
+    if (learn_saved.magic != LEARN_MAGIC || learn_saved.word_max != LEARN_WORD_MAX || learn_saved.count > LEARN_SAVED) {
+        memset(&learn_saved, 0, sizeof(learn_saved));
+        return;
+    }
+    memcpy(learn_slots, learn_saved.pairs, learn_saved.count * sizeof(learn_pair_t));
+}
+
+// --- Word tracking -----------------------------------------------------------
+
+void ac_learn_char(char c) {
+    last_len = 0;
+    if (word_len == LEARN_WORD_MAX) {
+        word_overflow = true;
+        return;
+    }
+    word[word_len++] = c;
+}
+
+void ac_learn_boundary(void) {
+    // Typed, erased and retyped differently: learn the pair. Erasing the whole
+    // word only counts as a fix if the retyped word starts the same way.
+    if (typo_len >= LEARN_WORD_MIN && !word_overflow && word_len > 0 && (typo_kept > 0 || word[0] == typo[0]) &&
+        (word_len != typo_len || memcmp(word, typo, word_len) != 0)) {
+        char bad[LEARN_WORD_MAX] = {0}, good[LEARN_WORD_MAX] = {0};
+        memcpy(bad, typo, typo_len);
+        memcpy(good, word, word_len);
+        learn_record(bad, good, typo_whole ? LEARN_WHOLE_WORD : 0);
+    }
+
+    if (word_overflow) {
+        last_len = 0;
+    } else {
+        memcpy(last_word, word, word_len);
+        last_len = word_len;
+    }
+    learn_word_clear();
+}
+
+void ac_learn_backspace(void) {
+    if (word_len == 0) {
+        // Backspace over the boundary: reopen the finished word as a whole-word typo
+        if (last_len == 0) {
+            learn_word_clear();
+            return;
+        }
+        memcpy(word, last_word, last_len);
+        word_len = last_len;
+        last_len = 0;
+        memcpy(typo, word, word_len);
+        typo_len   = word_len;
+        typo_kept  = word_len;
+        typo_whole = true;
+        return;
+    }
+    if (word_overflow) return;
+    if (typo_len == 0) {
+        memcpy(typo, word, word_len);
+        typo_len   = word_len;
+        typo_kept  = word_len;
+        typo_whole = false;
+    }
+    word_len--;
+    if (word_len < typo_kept) typo_kept = word_len;
+}
+
+void ac_learn_reset(void) {
+    last_len = 0;
+    learn_word_clear();
+}
+
+// --- Raw HID -----------------------------------------------------------------
+
+void ac_learn_hid(uint8_t *data, uint8_t length) {
+    uint8_t slot  = data[1];
+    bool    clear = data[2] == 1;
+    memset(&data[1], 0, length - 1);
+
+    if (clear) {
+        memset(learn_slots, 0, sizeof(learn_slots));
+        cancel_deferred_exec(learn_flush_token);
+        learn_flush_token = INVALID_DEFERRED_TOKEN;
+        learn_flush_now();
+    }
+    data[1] = slot;
+    data[2] = LEARN_SLOTS;
+    if (slot >= LEARN_SLOTS || 5 + 2 * LEARN_WORD_MAX > length) return;
+    const learn_pair_t *p = &learn_slots[slot];
+    data[3] = p->count;
+    data[4] = p->flags;
+    memcpy(&data[5], p->typo, LEARN_WORD_MAX);
+    memcpy(&data[5 + LEARN_WORD_MAX], p->fix, LEARN_WORD_MAX);
+}
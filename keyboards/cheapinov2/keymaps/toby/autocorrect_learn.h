@@ -0,0 +1,63 @@
+// Autocorrect learner for Cheapino keymap (toby)
+// Watches words that are typed, partly erased with backspace and retyped
+// differently, and counts the (typo -> correction) pairs in a small RAM table.
+// Pairs seen LEARN_SAVE_MIN times are written in batches (at most once per
+// LEARN_FLUSH_MS) to the EEPROM user datablock and can be exported over raw
+// HID (TOBY_HID_AC_LEARNED) to merge into autocorrect_dictionary.txt:
+//   tools/toby_hid.py learned [--merge autocorrect_dictionary.txt]
+// Fed by autocorrect_ac.c, which already resolves tap keycodes per key.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Longest word tracked (longer words are ignored)
+#ifndef LEARN_WORD_MAX
+#define LEARN_WORD_MAX 12
+#endif
+
+// Shortest typo worth learning
+#ifndef LEARN_WORD_MIN
+#define LEARN_WORD_MIN 3
+#endif
+
+// RAM table size (least seen pair is evicted when full)
+#ifndef LEARN_SLOTS
+#define LEARN_SLOTS 16
+#endif
+
+// Times a pair must be seen before it is persisted
+#ifndef LEARN_SAVE_MIN
+#define LEARN_SAVE_MIN 3
+#endif
+
+// Minimum time between flash writes (ms)
+#ifndef LEARN_FLUSH_MS
+#define LEARN_FLUSH_MS 600000
+#endif
+
+// Pairs kept in EEPROM (most frequent first); must fit EE_AC_LEARN_SIZE
+#define LEARN_SAVED 8
+
+// Pair flags
+#define LEARN_WHOLE_WORD 0x01  // typo was the complete word (fixed after its boundary key)
+
+typedef struct {
+    char    typo[LEARN_WORD_MAX];  // zero padded, not terminated when full
+    char    fix[LEARN_WORD_MAX];
+    uint8_t count;
+    uint8_t flags;
+} learn_pair_t;
+
+// Load persisted pairs. Call from keyboard_post_init_user().
+void ac_learn_init(void);
+
+// Typed events (a-z or '), word boundary, backspace, anything else.
+void ac_learn_char(char c);
+void ac_learn_boundary(void);
+void ac_learn_backspace(void);
+void ac_learn_reset(void);
+
+// TOBY_HID_AC_LEARNED. Request: data[1] = slot, data[2] = 1 to clear all pairs.
+// Reply: data[1] slot, data[2] LEARN_SLOTS, data[3] count, data[4] flags,
+// data[5..] typo, data[5 + LEARN_WORD_MAX..] correction.
+void ac_learn_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,62 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Boot-phase profiler: timestamps in retained RAM, readable over raw HID.
+
+#include QMK_KEYBOARD_H
+#include "boot_profile.h"
+#include "toby_hid.h"
+
+#define BOOT_LOG_MAGIC 0xB0071065u
+
+// ChibiOS places .ram0 after the cleared area (__ram0_noinit__), so it survives warm resets
+#define BOOT_PROF_RETAINED __attribute__((section(".ram0.boot_prof")))
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot_count;
+    uint32_t stamps[BOOT_PHASE_COUNT];
+} boot_log_t;
+
+// [0] = this boot, [1] = previous boot
+static boot_log_t boot_logs[2] BOOT_PROF_RETAINED;
+
+uint32_t boot_prof_us(void) {
+    return TIMER->TIMERAWL;
+}
+
+void boot_prof_begin(void) {
+    uint32_t count = 1;
+    if (boot_logs[0].magic == BOOT_LOG_MAGIC) {
+        boot_logs[1] = boot_logs[0];
+        count        = boot_logs[0].boot_count + 1;
+    } else {
+        memset(&boot_logs[1], 0, sizeof(boot_logs[1]));
+    }
+    memset(&boot_logs[0], 0, sizeof(boot_logs[0]));
+    boot_logs[0].magic      = BOOT_LOG_MAGIC;
+    boot_logs[0].boot_count = count;
+}
+
+void boot_prof_mark(boot_phase_t phase) {
+    if (boot_logs[0].stamps[phase] != 0) return;
+    uint32_t now = boot_prof_us();
+    boot_logs[0].stamps[phase] = now ? now : 1;
+}
+
+bool boot_prof_reached(boot_phase_t phase) {
+    return boot_logs[0].stamps[phase] != 0;
+}
+
+void boot_prof_hid_read(uint8_t *data, uint8_t length) {
+    uint8_t which = data[1] ? 1 : 0;
+    uint8_t first = data[2];
+    const boot_log_t *log = &boot_logs[which];
+
+    memset(&data[3], 0, length - 3);
+    data[3] = BOOT_PHASE_COUNT;
+    toby_hid_put_u32(&data[4], log->magic == BOOT_LOG_MAGIC ? log->boot_count : 0);
+    for (uint8_t i = 0, off = 8; first + i < BOOT_PHASE_COUNT && off + 4 <= length; i++, off += 4) {
+        toby_hid_put_u32(&data[off], log->stamps[first + i]);
+    }
+}
@@ -0,0 +1,35 @@
+// Boot-phase profiler for Cheapino keymap (toby)
+// Records µs-since-reset timestamps (RP2040 1 MHz timer) for each boot phase
+// into retained RAM; the previous boot's log survives a warm reset.
+// Read over raw HID (TOBY_HID_BOOT_LOG).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+typedef enum {
+    BOOT_PHASE_PRE_INIT,         // keyboard_pre_init_user: wear-leveling EEPROM mounted
+    BOOT_PHASE_POST_INIT_BEGIN,  // keyboard_post_init_user entry: keyboard_init (incl. rgblight_init) done
+    BOOT_PHASE_POST_INIT_END,    // keyboard_post_init_user exit
+    BOOT_PHASE_FIRST_SCAN,       // first matrix_scan_user
+    BOOT_PHASE_USB_CONFIGURED,   // host finished enumeration
+    BOOT_PHASE_DEFERRED_INIT,    // FAST_BOOT: deferred LED init done
+    BOOT_PHASE_OS_DETECTED,      // process_detected_host_os_user
+    BOOT_PHASE_FIRST_KEY,        // first key press reached process_record_user
+    BOOT_PHASE_COUNT
+} boot_phase_t;
+
+// Start this boot's log. Call first thing in keyboard_pre_init_user().
+void boot_prof_begin(void);
+
+// Record the first occurrence of a phase; later calls are a single compare.
+void boot_prof_mark(boot_phase_t phase);
+
+// Whether a phase has been recorded during this boot.
+bool boot_prof_reached(boot_phase_t phase);
+
+// µs since reset (RP2040 TIMERAWL).
+uint32_t boot_prof_us(void);
+
+// TOBY_HID_BOOT_LOG. Request: data[1] = log (0 this boot, 1 previous), data[2] = first phase.
+// Reply: data[3] = phase count, data[4..7] = boot count, data[8..] = up to 6 stamps (µs, 0 = not reached).
+void boot_prof_hid_read(uint8_t *data, uint8_t length);
@@ -0,0 +1,210 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Bitmask-indexed combo engine: candidates narrow with one AND per keypress.
+
+#include QMK_KEYBOARD_H
+#include "action_tapping.h"
+#include "combo_index.h"
+#include "combo_resolver.h"
+#include "cycle_prof.h"
+
+#define COMBO_WORDS ((COMBO_COUNT + 31) / 32)
+
+typedef struct {
+    uint32_t w[COMBO_WORDS];
+} combo_set_t;
+
+// Iterate the combo indices set in S (cost per set bit, not per combo)
+#define COMBO_SET_FOREACH(S, IDX)                                                  \
+    for (uint8_t _w = 0; _w < COMBO_WORDS; _w++)                                   \
+        for (uint32_t _b = (S).w[_w]; _b; _b &= _b - 1)                            \
+            for (uint16_t IDX = _w * 32 + __builtin_ctz(_b), _once = 1; _once; _once = 0)
+
+// Index (built once)
+static uint8_t     combo_slot_of[MATRIX_ROWS][MATRIX_COLS];  // 0 = no combo, else slot + 1
+static uint16_t    combo_slot_kc[COMBO_POS_SLOTS];           // keycode the slot was indexed with
+static combo_set_t combo_slot_set[COMBO_POS_SLOTS];          // combos the position takes part in
+static uint8_t     combo_len[COMBO_COUNT];
+
+// Current attempt: buffered presses and the combos they still match
+static keyrecord_t    combo_buf[COMBO_MAX_KEYS];
+static uint8_t        combo_buf_len = 0;
+static combo_set_t    combo_cand;
+static deferred_token combo_timer = 0;
+
+// Fired combos: their keys' releases are swallowed, the first one ends its
+// combo. Each position is held at most once, so the slots always suffice.
+typedef struct {
+    keypos_t pos;
+    uint16_t combo;
+} combo_held_t;
+
+static combo_held_t combo_held[COMBO_POS_SLOTS];
+static uint8_t      combo_held_len = 0;
+static combo_set_t  combo_active;
+
+static inline bool keypos_eq(keypos_t a, keypos_t b) {
+    return a.row == b.row && a.col == b.col;
+}
+
+// dst &= src; true if anything is left
+static inline bool combo_set_and(combo_set_t *dst, const combo_set_t *src) {
+    uint32_t any = 0;
+    for (uint8_t i = 0; i < COMBO_WORDS; i++) {
+        dst->w[i] &= src->w[i];
+        any |= dst->w[i];
+    }
+    return any != 0;
+}
+
+void combo_index_init(void) {
+    memset(combo_slot_of, 0, sizeof(combo_slot_of));
+    memset(combo_slot_set, 0, sizeof(combo_slot_set));
+    uint8_t slots = 0;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint16_t kc = keymap_key_to_keycode(0, (keypos_t){.row = row, .col = col});
+            if (kc == KC_NO || kc == KC_TRNS) continue;
+            for (uint16_t c = 0; c < COMBO_COUNT; c++) {
+                for (uint8_t k = 0; k < COMBO_MAX_KEYS && combo_defs[c].keys[k] != KC_NO; k++) {
+                    if (combo_defs[c].keys[k] != kc) continue;
+                    if (!combo_slot_of[row][col]) {
+                        if (slots >= COMBO_POS_SLOTS) return;
+                        combo_slot_kc[slots]    = kc;
+                        combo_slot_of[row][col] = ++slots;
+                    }
+                    combo_slot_set[combo_slot_of[row][col] - 1].w[c / 32] |= 1u << (c % 32);
+                }
+            }
+        }
+    }
+    for (uint16_t c = 0; c < COMBO_COUNT; c++) {
+        uint8_t n = 0;
+        while (n < COMBO_MAX_KEYS && combo_defs[c].keys[n] != KC_NO) n++;
+        combo_len[c] = n;
+    }
+}
+
+// Replay buffered presses in order; they then continue through tap-hold processing
+static void combo_flush(bool early) {
+    keyrecord_t replay[COMBO_MAX_KEYS];
+    uint8_t     n = combo_buf_len;
+    cancel_deferred_exec(combo_timer);
+    memcpy(replay, combo_buf, n * sizeof(keyrecord_t));
+    combo_buf_len = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        combo_resolver_flushed(timer_elapsed(replay[i].event.time), early);
+        action_tapping_process(replay[i]);
+    }
+}
+
+static void combo_fire(uint16_t idx) {
+    cancel_deferred_exec(combo_timer);
+    for (uint8_t i = 0; i < combo_buf_len && combo_held_len < COMBO_POS_SLOTS; i++) {
+        combo_held[combo_held_len++] = (combo_held_t){combo_buf[i].event.key, idx};
+    }
+    combo_buf_len = 0;
+    combo_active.w[idx / 32] |= 1u << (idx % 32);
+    combo_resolver_fired(idx);
+    process_combo_event(idx, true);
+}
+
+// Fire a fully pressed candidate unless a longer one is still possible (or final).
+// Returns true when the attempt ended.
+static bool combo_try_fire(bool final, bool early) {
+    int16_t complete = -1;
+    bool    longer   = false;
+    COMBO_SET_FOREACH(combo_cand, idx) {
+        if (combo_len[idx] == combo_buf_len) {
+            if (complete < 0) complete = (int16_t)idx;
+        } else {
+            longer = true;
+        }
+    }
+    if (complete >= 0 && (!longer || final)) {
+        combo_fire((uint16_t)complete);
+        return true;
+    }
+    if (final) {
+        combo_flush(early);
+        return true;
+    }
+    return false;
+}
+
+static uint32_t combo_timer_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)trigger_time;
+    (void)cb_arg;
+    if (combo_buf_len) {
+        combo_try_fire(true, false);
+    }
+    return 0;
+}
+
+static bool combo_buf_has(keypos_t pos) {
+    for (uint8_t i = 0; i < combo_buf_len; i++) {
+        if (keypos_eq(combo_buf[i].event.key, pos)) return true;
+    }
+    return false;
+}
+
+// Release of a fired combo's key: end its combo on the first one, swallow all
+static bool combo_held_release(keypos_t pos) {
+    for (uint8_t i = 0; i < combo_held_len; i++) {
+        if (!keypos_eq(combo_held[i].pos, pos)) continue;
+        uint16_t idx  = combo_held[i].combo;
+        combo_held[i] = combo_held[--combo_held_len];
+        if (combo_active.w[idx / 32] & (1u << (idx % 32))) {
+            combo_active.w[idx / 32] &= ~(1u << (idx % 32));
+            process_combo_event(idx, false);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool combo_index_process(uint16_t keycode, keyrecord_t *record) {
+    keypos_t pos = record->event.key;
+    if (pos.row >= MATRIX_ROWS || pos.col >= MATRIX_COLS) return true;
+
+    if (!record->event.pressed) {
+        if (combo_held_release(pos)) return false;
+        // Any other key going up resolves the attempt first, keeping event order:
+        // a buffered key released (key-up order) or a rolled key released (overlap)
+        if (combo_buf_len) {
+            combo_try_fire(true, true);
+        }
+        return true;
+    }
+
+    uint8_t            slot   = combo_slot_of[pos.row][pos.col];
+    const combo_set_t *keyset = (slot && combo_slot_kc[slot - 1] == keycode) ? &combo_slot_set[slot - 1] : NULL;
+
+    if (combo_buf_len) {
+        combo_set_t next = combo_cand;
+        if (keyset && combo_buf_len < COMBO_MAX_KEYS && !combo_buf_has(pos) && combo_set_and(&next, keyset)) {
+            combo_buf[combo_buf_len++] = *record;
+            combo_cand                 = next;
+            combo_try_fire(false, true);
+            return false;
+        }
+        // Not part of any remaining candidate: resolve what we have, then treat this press afresh
+        combo_try_fire(true, true);
+    }
+    if (!keyset) return true;
+
+    // Start a new attempt
+    combo_cand    = *keyset;
+    combo_buf[0]  = *record;
+    combo_buf_len = 1;
+    combo_resolver_attempt();
+    uint16_t term = 0;
+    COMBO_SET_FOREACH(combo_cand, idx) {
+        uint16_t t = combo_resolver_term(idx);
+        if (t > term) term = t;
+    }
+    combo_timer = defer_exec(term ? term : 1, combo_timer_cb, NULL);
+    return false;
+}
@@ -0,0 +1,36 @@
+// Combo engine for Cheapino keymap (toby)
+// Replaces QMK's combo processing (which walks every combo on every event)
+// with a per-position index: each key position maps to a bitset of the
+// combos it takes part in. A press ANDs that bitset into the candidate set,
+// so per-event work is a few word ANDs plus a walk over remaining candidates.
+//
+// Combos are declared by base-layer keycode in keymap.c (combo_defs[]);
+// positions are resolved once at init. Timing comes from combo_resolver.c.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+#ifndef COMBO_MAX_KEYS
+#define COMBO_MAX_KEYS 4
+#endif
+
+// Distinct key positions that may take part in combos (36 keys on the Cheapino)
+#ifndef COMBO_POS_SLOTS
+#define COMBO_POS_SLOTS 36
+#endif
+
+typedef struct {
+    uint16_t keys[COMBO_MAX_KEYS];  // base-layer keycodes, KC_NO-terminated
+} combo_def_t;
+
+// Provided by the keymap: COMBO_COUNT definitions and their action handler
+extern const combo_def_t combo_defs[COMBO_COUNT];
+void process_combo_event(uint16_t combo_index, bool pressed);
+
+// Build the position index from combo_defs and the base layer. Call once at init.
+void combo_index_init(void);
+
+// Call from pre_process_record_user(). Returns false when the event was
+// consumed (buffered, or part of a fired combo); buffered presses that do
+// not end in a combo are replayed in order.
+bool combo_index_process(uint16_t keycode, keyrecord_t *record);
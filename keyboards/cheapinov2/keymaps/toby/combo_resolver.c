@@ -0,0 +1,88 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Combo resolver: adaptive per-combo terms and early-release statistics.
+
+#include QMK_KEYBOARD_H
+#include "combo_resolver.h"
+#include "toby_hid.h"
+#include "tune.h"
+#include "typing_streak.h"
+
+// No press-gap sample yet: use the full combo term (tune.combo_term)
+#define COMBO_GAP_UNKNOWN 0xFFFF
+
+typedef struct {
+    uint32_t buffered;     // buffered combo-key presses replayed as normal keys
+    uint32_t early;        // ... of which replayed before their term expired
+    uint32_t latency_sum;  // ms added by buffering, summed
+    uint32_t latency_max;
+    uint32_t fired;        // combos triggered
+    uint32_t streak_terms; // attempts shortened because of a typing streak
+} combo_stats_t;
+
+static combo_stats_t combo_stats;
+static uint16_t combo_gap[COMBO_COUNT];   // EWMA (1/4) of the press gap per combo, ms (<= tune.combo_term)
+static bool     combo_gap_init = false;
+static uint16_t press_time_last = 0;      // latest press
+static uint16_t press_time_prev = 0;      // press before that
+static bool     press_in_streak = false;  // latest press continued a typing streak
+
+void combo_resolver_note_press(keyrecord_t *record) {
+    if (!record->event.pressed) return;
+    if (!combo_gap_init) {
+        for (uint8_t i = 0; i < COMBO_COUNT; i++) combo_gap[i] = COMBO_GAP_UNKNOWN;
+        combo_gap_init = true;
+    }
+    press_time_prev = press_time_last;
+    press_time_last = record->event.time;
+    // Sampled before typing_streak_process() counts this press
+    press_in_streak = typing_streak_active();
+}
+
+void combo_resolver_attempt(void) {
+    if (press_in_streak) combo_stats.streak_terms++;
+}
+
+uint16_t combo_resolver_term(uint16_t combo_index) {
+    if (press_in_streak) {
+        return COMBO_TERM_MIN;
+    }
+    if (combo_index >= COMBO_COUNT || combo_gap[combo_index] == COMBO_GAP_UNKNOWN) {
+        return tune.combo_term;
+    }
+    uint16_t term = combo_gap[combo_index] * 2 + COMBO_TERM_MARGIN;
+    if (term < COMBO_TERM_MIN) term = COMBO_TERM_MIN;
+    if (term > tune.combo_term) term = tune.combo_term;
+    return term;
+}
+
+void combo_resolver_fired(uint16_t combo_index) {
+    combo_stats.fired++;
+    if (combo_index >= COMBO_COUNT) return;
+    // Combos fire on their last key, so the two latest presses are its keys
+    uint16_t gap = TIMER_DIFF_16(press_time_last, press_time_prev);
+    if (gap > tune.combo_term) gap = tune.combo_term;
+    if (combo_gap[combo_index] == COMBO_GAP_UNKNOWN) {
+        combo_gap[combo_index] = gap;
+    } else {
+        combo_gap[combo_index] = (uint16_t)((combo_gap[combo_index] * 3u + gap) / 4u);
+    }
+}
+
+void combo_resolver_flushed(uint16_t added_ms, bool early) {
+    combo_stats.buffered++;
+    combo_stats.latency_sum += added_ms;
+    if (added_ms > combo_stats.latency_max) combo_stats.latency_max = added_ms;
+    if (early) combo_stats.early++;
+}
+
+void combo_resolver_hid_stats(uint8_t *data, uint8_t length) {
+    bool reset = data[1] == 1;
+    memset(&data[1], 0, length - 1);
+    const uint32_t *fields = (const uint32_t *)&combo_stats;
+    for (uint8_t i = 0; i < sizeof(combo_stats) / sizeof(uint32_t) && 4 + i * 4 + 4 <= length; i++) {
+        toby_hid_put_u32(&data[4 + i * 4], fields[i]);
+    }
+    if (reset) memset(&combo_stats, 0, sizeof(combo_stats));
+}
@@ -0,0 +1,39 @@
+// Combo resolver for Cheapino keymap (toby)
+// Shortens how long combo_index.c buffers combo keys (KC_X/C/V/Z) so normal
+// typing through them is not held back by the full COMBO_TERM:
+//  - per-combo adaptive term learned from the press gap of fired combos
+//  - minimal term while typing (typing_streak.c streak running at the press)
+//  - any release while buffering flushes at once (key-up order, rolling)
+// Stats on added latency are readable over raw HID (TOBY_HID_COMBO_STATS).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Floor for any combo term (ms); also the term used while typing
+#ifndef COMBO_TERM_MIN
+#define COMBO_TERM_MIN 15
+#endif
+
+// Added to twice the learned press gap
+#ifndef COMBO_TERM_MARGIN
+#define COMBO_TERM_MARGIN 10
+#endif
+
+// Every key event, before combo processing (pre_process_record_user).
+void combo_resolver_note_press(keyrecord_t *record);
+
+// A combo attempt started (combo_index.c, once per attempt).
+void combo_resolver_attempt(void);
+
+// Adaptive term for a combo attempt.
+uint16_t combo_resolver_term(uint16_t combo_index);
+
+// A combo fired: learn its press gap.
+void combo_resolver_fired(uint16_t combo_index);
+
+// A buffered press was replayed after added_ms; early = before its term expired.
+void combo_resolver_flushed(uint16_t added_ms, bool early);
+
+// TOBY_HID_COMBO_STATS. Request: data[1] = 1 to reset after reading.
+// Reply (u32 LE from data[4]): buffered, early, latency sum ms, latency max ms, fired, attempts shortened by a typing streak.
+void combo_resolver_hid_stats(uint8_t *data, uint8_t length);
@@ -10,52 +10,66 @@
 
 // Tapping configuration for dual-function keys
 #define TAPPING_TERM_PER_KEY
+#define KEY_BEHAVIOR_COUNT 14   // Entries in key_behavior_map.h (term, permissive hold, hold on other key, quick tap, HRM)
+#define TAP_ADAPT_KEY_COUNT 13  // Entries of key_behavior_map.h with an adaptive TERM; terms adapt below their ceiling
 #define QUICK_TAP_TERM_PER_KEY  // Enable per-key quick tap for auto-repeat
 
+// Typing streak: HRM/thumb taps skip tap-hold resolution while typing (typing_streak.c)
+#define TYPING_STREAK_MS 150      // Previous alpha press within this window keeps the streak
+// #define TYPING_STREAK_HUE 85   // Optional dim LED tint on base while a streak runs
+
+// Speculative HRM mods: Ctrl/Shift HRMs report their mod on press (mouse Ctrl-/Shift-click),
+// withdrawn if the key turns out to be a tap (hrm_speculate.c)
+#define HRM_SPECULATE
+#define HRM_SPEC_KEY_COUNT 4  // Entries in hrm_spec_keys[] (keymap.c)
+
 // Hold on other key press - allow faster layer access
 #define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
 
-// Combos
-#define COMBO_COUNT 3  // Leader combo removed (DEL is Leader directly)
-#define COMBO_TERM 100  // Time window for combo detection (ms) - increased for easier triggering
+// Combos (own indexed engine in combo_index.c; QMK COMBO_ENABLE is off)
+#define COMBO_COUNT 3  // Entries in combo_defs[] (keymap.c)
+#define COMBO_TERM 100  // Upper bound for combo detection (ms); combo_resolver.c adapts below it
 
 // Leader Key
-#define LEADER_TIMEOUT 1000  // More time to start; sequences auto-complete on 2nd key
+#define LEADER_TIMEOUT_MS 1000  // More time to start; sequences fire as soon as the prefix is unique (tune.leader_timeout)
+#define LEADER_TIMEOUT 6000     // QMK's own timeout: backstop above the tunable range
 #define LEADER_PER_KEY_TIMING  // Each key in sequence has own timeout
 
+// EEPROM user datablock (regions in user_eeprom.h, wear-leveled flash on RP2040;
+// must fit WEAR_LEVELING_LOGICAL_SIZE together with QMK's own eeconfig)
+#define EECONFIG_USER_DATA_SIZE 3280
+
 // OS Detection - Debug mode removed (caused EECONFIG_SIZE error on RP2040)
 // #define OS_DETECTION_DEBUG_ENABLE  // Disabled - doesn't work on RP2040
 
-// Mouse Keys - Kinetic (Inertia) Mode
-#undef MK_COMBINED
-#define MK_KINETIC_SPEED
+// Mouse Keys: motion, wheel and MS_ACL0/1/2 run in mouse_engine.c (fixed-point
+// kinetic at the USB poll rate); QMK mouse keys only handle the buttons.
+// Speeds/ramps/multipliers: MOUSE_ENGINE_* defaults in mouse_engine.h
 #define MOUSEKEY_DELAY 0
-#define MOUSEKEY_INTERVAL 16
-#define MOUSEKEY_MOVE_DELTA 10         // Slightly higher base motion for snappier start
-#define MOUSEKEY_MAX_SPEED 24         // Slightly lower top speed
-#define MOUSEKEY_TIME_TO_MAX 4        // Even faster ramp to max speed
-#define MOUSEKEY_FRICTION 4           // Inertia friction (higher = more damping)
-// Wheel: make it slow enough to read while holding
-#define MOUSEKEY_WHEEL_DELAY 0
-#define MOUSEKEY_WHEEL_INTERVAL 80   // Much slower scroll rate
-#define MOUSEKEY_WHEEL_MAX_SPEED 5    // Lower peak wheel speed
-#define MOUSEKEY_WHEEL_TIME_TO_MAX 120
-
-// Mouse speed multipliers (for ACL0/ACL1/ACL2 keys)
-// Note: ACL stages do not affect kinetic mode. Left here for reference only.
-#define MK_C_OFFSET_0 16
-#define MK_C_INTERVAL_0 12
-#define MK_C_OFFSET_1 4    // Medium (ACL1)
-#define MK_C_INTERVAL_1 16
-#define MK_C_OFFSET_2 16   // Fast (ACL2)
-#define MK_C_INTERVAL_2 8
+
+// Hi-res wheel: advertise the HID resolution multiplier (120 counts per detent)
+#define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
 
 // LED brightness
 #define LED_BRIGHTNESS 50
 #define LED_BRIGHTNESS_HOMEROW 50
 
-// Unicode: Linux IBus method (Ctrl+Shift+U)
-#define UNICODE_SELECTED_MODES UNICODE_MODE_LINUX
+// Umlaut input path per host (unicode_out.h; macOS always uses Option dead keys)
+// Linux: XKB Compose key (e.g. compose:menu); UNI_PATH_HEX = IBus Ctrl+Shift+U
+#ifndef LINUX_UNICODE_PATH
+#define LINUX_UNICODE_PATH UNI_PATH_COMPOSE
+#endif
+#ifndef LINUX_COMPOSE_KEY
+#define LINUX_COMPOSE_KEY KC_APP
+#endif
+// Windows: Alt + numpad code; UNI_PATH_COMPOSE if WinCompose is installed
+#ifndef WIN_UNICODE_PATH
+#define WIN_UNICODE_PATH UNI_PATH_ALTCODE
+#endif
+#ifndef WIN_COMPOSE_KEY
+#define WIN_COMPOSE_KEY KC_RALT
+#endif
 
 // Caps Word - enable via both shifts at keymap level
 #ifndef BOTH_SHIFTS_TURNS_ON_CAPS_WORD
@@ -64,8 +78,8 @@
 
 // Repeat Key is built-in, no config needed
 
-// RGB lighting: enable rgblight layers for non-blocking overlays
-#define RGBLIGHT_LAYERS
+// LEDs: priority-stack compositor writing the WS2812 directly (led_comp.c)
+#define LED_COMPOSITOR
 
 // App switcher configuration (Linux/Windows)
 #ifndef LINUX_APP_SWITCH_MOD
@@ -84,5 +98,16 @@
 #define APP_LEADER_KEY C(A(KC_F12))
 #endif
 
+// Fast boot: defer LED init and the OS flash until USB is configured, so the
+// first report goes out as early as possible (boot phases: tools/toby_hid.py boot)
+#define FAST_BOOT
+#ifndef FAST_BOOT_DEFER_MS
+#define FAST_BOOT_DEFER_MS 20  // after USB configured, before LED init
+#endif
+
+// Key event capture over raw HID for reproducing timing issues (event_trace.h).
+// Off by default: an armed capture records keystrokes.
+// #define EVENT_TRACE
+
 // BSPC timing is managed in keymap (triple-tap window)
 // Leader shortcuts are declared in leader_map.h (single source of truth)
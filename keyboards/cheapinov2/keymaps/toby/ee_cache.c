@@ -0,0 +1,112 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Write-behind cache in front of the EEPROM user datablock.
+
+#include QMK_KEYBOARD_H
+#include "eeconfig.h"
+#include "ee_cache.h"
+#include "cycle_prof.h"
+#include "user_eeprom.h"
+#include "boot_profile.h"
+#include "toby_hid.h"
+
+#define EE_CACHE_BLOCKS ((EECONFIG_USER_DATA_SIZE + EE_CACHE_BLOCK - 1) / EE_CACHE_BLOCK)
+
+static uint8_t        ee_mirror[EECONFIG_USER_DATA_SIZE];
+static uint32_t       ee_dirty[(EE_CACHE_BLOCKS + 31) / 32];
+static uint16_t       ee_dirty_count = 0;
+static deferred_token ee_token       = INVALID_DEFERRED_TOKEN;
+
+static struct {
+    uint32_t flushes;
+    uint32_t bytes;
+    uint32_t stall_max_us;
+    uint32_t stall_last_us;
+} ee_stats;
+
+static inline bool ee_block_dirty(uint16_t b) {
+    return ee_dirty[b / 32] & (1ul << (b % 32));
+}
+
+static void ee_block_mark(uint16_t b, bool dirty) {
+    if (ee_block_dirty(b) == dirty) return;
+    ee_dirty[b / 32] ^= 1ul << (b % 32);
+    if (dirty) {
+        ee_dirty_count++;
+    } else {
+        ee_dirty_count--;
+    }
+}
+
+// Write the first run of dirty blocks (at most EE_CACHE_RUN_BLOCKS)
+static void ee_cache_flush_step(void) {
+    uint16_t first = 0;
+    while (first < EE_CACHE_BLOCKS && !ee_block_dirty(first)) first++;
+    if (first == EE_CACHE_BLOCKS) return;
+    uint16_t end = first;
+    while (end < EE_CACHE_BLOCKS && end - first < EE_CACHE_RUN_BLOCKS && ee_block_dirty(end)) {
+        ee_block_mark(end, false);
+        end++;
+    }
+
+    uint16_t offset = first * EE_CACHE_BLOCK;
+    uint16_t length = MIN(end * EE_CACHE_BLOCK, EECONFIG_USER_DATA_SIZE) - offset;
+    uint32_t start  = boot_prof_us();
+    eeconfig_update_user_datablock(&ee_mirror[offset], offset, length);
+    uint32_t stall = boot_prof_us() - start;
+
+    ee_stats.flushes++;
+    ee_stats.bytes += length;
+    ee_stats.stall_last_us = stall;
+    if (stall > ee_stats.stall_max_us) ee_stats.stall_max_us = stall;
+}
+
+static uint32_t ee_cache_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    uint32_t idle = last_input_activity_elapsed();
+    if (idle < EE_CACHE_IDLE_MS) return EE_CACHE_IDLE_MS - idle;
+    ee_cache_flush_step();
+    if (ee_dirty_count) return 10;  // next run, after another scan pass
+    ee_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+void ee_cache_init(void) {
+    eeconfig_read_user_datablock(ee_mirror, 0, sizeof(ee_mirror));
+}
+
+void ee_cache_read(void *data, uint16_t offset, uint16_t length) {
+    if (offset >= sizeof(ee_mirror)) return;
+    memcpy(data, &ee_mirror[offset], MIN(length, sizeof(ee_mirror) - offset));
+}
+
+void ee_cache_write(const void *data, uint16_t offset, uint16_t length) {
+    if (offset >= sizeof(ee_mirror)) return;
+    length = MIN(length, sizeof(ee_mirror) - offset);
+
+    // Mark only blocks whose bytes actually change
+    const uint8_t *src = data;
+    for (uint16_t b = offset / EE_CACHE_BLOCK; b * EE_CACHE_BLOCK < offset + length; b++) {
+        uint16_t lo = MAX(offset, b * EE_CACHE_BLOCK);
+        uint16_t hi = MIN(offset + length, (b + 1) * EE_CACHE_BLOCK);
+        if (memcmp(&ee_mirror[lo], &src[lo - offset], hi - lo) == 0) continue;
+        memcpy(&ee_mirror[lo], &src[lo - offset], hi - lo);
+        ee_block_mark(b, true);
+    }
+    if (ee_dirty_count && ee_token == INVALID_DEFERRED_TOKEN) {
+        ee_token = defer_exec(EE_CACHE_IDLE_MS, ee_cache_cb, NULL);
+    }
+}
+
+void ee_cache_hid(uint8_t *data, uint8_t length) {
+    bool reset = data[1] == 1;
+    memset(&data[1], 0, length - 1);
+    toby_hid_put_u32(&data[4], ee_stats.flushes);
+    toby_hid_put_u32(&data[8], ee_stats.bytes);
+    toby_hid_put_u32(&data[12], ee_stats.stall_max_us);
+    toby_hid_put_u32(&data[16], ee_stats.stall_last_us);
+    toby_hid_put_u16(&data[20], ee_dirty_count);
+    toby_hid_put_u16(&data[22], sizeof(ee_mirror));
+    if (reset) memset(&ee_stats, 0, sizeof(ee_stats));
+}
@@ -0,0 +1,43 @@
+// Write-behind EEPROM cache for Cheapino keymap (toby)
+// RAM mirror of the EEPROM user datablock (user_eeprom.h). Modules read and
+// write the mirror; changed EE_CACHE_BLOCK-byte blocks are marked dirty and
+// written back only after EE_CACHE_IDLE_MS without input activity, one run of
+// blocks per callback, re-checking idleness in between. Repeated writes to
+// the same bytes merge in RAM; identical writes cost nothing.
+//
+// On the RP2040 a flash erase/program stalls execute-in-place for
+// milliseconds. The wear_leveling rp2040_flash driver already runs those
+// operations from SRAM with interrupts locked, and this build never starts
+// core1, so there is nothing further to park; what the cache adds is that
+// the stall only ever happens while nobody is typing.
+// Counters (flushes, bytes, longest stall) over raw HID: TOBY_HID_EE_CACHE.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Input idle time before dirty blocks are written (ms)
+#ifndef EE_CACHE_IDLE_MS
+#define EE_CACHE_IDLE_MS 3000
+#endif
+
+// Dirty tracking granularity (bytes)
+#define EE_CACHE_BLOCK 32
+
+// Blocks written per flush step (bounds one stall)
+#ifndef EE_CACHE_RUN_BLOCKS
+#define EE_CACHE_RUN_BLOCKS 2
+#endif
+
+// Load the mirror. Call first in keyboard_post_init_user().
+void ee_cache_init(void);
+
+// Copy from the mirror (user datablock offset).
+void ee_cache_read(void *data, uint16_t offset, uint16_t length);
+
+// Update the mirror; changed blocks are written back when idle.
+void ee_cache_write(const void *data, uint16_t offset, uint16_t length);
+
+// TOBY_HID_EE_CACHE. Request: data[1] = 1 to reset counters after reading.
+// Reply: u32 LE flush steps [4], bytes written [8], longest stall µs [12],
+// last stall µs [16]; u16 LE dirty blocks [20], mirror size [22].
+void ee_cache_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,59 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Opt-in key event trace: armed over raw HID, linear RAM buffer, read in chunks.
+
+#include QMK_KEYBOARD_H
+#include "event_trace.h"
+#include "toby_hid.h"
+
+#ifdef EVENT_TRACE
+
+typedef struct {
+    uint16_t time;
+    uint8_t  row;
+    uint8_t  col;  // bit 7: pressed
+} trace_event_t;
+
+static trace_event_t trace_buf[EVENT_TRACE_LEN];
+static uint16_t      trace_len   = 0;
+static bool          trace_armed = false;
+
+void event_trace_key(const keyrecord_t *record) {
+    if (!trace_armed) return;
+    if (trace_len >= EVENT_TRACE_LEN) {
+        trace_armed = false;
+        return;
+    }
+    trace_buf[trace_len++] = (trace_event_t){
+        .time = record->event.time,
+        .row  = record->event.key.row,
+        .col  = record->event.key.col | (record->event.pressed ? 0x80 : 0),
+    };
+}
+
+void event_trace_hid(uint8_t *data, uint8_t length) {
+    uint8_t  op    = data[1];
+    uint16_t first = toby_hid_get_u16(&data[3]);
+    memset(&data[2], 0, length - 2);
+    if (op == 1) {
+        trace_len   = 0;
+        trace_armed = true;
+    } else if (op == 2) {
+        trace_armed = false;
+    }
+    data[2] = trace_armed;
+    toby_hid_put_u16(&data[3], trace_len);
+    toby_hid_put_u16(&data[5], EVENT_TRACE_LEN);
+    if (op != 3) return;
+    uint8_t n = 0;
+    for (uint16_t i = first; i < trace_len && 8 + n * 4 + 4 <= length; i++, n++) {
+        uint8_t *p = &data[8 + n * 4];
+        toby_hid_put_u16(p, trace_buf[i].time);
+        p[2] = trace_buf[i].row;
+        p[3] = trace_buf[i].col;
+    }
+    data[7] = n;
+}
+
+#endif
@@ -0,0 +1,26 @@
+// Key event trace capture for Cheapino keymap (toby)
+// Opt-in (#define EVENT_TRACE in config.h): once armed over raw HID, every
+// physical key event is appended to a RAM buffer as it enters
+// pre_process_record_user(), before combos, typing-streak rewrites and
+// tap-hold resolution; capture stops when the buffer is full. Nothing is
+// recorded unless armed, and nothing is persisted.
+// tools/toby_hid.py trace --arm / --save FILE exports timestamped traces of
+// real typing (one JSON event per line) for reproducing timing issues in the
+// BSPC, DEL_FKY, HRM, app-switcher and combo state machines.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Events kept per capture
+#ifndef EVENT_TRACE_LEN
+#define EVENT_TRACE_LEN 512
+#endif
+
+// Every physical key event (pre_process_record_user(), first).
+void event_trace_key(const keyrecord_t *record);
+
+// TOBY_HID_EVENT_TRACE. Request: data[1] op (0 = status, 1 = arm (clears),
+// 2 = stop, 3 = read), u16 LE first event [3] for read.
+// Reply: [1] op, [2] armed, u16 LE count [3], capacity [5], [7] events in
+// this reply, events from [8]: u16 LE time ms, row, col | 0x80 if pressed.
+void event_trace_hid(uint8_t *data, uint8_t length);
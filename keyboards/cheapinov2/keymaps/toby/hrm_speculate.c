@@ -0,0 +1,96 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Speculative HRM modifiers: report on press, withdraw if the key was a tap.
+
+#include QMK_KEYBOARD_H
+#include "hrm_speculate.h"
+#include "combo_index.h"
+#include "toby_hid.h"
+
+// Modifier bits each allowlisted key added to the report (0 = not speculating)
+static uint8_t spec_mods[HRM_SPEC_KEY_COUNT];
+static uint8_t spec_mods_all = 0;  // OR of spec_mods[]
+static uint8_t spec_off      = 0;  // allowlisted keys never speculated (combo keys), bit per key
+
+_Static_assert(HRM_SPEC_KEY_COUNT <= 8, "spec_off too narrow");
+
+static struct {
+    uint32_t speculated;
+    uint32_t withdrawn;
+    uint32_t kept;
+    uint16_t withdrawn_key[HRM_SPEC_KEY_COUNT];
+} spec_stats;
+
+static int8_t spec_index(uint16_t keycode) {
+    for (uint8_t i = 0; i < HRM_SPEC_KEY_COUNT; i++) {
+        if (hrm_spec_keys[i] == keycode) return (int8_t)i;
+    }
+    return -1;
+}
+
+// 5-bit mod-tap mods to 8-bit report bits
+static uint8_t spec_mod_bits(uint16_t keycode) {
+    uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+    return (mods & 0x10) ? (uint8_t)((mods & 0x0F) << 4) : (uint8_t)(mods & 0x0F);
+}
+
+void hrm_speculate_init(void) {
+    // A combo key's press can end in a combo and never reach
+    // hrm_speculate_resolve(), which would leave its modifier stuck
+    for (uint8_t i = 0; i < HRM_SPEC_KEY_COUNT; i++) {
+        for (uint16_t c = 0; c < COMBO_COUNT; c++) {
+            for (uint8_t k = 0; k < COMBO_MAX_KEYS && combo_defs[c].keys[k] != KC_NO; k++) {
+                if (combo_defs[c].keys[k] == hrm_spec_keys[i]) spec_off |= 1u << i;
+            }
+        }
+    }
+}
+
+void hrm_speculate_press(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed || record->keycode || !IS_QK_MOD_TAP(keycode)) return;
+    int8_t i = spec_index(keycode);
+    if (i < 0 || spec_mods[i] || (spec_off & (1u << i))) return;
+
+    // Only bits not already held, so withdrawing never drops a real modifier
+    uint8_t bits = spec_mod_bits(keycode) & ~get_mods();
+    if (!bits) return;
+    spec_mods[i] = bits;
+    spec_mods_all |= bits;
+    register_mods(bits);
+    spec_stats.speculated++;
+}
+
+void hrm_speculate_resolve(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed || !IS_QK_MOD_TAP(keycode)) return;
+    int8_t i = spec_index(keycode);
+    if (i < 0 || !spec_mods[i]) return;
+
+    if (record->tap.count) {
+        // Tap: take the modifier back before the tap keycode goes out
+        unregister_mods(spec_mods[i]);
+        spec_stats.withdrawn++;
+        spec_stats.withdrawn_key[i]++;
+    } else {
+        // Hold: QMK registers the same bits and clears them on release
+        spec_stats.kept++;
+    }
+    spec_mods_all &= (uint8_t)~spec_mods[i];
+    spec_mods[i] = 0;
+}
+
+uint8_t hrm_speculate_mods(void) {
+    return spec_mods_all;
+}
+
+void hrm_speculate_hid(uint8_t *data, uint8_t length) {
+    bool reset = data[1] == 1;
+    memset(&data[1], 0, length - 1);
+    toby_hid_put_u32(&data[4], spec_stats.speculated);
+    toby_hid_put_u32(&data[8], spec_stats.withdrawn);
+    toby_hid_put_u32(&data[12], spec_stats.kept);
+    for (uint8_t i = 0; i < HRM_SPEC_KEY_COUNT && 16 + i * 2 + 2 <= length; i++) {
+        toby_hid_put_u16(&data[16 + i * 2], spec_stats.withdrawn_key[i]);
+    }
+    if (reset) memset(&spec_stats, 0, sizeof(spec_stats));
+}
@@ -0,0 +1,38 @@
+// Speculative home-row modifiers for Cheapino keymap (toby)
+// An allowlisted HRM reports its modifier to the host on press instead of
+// after TAPPING_TERM, so modifier + click on a physical mouse (Ctrl-click,
+// Shift-click) is not ~230 ms late. If the key resolves as a tap, the
+// modifier is withdrawn in process_record_user() before the tap keycode is
+// sent; a hold simply keeps it. Withdrawals are counted per key and readable
+// over raw HID (TOBY_HID_SPEC_STATS, tools/toby_hid.py spec).
+//
+// Allowlist only modifiers whose lone press/release is harmless on the host:
+// a bare Alt or GUI tap opens menus / the start menu on several systems.
+// Combo keys are never speculated: hrm_speculate_init() takes allowlisted
+// keys that appear in combo_defs[] off the list.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Allowlisted HRM keycodes, defined in keymap.c (HRM_SPEC_KEY_COUNT entries)
+extern const uint16_t hrm_spec_keys[HRM_SPEC_KEY_COUNT];
+
+// Check the allowlist against combo_defs[]. Call from keyboard_post_init_user().
+void hrm_speculate_init(void);
+
+// Call from pre_process_record_user() for presses that still go through
+// tap-hold resolution (record->keycode not rewritten), after the combo engine
+// has passed them on.
+void hrm_speculate_press(uint16_t keycode, keyrecord_t *record);
+
+// Call at the very top of process_record_user(): settles the speculation
+// once QMK has decided tap or hold.
+void hrm_speculate_resolve(uint16_t keycode, keyrecord_t *record);
+
+// Modifier bits currently reported on speculation (keys not yet resolved).
+uint8_t hrm_speculate_mods(void);
+
+// TOBY_HID_SPEC_STATS. Request: data[1] = 1 to reset after reading.
+// Reply: u32 LE speculated [4], withdrawn (tap) [8], kept (hold) [12];
+// u16 LE withdrawn per allowlisted key from [16].
+void hrm_speculate_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,118 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Table-driven hybrid keys: one transition load per event, one deferred callback for all timers.
+
+#include QMK_KEYBOARD_H
+#include "hybrid_key.h"
+#include "cycle_prof.h"
+
+static uint8_t        hk_state[HK_KEY_COUNT];
+static uint16_t       hk_last_press[HK_KEY_COUNT];
+static uint32_t       hk_deadline[HK_KEY_COUNT];
+static uint8_t        hk_timed = 0;      // bit per key with a running state timer
+static bool           hk_rearm = false;  // a timer started or stopped since the last schedule
+static deferred_token hk_token = INVALID_DEFERRED_TOKEN;
+
+_Static_assert(HK_KEY_COUNT <= 8, "hk_timed too narrow");
+
+// Apply EV to key K at time NOW; returns the actions run
+static uint8_t hk_step(uint8_t k, hk_event_t ev, uint32_t now) {
+    hk_trans_t t       = hybrid_key_table[hk_state[k]][ev];
+    uint8_t    actions = hybrid_key_defs[k].actions;
+    if (t.actions & HK_DEFINED) {
+        actions = t.actions;
+        if (t.next != hk_state[k] || ev == HK_EV_TIMEOUT) {
+            hk_state[k]           = t.next;
+            const uint16_t *timer = hybrid_key_timers[t.next];
+            hk_rearm |= timer || (hk_timed & (1u << k));
+            hk_timed &= (uint8_t)~(1u << k);
+            if (timer) {
+                hk_deadline[k] = now + *timer;
+                hk_timed |= (uint8_t)(1u << k);
+            }
+        }
+    }
+    if (actions & ~(HK_PASS | HK_DEFINED)) {
+        hybrid_key_defs[k].handler(actions);
+    }
+    return actions;
+}
+
+// Delay (ms, at least 1) from NOW to the earliest running timer; 0 = none
+static uint32_t hk_next_delay(uint32_t now) {
+    int32_t next = INT32_MAX;
+    for (uint8_t k = 0; k < HK_KEY_COUNT; k++) {
+        if (!(hk_timed & (1u << k))) continue;
+        int32_t left = (int32_t)(hk_deadline[k] - now);
+        if (left < next) next = left;
+    }
+    if (next == INT32_MAX) return 0;
+    return next > 0 ? (uint32_t)next : 1;
+}
+
+// TIMEOUT for every key whose timer is due at NOW
+static void hk_run_due(uint32_t now) {
+    for (uint8_t k = 0; k < HK_KEY_COUNT; k++) {
+        if (!(hk_timed & (1u << k)) || (int32_t)(hk_deadline[k] - now) > 0) continue;
+        hk_timed &= (uint8_t)~(1u << k);
+        // Restarted timers count from the deadline, so repeats do not drift
+        hk_step(k, HK_EV_TIMEOUT, hk_deadline[k]);
+    }
+}
+
+static uint32_t hk_timer_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)cb_arg;
+    hk_run_due(timer_read32());
+    // Re-armed from trigger_time by the scheduler (the token stays ours)
+    hk_rearm       = false;
+    uint32_t delay = hk_next_delay(trigger_time);
+    if (!delay) hk_token = INVALID_DEFERRED_TOKEN;
+    return delay;
+}
+
+// Re-arm the shared callback after a key event started or stopped a timer
+static void hk_schedule(void) {
+    if (!hk_rearm) return;
+    cancel_deferred_exec(hk_token);
+    hk_token = INVALID_DEFERRED_TOKEN;
+    // A timer due this ms would otherwise slip to the next one (defer_exec
+    // takes no zero delay); the deferred task has not run yet this pass
+    uint32_t now = timer_read32();
+    hk_run_due(now);
+    hk_rearm       = false;
+    uint32_t delay = hk_next_delay(now);
+    if (delay) hk_token = defer_exec(delay, hk_timer_cb, NULL);
+}
+
+void hybrid_key_init(void) {
+    for (uint8_t k = 0; k < HK_KEY_COUNT; k++) {
+        hk_state[k] = hybrid_key_defs[k].idle;
+    }
+}
+
+bool hybrid_key_process(uint8_t key, keyrecord_t *record) {
+    if (key >= HK_KEY_COUNT) return true;
+    hk_event_t ev = HK_EV_RELEASE;
+    if (record->event.pressed) {
+        const uint16_t *window = hybrid_key_defs[key].window;
+        ev                     = (window && timer_elapsed(hk_last_press[key]) < *window) ? HK_EV_REPRESS : HK_EV_PRESS;
+        hk_last_press[key]     = timer_read();
+    }
+    uint8_t actions = hk_step(key, ev, timer_read32());
+    hk_schedule();
+    return actions & HK_PASS;
+}
+
+void hybrid_key_other(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return;
+    for (uint8_t k = 0; k < HK_KEY_COUNT; k++) {
+        if (hybrid_key_defs[k].keycode != keycode) hk_step(k, HK_EV_OTHER, timer_read32());
+    }
+    hk_schedule();
+}
+
+uint8_t hybrid_key_state(uint8_t key) {
+    return hk_state[key];
+}
@@ -0,0 +1,80 @@
+// Hybrid keys (multi-tap / hold) for Cheapino keymap (toby)
+// Keys with tap-count and hold behavior beyond QMK's tap-hold are declared in
+// hybrid_key_map.h as states and transitions. keymap.c expands the map into
+// one flat transition table indexed by state and event. An event is one table
+// load plus the key's handler for the action bits, and all state timers
+// share a single deferred callback armed for the earliest deadline.
+
+#pragma once
+#include QMK_KEYBOARD_H
+#include "hybrid_key_map.h"
+
+typedef enum {
+    HK_EV_PRESS,    // press (no window, or outside it)
+    HK_EV_REPRESS,  // press within the key's window of its previous press
+    HK_EV_RELEASE,
+    HK_EV_OTHER,    // another key pressed
+    HK_EV_TIMEOUT,  // the state's timer expired
+    HK_EV_COUNT,
+} hk_event_t;
+
+// ACTIONS column of hybrid_key_map.h
+#define HK_PASS    0x01  // let QMK process the press/release
+#define HK_TAP     0x02
+#define HK_HOLD    0x04
+#define HK_UNHOLD  0x08
+#define HK_SHOW    0x10  // feedback changed (e.g. LED)
+#define HK_DEFINED 0x80  // set for listed transitions
+
+// Key ids (HK_<KEY>) and state ids (HK_<KEY>_<STATE>), in map order
+enum {
+#define HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER) HK_##KEY,
+#define HK_STATE(KEY, STATE, TIMER)
+#define HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS)
+    HYBRID_KEY_MAP
+#undef HK_KEY
+#undef HK_STATE
+#undef HK_ON
+    HK_KEY_COUNT
+};
+
+enum {
+#define HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER)
+#define HK_STATE(KEY, STATE, TIMER) HK_##KEY##_##STATE,
+#define HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS)
+    HYBRID_KEY_MAP
+#undef HK_KEY
+#undef HK_STATE
+#undef HK_ON
+    HK_STATE_COUNT
+};
+
+typedef struct {
+    uint16_t        keycode;
+    const uint16_t *window;   // REPRESS window (ms), NULL = none
+    uint8_t         actions;  // for unlisted transitions
+    uint8_t         idle;     // initial state
+    void (*handler)(uint8_t actions);
+} hk_key_def_t;
+
+typedef struct {
+    uint8_t next;
+    uint8_t actions;  // HK_DEFINED | HK_*
+} hk_trans_t;
+
+// Expanded from hybrid_key_map.h in keymap.c
+extern const hk_key_def_t    hybrid_key_defs[HK_KEY_COUNT];
+extern const hk_trans_t      hybrid_key_table[HK_STATE_COUNT][HK_EV_COUNT];
+extern const uint16_t *const hybrid_key_timers[HK_STATE_COUNT];
+
+// Every key to its IDLE state. Call from keyboard_post_init_user().
+void hybrid_key_init(void);
+
+// Press/release of hybrid key KEY (HK_<KEY>). False = consumed.
+bool hybrid_key_process(uint8_t key, keyrecord_t *record);
+
+// Any press: OTHER for every hybrid key except the one with KEYCODE.
+void hybrid_key_other(uint16_t keycode, keyrecord_t *record);
+
+// Current state (HK_<KEY>_<STATE>) of KEY.
+uint8_t hybrid_key_state(uint8_t key);
@@ -0,0 +1,44 @@
+// Declarative hybrid keys (multi-tap / hold) for Cheapino (toby)
+// Each key is a small state machine; expanded into a transition table in keymap.c, run by hybrid_key.c
+// Syntax:
+//   HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER)  // WINDOW: tune field, a press this soon after the previous one is REPRESS (0 = none)
+//   HK_STATE(KEY, STATE, TIMER)                     // TIMER: tune field, started on entering the state; expiry is TIMEOUT (0 = none)
+//   HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS)         // EVENT: PRESS, REPRESS, RELEASE, OTHER (another key pressed), TIMEOUT
+// ACTIONS: HK_PASS (QMK processes the press/release as usual) plus HK_TAP, HK_HOLD, HK_UNHOLD, HK_SHOW (bits passed
+// to the key's HANDLER), or 0 (consume). Unlisted transitions stay put with the key's DEFAULT actions.
+// Every key starts in its IDLE state; a TIMEOUT transition back to the same state restarts its timer.
+
+#pragma once
+
+#define HYBRID_KEY_MAP \
+/* BSP_NUM: LT(_NUM, KC_BSPC) taps and holds as usual; the third press within bspc_triple_term of the */ \
+/* previous one waits: released = one BSPC, held past bspc_triple_hold = BSPC repeat until release */ \
+HK_KEY(BSPC, BSP_NUM, &tune.bspc_triple_term, HK_PASS, bspc_hybrid) \
+HK_STATE(BSPC, IDLE,   0) \
+HK_STATE(BSPC, ONE,    0) \
+HK_STATE(BSPC, TWO,    0) \
+HK_STATE(BSPC, TRIPLE, &tune.bspc_triple_hold) \
+HK_STATE(BSPC, REPEAT, &tune.bspc_repeat_ms) \
+HK_ON(BSPC, IDLE,   PRESS,   ONE,    HK_PASS) \
+HK_ON(BSPC, IDLE,   REPRESS, ONE,    HK_PASS) \
+HK_ON(BSPC, ONE,    PRESS,   ONE,    HK_PASS) \
+HK_ON(BSPC, ONE,    REPRESS, TWO,    HK_PASS) \
+HK_ON(BSPC, TWO,    PRESS,   ONE,    HK_PASS) \
+HK_ON(BSPC, TWO,    REPRESS, TRIPLE, 0) \
+HK_ON(BSPC, TRIPLE, RELEASE, IDLE,   HK_TAP) \
+HK_ON(BSPC, TRIPLE, TIMEOUT, REPEAT, 0) \
+HK_ON(BSPC, REPEAT, TIMEOUT, REPEAT, HK_TAP) \
+HK_ON(BSPC, REPEAT, RELEASE, IDLE,   0) \
+/* Another key stops the repeat; a quick press after it still counts as the third */ \
+HK_ON(BSPC, REPEAT, OTHER,   TWO,    0) \
+/* DEL_FKY: tap = QMK Leader (DEL,DEL = app leader via leader_map.h), hold = CMD layer. */ \
+/* Another key or del_hold_visual makes it a hold (CMD color), so its release no longer starts Leader */ \
+HK_KEY(DEL, DEL_FKY, 0, 0, del_hybrid) \
+HK_STATE(DEL, IDLE, 0) \
+HK_STATE(DEL, DOWN, &tune.del_hold_visual) \
+HK_STATE(DEL, HELD, 0) \
+HK_ON(DEL, IDLE, PRESS,   DOWN, HK_HOLD) \
+HK_ON(DEL, DOWN, RELEASE, IDLE, HK_UNHOLD | HK_TAP) \
+HK_ON(DEL, DOWN, OTHER,   HELD, HK_SHOW) \
+HK_ON(DEL, DOWN, TIMEOUT, HELD, HK_SHOW) \
+HK_ON(DEL, HELD, RELEASE, IDLE, HK_UNHOLD)
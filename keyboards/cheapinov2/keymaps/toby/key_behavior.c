@@ -0,0 +1,106 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-key tap-hold behavior flattened per key position: one keycode check and one load per query.
+
+#include QMK_KEYBOARD_H
+#include "keymap_introspection.h"
+#include "key_behavior.h"
+#include "tap_adapt.h"
+
+// One key's behavior, packed (6 bytes)
+typedef struct {
+    uint16_t keycode;    // key the slot was built for; other keycodes search the declarations
+    uint8_t  flags;      // KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER
+    uint8_t  quick_tap;  // ms
+    int8_t   adapt;      // tap_adapt_keys[] index, -1 = tune.tapping_term
+    int8_t   hrm;        // HRM overlay index, KB_NO_HRM
+} kb_slot_t;
+
+static kb_slot_t kb_slots[MATRIX_ROWS][MATRIX_COLS];
+static bool      kb_ready = false;  // false: every query searches the declarations
+
+static int8_t kb_def_index(uint16_t keycode) {
+    for (uint8_t i = 0; i < KEY_BEHAVIOR_COUNT; i++) {
+        if (key_behavior_defs[i].keycode == keycode) return (int8_t)i;
+    }
+    return -1;
+}
+
+// Reference: the key's declaration, or the defaults for undeclared keys
+static kb_slot_t kb_make(uint16_t keycode) {
+    kb_slot_t s = {keycode, 0, 0, tap_adapt_index(keycode), KB_NO_HRM};
+    int8_t    i = kb_def_index(keycode);
+    if (i >= 0) {
+        s.flags     = key_behavior_defs[i].flags;
+        s.quick_tap = key_behavior_defs[i].quick_tap;
+        s.hrm       = key_behavior_defs[i].hrm;
+    }
+    return s;
+}
+
+static inline kb_slot_t kb_get(uint16_t keycode, const keyrecord_t *record) {
+    if (kb_ready && record) {
+        keypos_t k = record->event.key;
+        if (k.row < MATRIX_ROWS && k.col < MATRIX_COLS && kb_slots[k.row][k.col].keycode == keycode) {
+            return kb_slots[k.row][k.col];
+        }
+    }
+    return kb_make(keycode);
+}
+
+#ifdef KEY_BEHAVIOR_VERIFY
+static bool kb_verify(void) {
+    for (uint8_t l = 0; l < keymap_layer_count(); l++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                uint16_t    kc  = keycode_at_keymap_location_raw(l, row, col);
+                keyrecord_t rec = {.event = {.key = {.row = row, .col = col}}};
+                kb_slot_t   a   = kb_get(kc, &rec);
+                kb_slot_t   b   = kb_make(kc);
+                if (a.flags != b.flags || a.quick_tap != b.quick_tap || a.adapt != b.adapt || a.hrm != b.hrm) return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
+
+void key_behavior_init(void) {
+    uint8_t layers = keymap_layer_count();
+    kb_ready       = false;
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            // A declared key on any layer owns the slot, else the base layer key (defaults)
+            uint16_t kc = keycode_at_keymap_location_raw(0, row, col);
+            for (uint8_t l = 0; l < layers; l++) {
+                uint16_t lkc = keycode_at_keymap_location_raw(l, row, col);
+                if (kb_def_index(lkc) >= 0) {
+                    kc = lkc;
+                    break;
+                }
+            }
+            kb_slots[row][col] = kb_make(kc);
+        }
+    }
+    kb_ready = true;
+#ifdef KEY_BEHAVIOR_VERIFY
+    if (!kb_verify()) kb_ready = false;
+#endif
+}
+
+uint16_t key_behavior_term(uint16_t keycode, keyrecord_t *record) {
+    return tap_adapt_term_at(kb_get(keycode, record).adapt);
+}
+
+bool key_behavior_flag(uint16_t keycode, keyrecord_t *record, uint8_t flags) {
+    return (kb_get(keycode, record).flags & flags) != 0;
+}
+
+uint16_t key_behavior_quick_tap(uint16_t keycode, keyrecord_t *record) {
+    return kb_get(keycode, record).quick_tap;
+}
+
+int8_t key_behavior_hrm(uint16_t keycode, keyrecord_t *record) {
+    return kb_get(keycode, record).hrm;
+}
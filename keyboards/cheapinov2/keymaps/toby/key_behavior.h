@@ -0,0 +1,46 @@
+// Per-key tap-hold behavior for Cheapino keymap (toby)
+// key_behavior_map.h declares each tap-hold key once (term, permissive hold,
+// hold on other key press, quick tap, HRM index). At boot the declarations are
+// flattened into one packed slot per key position, so QMK's per-key callbacks
+// (get_tapping_term() and friends, called over and over while a tap-hold key
+// is undecided) are a keycode check and one load instead of a switch. A
+// keycode that differs from its position's slot (other layer, replayed key)
+// falls back to a search of the declarations, so answers never depend on
+// where a key sits.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// FLAGS column of key_behavior_map.h
+#define KB_PERMISSIVE_HOLD 0x01
+#define KB_HOLD_ON_OTHER   0x02
+
+// HRM column: not a home row mod
+#define KB_NO_HRM -1
+
+typedef struct {
+    uint16_t keycode;
+    uint8_t  flags;      // KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER
+    uint8_t  quick_tap;  // ms
+    int8_t   hrm;        // HRM overlay index, KB_NO_HRM
+} key_behavior_def_t;
+
+// Expanded from key_behavior_map.h in keymap.c, KEY_BEHAVIOR_COUNT entries (config.h)
+extern const key_behavior_def_t key_behavior_defs[KEY_BEHAVIOR_COUNT];
+
+// Build the per-position slots. Call from keyboard_pre_init_user() (keymap readable).
+// With KEY_BEHAVIOR_VERIFY defined, also checks every key of every layer
+// against a plain search of the declarations and disables the fast path on any mismatch.
+void key_behavior_init(void);
+
+// Tapping term: the key's adaptive term (tap_adapt.c) or tune.tapping_term.
+uint16_t key_behavior_term(uint16_t keycode, keyrecord_t *record);
+
+// True if any of FLAGS (KB_*) is declared for the key.
+bool key_behavior_flag(uint16_t keycode, keyrecord_t *record, uint8_t flags);
+
+// Quick tap term (ms).
+uint16_t key_behavior_quick_tap(uint16_t keycode, keyrecord_t *record);
+
+// HRM overlay index, or KB_NO_HRM.
+int8_t key_behavior_hrm(uint16_t keycode, keyrecord_t *record);
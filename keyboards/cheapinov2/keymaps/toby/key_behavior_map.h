@@ -0,0 +1,33 @@
+// Declarative per-key tap-hold behavior for Cheapino (toby)
+// Define each tap-hold key once; expanded in keymap.c, flattened per key position in key_behavior.c
+// Syntax:
+//   KEY_TH(KEYCODE, TERM, FLAGS, QUICK_TAP_MS, HRM)  // comment
+//   TERM:  TERM_BASE (tune.tapping_term, fixed) or an adaptive ceiling (tap_adapt.c):
+//          TERM_HRM / TERM_HRM_GUI / TERM_THUMB = tune.tapping_term + hrm_offset / hrm_gui_offset / thumb_offset
+//   FLAGS: KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER, or 0
+//   HRM:   HRM overlay index (HRM_*_IDX), or KB_NO_HRM
+// Keys not listed: tune.tapping_term, no permissive hold, no hold on other key press, quick tap 0.
+// Adaptive entries keep this order in tap_adapt_keys[] (TAP_ADAPT_KEY_COUNT, index of `toby_hid.py terms`).
+
+#pragma once
+
+#define KEY_BEHAVIOR_MAP \
+/* Home row mods - GUI keys get slightly more time */ \
+KEY_TH(HM_A,    TERM_HRM_GUI, 0,                                     0, HRM_A_IDX) \
+KEY_TH(HM_O,    TERM_HRM_GUI, 0,                                     0, HRM_O_IDX) \
+KEY_TH(HM_R,    TERM_HRM,     0,                                     0, HRM_R_IDX) \
+KEY_TH(HM_S,    TERM_HRM,     0,                                     0, HRM_S_IDX) \
+KEY_TH(HM_T,    TERM_HRM,     0,                                     0, HRM_T_IDX) \
+KEY_TH(HM_N,    TERM_HRM,     0,                                     0, HRM_N_IDX) \
+KEY_TH(HM_E,    TERM_HRM,     0,                                     0, HRM_E_IDX) \
+KEY_TH(HM_I,    TERM_HRM,     0,                                     0, HRM_I_IDX) \
+/* Thumb keys - longer term; permissive hold (with Chordal Hold) and fast layer access */ \
+KEY_TH(ESC_MED, TERM_THUMB,   KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER, 0, KB_NO_HRM) \
+/* No hold on other key press: avoids accidental NAV (tri-layer uses ENT_SYM + BSP_NUM) */ \
+KEY_TH(SPC_NAV, TERM_THUMB,   KB_PERMISSIVE_HOLD,                    0, KB_NO_HRM) \
+KEY_TH(TAB_MOU, TERM_THUMB,   KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER, 0, KB_NO_HRM) \
+KEY_TH(ENT_SYM, TERM_THUMB,   KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER, 0, KB_NO_HRM) \
+/* No permissive hold: avoids NUM after a quick BSPC + next key; quick tap 0: own repeat (BSPC state machine) */ \
+KEY_TH(BSP_NUM, TERM_THUMB,   KB_HOLD_ON_OTHER,                      0, KB_NO_HRM) \
+/* DEL hybrid (tap leader, hold CMD): fixed term */ \
+KEY_TH(DEL_FKY, TERM_BASE,    KB_PERMISSIVE_HOLD | KB_HOLD_ON_OTHER, 0, KB_NO_HRM)
@@ -3,30 +3,52 @@
 //
 // Enhanced Cheapino Keymap with QMK Modern Features
 // Features: Chordal Hold, Combos, Key Overrides, Leader Key, OS Detection
-// LED: Non-blocking rgblight layers + deferred OS flash
+// LED: priority-stack compositor (led_comp.c) + deferred OS flash
 
 #include QMK_KEYBOARD_H
 #include "os_detection.h"
-#include "rgblight.h"
 #include "deferred_exec.h"
 #include "leader.h"
 #include "timer.h"
 #include "wait.h"
 #include "toby_keycodes.h"
+#include "leader_actions.h"
+#include "os_profile.h"
+#include "boot_profile.h"
+#include "combo_resolver.h"
+#include "combo_index.h"
+#include "autocorrect_ac.h"
+#include "autocorrect_learn.h"
+#include "tap_adapt.h"
+#include "key_behavior.h"
+#include "hybrid_key.h"
+#include "typing_streak.h"
+#include "hrm_speculate.h"
+#include "telemetry.h"
+#include "ee_cache.h"
+#include "led_comp.h"
+#include "mouse_engine.h"
+#include "tune.h"
+#include "event_trace.h"
+#include "out_queue.h"
+#include "unicode_out.h"
+#include "hot_path.h"
+#include "cycle_prof.h"
 
 // Guard window to avoid unintended BSPC quick-tap repeat after other keys
 #ifndef BSP_QT_GUARD_MS
 #define BSP_QT_GUARD_MS 180
 #endif
 
-#ifndef DEL_HOLD_VISUAL_MS
-#define DEL_HOLD_VISUAL_MS 140
-#endif
-
 #ifndef CMD_HOLD_HUE
 #define CMD_HOLD_HUE 149
 #endif
 
+// Leader overlay tint once the typed prefix narrows the candidates
+#ifndef LEADER_NARROW_HUE
+#define LEADER_NARROW_HUE 30
+#endif
+
 // (reserved) quick-tap guard timestamp (not used)
 // static uint16_t bsp_qt_block_time = 0;
 
@@ -34,16 +56,11 @@
 static bool app_sw_toggled = false;
 static uint16_t app_sw_last_tab_time = 0;
 static deferred_token app_sw_token = 0;
-static uint16_t app_sw_mod_for_os(void) {
-    os_variant_t os = detected_host_os();
-    if (os == OS_MACOS || os == OS_IOS) return KC_LGUI;   // Cmd
-    if (os == OS_WINDOWS) return KC_LALT;                  // Alt
-    return LINUX_APP_SWITCH_MOD;                           // Linux configurable
-}
 static uint32_t app_sw_autorelease_cb(uint32_t t, void *arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
     (void)t; (void)arg;
-    if (app_sw_toggled && timer_elapsed(app_sw_last_tab_time) >= APP_SW_AUTORELEASE_MS) {
-        unregister_code(app_sw_mod_for_os());
+    if (app_sw_toggled && timer_elapsed(app_sw_last_tab_time) >= tune.app_sw_release) {
+        unregister_code(os_profile->app_sw_mod);
         app_sw_toggled = false;
         send_keyboard_report();
         return 0;
@@ -53,29 +70,18 @@ static uint32_t app_sw_autorelease_cb(uint32_t t, void *arg) {
 
 // Command layer helpers (hold DEL_FKY)
 static void cmd_copy_os_aware(void) {
-    os_variant_t os = detected_host_os();
-    if (os == OS_MACOS || os == OS_IOS) {
-        tap_code16(LGUI(KC_C));       // Cmd+C
-    } else {
-        tap_code16(C(S(KC_C)));       // Ctrl+Shift+C (terminal-first)
-    }
+    tap_code16(os_profile->cmd_copy);   // Cmd+C / Ctrl+Shift+C (terminal-first)
 }
 
 static void cmd_paste_os_aware(void) {
-    os_variant_t os = detected_host_os();
-    if (os == OS_MACOS || os == OS_IOS) {
-        tap_code16(LGUI(KC_V));       // Cmd+V
-    } else {
-        tap_code16(C(S(KC_V)));       // Ctrl+Shift+V (terminal-first)
-    }
+    tap_code16(os_profile->cmd_paste);  // Cmd+V / Ctrl+Shift+V (terminal-first)
 }
 
 static void cmd_interrupt(void) {
     tap_code16(C(KC_C));              // Ctrl+C (SIGINT in terminal)
 }
 
-// Mouse ACL: use QMK defaults (MS_ACL keys are momentary by default).
-// No custom interception here to ensure the built-in accel stages take effect.
+// Mouse motion/wheel/ACL keys: mouse_engine.c (momentary speed multipliers).
 
 // Force NUM layer while BSP_NUM held with second key — handled by BSPC state machine now
 
@@ -85,29 +91,12 @@ static void apply_layer_color(layer_state_t state);
 // Track thumb LT state (for conditional HOOKP on SPC_NAV)
 static bool bsp_num_pressed = false;
 
-// Leader overlay state (white LED during leader timeout)
+// LED init state (FAST_BOOT defers LED init until USB is configured)
+static bool led_ready = false;
+static bool os_flash_pending = false;
+
+// Leader overlay state (white LED during leader timeout, tinted as candidates narrow)
 static bool leader_overlay_active = false;
-static uint8_t leader_len = 0;  // track length to auto-complete sequences
-
-// DEL_FKY hybrid state (tap leader, hold command layer)
-static bool del_fky_pressed = false;
-static bool del_fky_used_as_hold = false;
-static bool del_fky_hold_visual = false;
-static deferred_token del_fky_hold_visual_token = 0;
-
-static uint32_t del_fky_hold_visual_cb(uint32_t t, void *arg) {
-    (void)t;
-    (void)arg;
-#ifdef RGBLIGHT_LAYERS
-    if (del_fky_pressed && !leader_sequence_active()) {
-        // Crossing the hold threshold counts as a hold, not a tap-leader.
-        del_fky_used_as_hold = true;
-        del_fky_hold_visual = true;
-        apply_layer_color(layer_state);
-    }
-#endif
-    return 0;
-}
 
 // Layer definitions
 enum layers {
@@ -137,28 +126,8 @@ enum layers {
 #define HM_I RALT_T(KC_I)
 #define HM_O RGUI_T(KC_O)
 
-// Unicode map for German umlauts (CMD layer: DEL hold + A/O/U/S)
-enum unicode_names {
-    U_AE_L, // ä
-    U_AE_U, // Ä
-    U_OE_L, // ö
-    U_OE_U, // Ö
-    U_UE_L, // ü
-    U_UE_U, // Ü
-    U_SS_L, // ß
-    U_SS_U, // ẞ
-};
-
-const uint32_t PROGMEM unicode_map[] = {
-    [U_AE_L] = 0x00E4, // ä
-    [U_AE_U] = 0x00C4, // Ä
-    [U_OE_L] = 0x00F6, // ö
-    [U_OE_U] = 0x00D6, // Ö
-    [U_UE_L] = 0x00FC, // ü
-    [U_UE_U] = 0x00DC, // Ü
-    [U_SS_L] = 0x00DF, // ß
-    [U_SS_U] = 0x1E9E, // ẞ
-};
+// HRM overlay index per home row mod (HRM column of key_behavior_map.h)
+enum { HRM_A_IDX, HRM_R_IDX, HRM_S_IDX, HRM_T_IDX, HRM_N_IDX, HRM_E_IDX, HRM_I_IDX, HRM_O_IDX, HRM_COUNT };
 
 // Thumb keys with layer tap
 #define ESC_MED LT(_MEDIA, KC_ESC)
@@ -242,8 +211,8 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
         // Hold DEL_FKY and press:
         // P=paste, Y=copy, ESC=interrupt
         // A=ä, O=ö, U=ü, S=ß (+ Shift for uppercase)
-        KC_NO,           KC_NO,   KC_NO,           CMD_PASTE, KC_NO,        KC_NO,   KC_NO,           UP(U_UE_L,U_UE_U), CMD_COPY,        KC_NO,
-        UP(U_AE_L,U_AE_U), _______, UP(U_SS_L,U_SS_U), _______, _______,     _______,  _______,         _______,            _______,         UP(U_OE_L,U_OE_U),
+        KC_NO,           KC_NO,   KC_NO,           CMD_PASTE, KC_NO,        KC_NO,   KC_NO,           UNI_UE,            CMD_COPY,        KC_NO,
+        UNI_AE,            _______, UNI_SS,            _______, _______,     _______,  _______,         _______,            _______,         UNI_OE,
         KC_NO,           KC_NO,   KC_NO,           KC_NO,     KC_NO,        KC_NO,   KC_NO,           KC_NO,              KC_NO,           KC_NO,
                                                    CMD_INTR,  KC_NO,   KC_NO,   KC_NO,   KC_NO,   KC_NO
     ),
@@ -259,59 +228,85 @@ enum combo_events {
     COMBO_CUT,
 };
 
-// Define combo key sequences
-const uint16_t PROGMEM combo_copy[] = {KC_X, KC_C, COMBO_END};
-const uint16_t PROGMEM combo_paste[] = {KC_C, KC_V, COMBO_END};
-const uint16_t PROGMEM combo_cut[] = {KC_Z, KC_X, COMBO_END};
+// Combo definitions (base-layer keycodes) - actions handled in process_combo_event.
+// Indexed by key position in combo_index.c; COMBO_COUNT must match.
+const combo_def_t combo_defs[COMBO_COUNT] = {
+    [COMBO_COPY]  = {{KC_X, KC_C}},
+    [COMBO_PASTE] = {{KC_C, KC_V}},
+    [COMBO_CUT]   = {{KC_Z, KC_X}},
+};
 
-// Combo definitions - actions handled in process_combo_event
-combo_t key_combos[] = {
-    [COMBO_COPY] = COMBO_ACTION(combo_copy),
-    [COMBO_PASTE] = COMBO_ACTION(combo_paste),
-    [COMBO_CUT] = COMBO_ACTION(combo_cut),
+// Key sent together with the OS shortcut modifier (Ctrl/Cmd) per combo
+static const uint8_t combo_shortcut_keys[] = {
+    [COMBO_COPY]  = KC_C,
+    [COMBO_PASTE] = KC_V,
+    [COMBO_CUT]   = KC_X,
 };
 
-// Combo actions - OS-aware using QMK OS Detection
+// Combos holding the shortcut modifier; it goes up with the last of them
+static uint8_t combo_mod_holds = 0;
+
+// Combo actions - OS-aware via the active OS profile
 void process_combo_event(uint16_t combo_index, bool pressed) {
-    os_variant_t os = detected_host_os();
-    bool is_macos = (os == OS_MACOS || os == OS_IOS);
-
-    // Determine which modifier to use
-    uint8_t mod = is_macos ? KC_LGUI : KC_LCTL;
-
-    switch (combo_index) {
-        case COMBO_COPY:
-            if (pressed) {
-                register_code(mod);
-                register_code(KC_C);
-            } else {
-                unregister_code(KC_C);
-                unregister_code(mod);
-            }
-            break;
-
-        case COMBO_PASTE:
-            if (pressed) {
-                register_code(mod);
-                register_code(KC_V);
-            } else {
-                unregister_code(KC_V);
-                unregister_code(mod);
-            }
-            break;
-
-        case COMBO_CUT:
-            if (pressed) {
-                register_code(mod);
-                register_code(KC_X);
-            } else {
-                unregister_code(KC_X);
-                unregister_code(mod);
-            }
-            break;
+    if (combo_index >= ARRAY_SIZE(combo_shortcut_keys)) return;
+    if (pressed) combo_resolver_fired(combo_index);
+    uint8_t mod = os_profile->shortcut_mod;
+    uint8_t key = combo_shortcut_keys[combo_index];
+
+    if (pressed) {
+        combo_mod_holds++;
+        register_code(mod);
+        register_code(key);
+    } else {
+        unregister_code(key);
+        if (combo_mod_holds && --combo_mod_holds == 0) unregister_code(mod);
     }
 }
 
+// Speculative HRM modifiers (Ctrl/Shift only: a lone Alt/GUI tap opens menus)
+const uint16_t hrm_spec_keys[HRM_SPEC_KEY_COUNT] = {
+    HM_S, HM_T,  // left Ctrl, Shift
+    HM_N, HM_E,  // right Shift, Ctrl
+};
+
+// Typing-streak fast path: HRMs and thumb LTs (not BSP_NUM, whose own state
+// machine counts its taps) resolve as taps while typing
+bool typing_streak_eligible(uint16_t keycode) {
+    return keycode != BSP_NUM;
+}
+
+#if defined(LED_COMPOSITOR) && defined(TYPING_STREAK_HUE)
+// Streak state as last reported, for the base-layer tint
+static bool streak_tint = false;
+#endif
+
+void typing_streak_changed(bool active) {
+#if defined(LED_COMPOSITOR) && defined(TYPING_STREAK_HUE)
+    streak_tint = active;
+    apply_layer_color(layer_state);
+#endif
+}
+
+// Runs before tap-hold processing: events held back behind queued output,
+// press timing for the combo resolver, the typing-streak rewrite, the indexed
+// combo engine (false = held, buffered or consumed by a combo), then the
+// speculative HRM mods for presses that go on to tap-hold
+bool HOT_FUNC(pre_process_record_user)(uint16_t keycode, keyrecord_t *record) {
+    CYCLE_PROF_SCOPE(PROF_PRE_RECORD);
+    if (!out_queue_sync(record)) return false;
+#ifdef EVENT_TRACE
+    event_trace_key(record);
+#endif
+    telemetry_key(record);
+    combo_resolver_note_press(record);
+    typing_streak_process(keycode, record);
+    if (!CYCLE_PROF_CALL(PROF_COMBO, combo_index_process(keycode, record))) return false;
+#ifdef HRM_SPECULATE
+    hrm_speculate_press(keycode, record);
+#endif
+    return true;
+}
+
 // ============================================================================
 // KEY OVERRIDES
 // ============================================================================
@@ -329,26 +324,65 @@ const key_override_t *key_overrides[] = {
     NULL  // Terminator
 };
 
+// ============================================================================
+// CAPS WORD
+// ============================================================================
+
+// QMK's default word characters, plus the umlaut keys (typed as capitals while active)
+bool caps_word_press_user(uint16_t keycode) {
+    switch (keycode) {
+        case KC_A ... KC_Z:
+        case KC_MINS:
+            add_weak_mods(MOD_BIT(KC_LSFT));
+            return true;
+        case KC_1 ... KC_0:
+        case KC_BSPC:
+        case KC_DEL:
+        case KC_UNDS:
+        case UNI_AE ... UNI_SS:
+            return true;
+        default:
+            return false;
+    }
+}
+
 // ============================================================================
 // LEADER KEY - Shortcuts
 // ============================================================================
 
+// Leader timeout runs here so it is tunable (tune.leader_timeout); QMK's
+// LEADER_TIMEOUT is only a backstop. Re-armed per key (LEADER_PER_KEY_TIMING).
+static deferred_token leader_timeout_token = INVALID_DEFERRED_TOKEN;
+
+static uint32_t leader_timeout_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)trigger_time;
+    (void)cb_arg;
+    leader_timeout_token = INVALID_DEFERRED_TOKEN;
+    if (leader_sequence_active()) leader_end();
+    return 0;
+}
+
+static void leader_timeout_arm(void) {
+    cancel_deferred_exec(leader_timeout_token);
+    leader_timeout_token = defer_exec(tune.leader_timeout, leader_timeout_cb, NULL);
+}
+
 void leader_start_user(void) {
-#ifdef RGBLIGHT_LAYERS
+    leader_prefix_reset();
+    leader_timeout_arm();
+#ifdef LED_COMPOSITOR
     leader_overlay_active = true;
     // White at configured brightness while leader is active
-    rgblight_sethsv_noeeprom(0, 0, LED_BRIGHTNESS);
+    apply_layer_color(layer_state);
 #endif
-    leader_len = 0;
 }
 
 void leader_end_user(void) {
-    os_variant_t os = detected_host_os();
-    bool is_macos = (os == OS_MACOS || os == OS_IOS);
-
+    cancel_deferred_exec(leader_timeout_token);
+    leader_timeout_token = INVALID_DEFERRED_TOKEN;
     // Delegate actual actions to the leader module
-    extern void leader_handle_sequences(bool is_macos);
-    leader_handle_sequences(is_macos);
+    leader_handle_sequences();
 
     // Turn off leader overlay and restore layer color
     leader_overlay_active = false;
@@ -356,13 +390,18 @@ void leader_end_user(void) {
 }
 
 bool leader_add_user(uint16_t keycode) {
-    leader_len++;
-    // If DEL is hit again during leader wait, end immediately and treat as DEL,DEL.
-    if (keycode == DEL_FKY) {
-        return true;
+    // Prefix match against leader_map.h: fire as soon as one entry is fully typed
+    // (e.g. DEL,DEL), abort as soon as nothing can match. Otherwise keep waiting.
+    leader_match_t match = leader_prefix_add(keycode);
+    if (match == LEADER_MATCH_PARTIAL) {
+        leader_timeout_arm();
     }
-    // Default: auto-complete after two keys.
-    return leader_len >= 2;
+#ifdef LED_COMPOSITOR
+    if (match == LEADER_MATCH_PARTIAL) {
+        apply_layer_color(layer_state);
+    }
+#endif
+    return match != LEADER_MATCH_PARTIAL;
 }
 
 // ============================================================================
@@ -373,186 +412,81 @@ bool leader_add_user(uint16_t keycode) {
 // It automatically handles same-hand vs opposite-hand detection.
 // We just need to configure per-key tapping behavior.
 
+// Per-key behavior is declared once in key_behavior_map.h. Tapping term
+// ceilings (tune.tapping_term + group offset, all tunable) feed tap_adapt.c,
+// which shrinks each towards what the key's own taps need (percentile of
+// measured tap durations); key_behavior.c answers the callbacks below from
+// one packed slot per key position.
+#include "key_behavior_map.h"
+
+const key_behavior_def_t key_behavior_defs[] = {
+#define KEY_TH(KC, TERM, FLAGS, QUICK_TAP, HRM) {KC, FLAGS, QUICK_TAP, HRM},
+    KEY_BEHAVIOR_MAP
+#undef KEY_TH
+};
+
+// Adaptive entries only (TERM other than TERM_BASE), in map order
+#define KB_ADAPT_TERM_BASE(KC)
+#define KB_ADAPT_TERM_HRM(KC)     {KC, &tune.hrm_offset},
+#define KB_ADAPT_TERM_HRM_GUI(KC) {KC, &tune.hrm_gui_offset},
+#define KB_ADAPT_TERM_THUMB(KC)   {KC, &tune.thumb_offset},
+const tap_adapt_key_t tap_adapt_keys[] = {
+#define KEY_TH(KC, TERM, FLAGS, QUICK_TAP, HRM) KB_ADAPT_##TERM(KC)
+    KEY_BEHAVIOR_MAP
+#undef KEY_TH
+};
+
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
-    switch (keycode) {
-        // Home row mods - standard tapping term
-        case HM_A:
-        case HM_O:
-            return TAPPING_TERM + 30;  // GUI keys get slightly more time
-        case HM_R:
-        case HM_S:
-        case HM_T:
-        case HM_N:
-        case HM_E:
-        case HM_I:
-            return TAPPING_TERM;
-        // Thumb keys - longer tapping term for comfort
-        case ESC_MED:
-        case SPC_NAV:
-        case TAB_MOU:
-        case ENT_SYM:
-        case BSP_NUM:
-        case DEL_FKY:
-            return TAPPING_TERM + 50;
-        default:
-            return TAPPING_TERM;
-    }
+    return key_behavior_term(keycode, record);
 }
 
-// Per-key permissive hold
 bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
-    switch (keycode) {
-        // Enable for thumb keys only (recommended with Chordal Hold)
-        case ESC_MED:
-        case SPC_NAV:
-        case TAB_MOU:
-        case ENT_SYM:
-        case DEL_FKY:
-            return true;
-        case BSP_NUM:
-            // Disable HOOKP for BSPC/NUM to avoid unintended NUM activation after quick BSPC + next key
-            return false;
-        default:
-            return false;
-    }
+    return key_behavior_flag(keycode, record, KB_PERMISSIVE_HOLD);
 }
 
-// Per-key hold on other key press
 bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
-    switch (keycode) {
-        // Enable for thumb layer keys for faster layer access
-        case ESC_MED:
-        case TAB_MOU:
-        case ENT_SYM:
-        case BSP_NUM:
-        case DEL_FKY:
-            return true;
-        case SPC_NAV:
-            // Keep disabled to avoid accidental NAV; tri-layer uses ENT_SYM + BSP_NUM
-            return false;
-        default:
-            return false;
-    }
+    return key_behavior_flag(keycode, record, KB_HOLD_ON_OTHER);
 }
 
-// Per-key quick tap term - enables fast repeat for Backspace with guard
 uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
-    switch (keycode) {
-        case BSP_NUM:
-            // Managed by BSPC state machine; disable quick-tap repeat
-            return 0;
-        default:
-            return 0;
-    }
+    return key_behavior_quick_tap(keycode, record);
 }
 
 // ============================================================================
-// RGBLIGHT - Layer colors (non-blocking) + OS flash on boot
+// HOME ROW MODS, APP SWITCHER HELPERS, HYBRID KEYS (BSPC / DEL)
 // ============================================================================
 
-#ifdef RGBLIGHT_LAYERS
-// Per-layer HSV helpers (H:0-255, S:0-255, V:0-255)
-static inline uint8_t hsv_h_for_layer(uint8_t layer) {
-    switch (layer) {
-        // Arrange hues to avoid similar adjacent colors
-        case _MEDIA: return 127; // Cyan (~180°)
-        case _NAV:   return 21;  // Orange (~30°)
-        case _MOUSE: return 85;  // Green (~120°)
-        case _SYM_R: return 170; // Blue (~240°)
-        case _NUM:   return 212; // Magenta (~300°)
-        case _FKEY:  return 43;  // Yellow (~60°)
-        case _EXTRA: return 233; // Rose (~330°)
-        case _CMD:
-        case _BASE:
-        default:     return 0;   // Off (S ignored, V=0)
-    }
-}
-
-static inline uint8_t hsv_s_for_layer(uint8_t layer) {
-    switch (layer) {
-        case _CMD:
-        case _BASE:  return 0;   // Off when V=0
-        default:     return 255; // Fully saturated
-    }
-}
-
-static inline uint8_t hsv_v_for_layer(uint8_t layer) {
-    // Global brightness from config; Base/CMD layers off
-    return (layer == _BASE || layer == _CMD) ? 0 : LED_BRIGHTNESS;
-}
-
-// RGBlight layer segments (1 LED total). We also set HSV directly for precision.
-const rgblight_segment_t PROGMEM layer_base[]  = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_WHITE});
-const rgblight_segment_t PROGMEM layer_media[] = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_CYAN});
-const rgblight_segment_t PROGMEM layer_nav[]   = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_GREEN});
-const rgblight_segment_t PROGMEM layer_mouse[] = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_PURPLE});
-const rgblight_segment_t PROGMEM layer_sym[]   = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_YELLOW});
-const rgblight_segment_t PROGMEM layer_num[]   = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_ORANGE});
-const rgblight_segment_t PROGMEM layer_fkey[]  = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_MAGENTA});
-const rgblight_segment_t PROGMEM layer_extra[] = RGBLIGHT_LAYER_SEGMENTS({0, 1, HSV_RED});
-
-const rgblight_segment_t* const PROGMEM my_rgb_layers[] = RGBLIGHT_LAYERS_LIST(
-    layer_base,
-    layer_media,
-    layer_nav,
-    layer_mouse,
-    layer_sym,
-    layer_num,
-    layer_fkey,
-    layer_extra
-);
-
-static void rgblight_layers_all_off(void) {
-    for (uint8_t i = 0; i < 8; i++) {
-        rgblight_set_layer_state(i, false);
-    }
-}
-
 static bool hrm_overlay_active = false;
 // HRM overlay state
-enum { HRM_A_IDX, HRM_R_IDX, HRM_S_IDX, HRM_T_IDX, HRM_N_IDX, HRM_E_IDX, HRM_I_IDX, HRM_O_IDX, HRM_COUNT };
 static bool hrm_pressed[HRM_COUNT] = {0};
 static bool hrm_is_hold[HRM_COUNT] = {0};
 static uint8_t hrm_active_count = 0;
 static deferred_token hrm_tokens[HRM_COUNT] = {0};
 static void same_app_window_cycle(bool reverse) {
-    os_variant_t os = detected_host_os();
-    uint16_t mod_primary = KC_LALT;
-    uint16_t key = KC_GRV; // backtick
-    bool add_shift = reverse;
-
-    if (os == OS_MACOS || os == OS_IOS) {
-        mod_primary = KC_LGUI; // Cmd + `
-        key = KC_GRV;
-    } else if (os == OS_WINDOWS) {
-        // Windows: kein natives same-app cycling → Alt+Esc als globaler Fallback
-        mod_primary = KC_LALT;
-        key = KC_ESC;
-        add_shift = false;
-    }
+    const os_profile_t *p = os_profile;
+    bool add_shift = reverse && p->win_cycle_shift;
 
     if (add_shift) register_code(KC_LSFT);
-    register_code(mod_primary);
-    tap_code(key);
-    unregister_code(mod_primary);
+    register_code(p->win_cycle_mod);
+    tap_code(p->win_cycle_key);
+    unregister_code(p->win_cycle_mod);
     if (add_shift) unregister_code(KC_LSFT);
 }
 
-static int hrm_index_for(uint16_t kc) {
-    switch (kc) {
-        case HM_A: return HRM_A_IDX;
-        case HM_R: return HRM_R_IDX;
-        case HM_S: return HRM_S_IDX;
-        case HM_T: return HRM_T_IDX;
-        case HM_N: return HRM_N_IDX;
-        case HM_E: return HRM_E_IDX;
-        case HM_I: return HRM_I_IDX;
-        case HM_O: return HRM_O_IDX;
-        default:   return -1;
-    }
-}
+// Modifier bit each HRM contributes while physically held
+static const uint8_t hrm_mod_bits[HRM_COUNT] = {
+    [HRM_A_IDX] = MOD_BIT(KC_LGUI),
+    [HRM_R_IDX] = MOD_BIT(KC_LALT),
+    [HRM_S_IDX] = MOD_BIT(KC_LCTL),
+    [HRM_T_IDX] = MOD_BIT(KC_LSFT),
+    [HRM_N_IDX] = MOD_BIT(KC_RSFT),
+    [HRM_E_IDX] = MOD_BIT(KC_RCTL),
+    [HRM_I_IDX] = MOD_BIT(KC_RALT),
+    [HRM_O_IDX] = MOD_BIT(KC_RGUI),
+};
 
 static uint32_t hrm_hold_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
     (void)trigger_time;
     uintptr_t idx = (uintptr_t)cb_arg;
     if (idx >= HRM_COUNT) return 0;
@@ -562,7 +496,7 @@ static uint32_t hrm_hold_cb(uint32_t trigger_time, void *cb_arg) {
             // Activate overlay: random-ish hue, full sat, configured homerow brightness
             uint8_t hue = (uint8_t)((timer_read() * 37u + (uint32_t)idx * 53u) & 0xFFu);
             hrm_overlay_active = true;
-            rgblight_sethsv_noeeprom(hue, 255, LED_BRIGHTNESS_HOMEROW);
+            led_comp_set(LED_SRC_HRM, hue, 255, LED_BRIGHTNESS_HOMEROW);
         }
         hrm_active_count++;
     }
@@ -570,138 +504,187 @@ static uint32_t hrm_hold_cb(uint32_t trigger_time, void *cb_arg) {
 }
 
 // --- SHIFT+Backspace → Delete hold support (robust across HRM/Shift timing) ---
-static bool hm_t_pressed = false;
-static bool hm_n_pressed = false;
-// Track HRM GUI/CTRL too for robust chord detection before mod bits latch
-static bool hm_a_pressed = false; // LGUI on A
-static bool hm_o_pressed = false; // RGUI on O
-static bool hm_s_pressed = false; // LCTL on S
-static bool hm_e_pressed = false; // RCTL on E
+// Mod bits of physically held HRMs, for chord detection before mod bits latch
+static uint8_t hrm_mods_down = 0;
 static bool bsp_del_active = false;
 static uint8_t bsp_del_saved_mods = 0;
 
-// --- BSPC State Machine (tap/hold, double-tap->hold, triple-tap->repeat) ---
-static bool     bsp_pressed = false;
-// legacy flag removed; rely on LT for hold
-static uint8_t  bsp_tap_count = 0;
-static uint16_t bsp_last_tap_time = 0;
-static bool     bsp_repeat_active = false;
-#ifndef BSPC_TRIPLE_HOLD_MS
-#define BSPC_TRIPLE_HOLD_MS 80
-#endif
-static bool     bsp_triple_pending = false;
-static deferred_token bsp_triple_hold_token = 0;
-static deferred_token bsp_repeat_token = 0;
+// --- Hybrid keys: BSPC triple-tap-hold repeat, DEL tap-leader/hold-CMD (hybrid_key_map.h) ---
+static void bspc_hybrid(uint8_t actions) {
+    if (actions & HK_TAP) tap_code(KC_BSPC);
+}
 
-#ifndef BSPC_HOLD_MS
-#define BSPC_HOLD_MS TAPPING_TERM
-#endif
-#ifndef BSPC_REPEAT_INTERVAL_MS
-#define BSPC_REPEAT_INTERVAL_MS 35
-#endif
-#ifndef BSPC_TRIPLE_TERM_MS
-#define BSPC_TRIPLE_TERM_MS 400
-#endif
+static void del_hybrid(uint8_t actions) {
+    if (actions & HK_HOLD) layer_on(_CMD);
+    if (actions & HK_UNHOLD) layer_off(_CMD);
+    if (actions & HK_TAP) leader_start();
+    if (actions & HK_SHOW) apply_layer_color(layer_state);
+}
+
+const hk_key_def_t hybrid_key_defs[] = {
+#define HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER) [HK_##KEY] = {KEYCODE, WINDOW, DEFAULT, HK_##KEY##_IDLE, HANDLER},
+#define HK_STATE(KEY, STATE, TIMER)
+#define HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS)
+    HYBRID_KEY_MAP
+#undef HK_KEY
+#undef HK_STATE
+#undef HK_ON
+};
 
-// static uint32_t bsp_hold_cb(uint32_t t, void *arg) { return 0; }
+const uint16_t *const hybrid_key_timers[] = {
+#define HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER)
+#define HK_STATE(KEY, STATE, TIMER) [HK_##KEY##_##STATE] = TIMER,
+#define HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS)
+    HYBRID_KEY_MAP
+#undef HK_KEY
+#undef HK_STATE
+#undef HK_ON
+};
 
-static uint32_t bsp_repeat_cb(uint32_t t, void *arg) {
-    (void)t; (void)arg;
-    if (bsp_repeat_active && bsp_pressed) {
-        tap_code(KC_BSPC);
-        return BSPC_REPEAT_INTERVAL_MS;
+const hk_trans_t hybrid_key_table[HK_STATE_COUNT][HK_EV_COUNT] = {
+#define HK_KEY(KEY, KEYCODE, WINDOW, DEFAULT, HANDLER)
+#define HK_STATE(KEY, STATE, TIMER)
+#define HK_ON(KEY, STATE, EVENT, NEXT, ACTIONS) [HK_##KEY##_##STATE][HK_EV_##EVENT] = {HK_##KEY##_##NEXT, HK_DEFINED | (ACTIONS)},
+    HYBRID_KEY_MAP
+#undef HK_KEY
+#undef HK_STATE
+#undef HK_ON
+};
+
+// ============================================================================
+// LEDs - Layer colors + overlays through the compositor (led_comp.c) + OS flash
+// ============================================================================
+
+#ifdef LED_COMPOSITOR
+// Per-layer HSV helpers (H:0-255, S:0-255, V:0-255)
+static inline uint8_t hsv_h_for_layer(uint8_t layer) {
+    switch (layer) {
+        // Arrange hues to avoid similar adjacent colors
+        case _MEDIA: return 127; // Cyan (~180°)
+        case _NAV:   return 21;  // Orange (~30°)
+        case _MOUSE: return 85;  // Green (~120°)
+        case _SYM_R: return 170; // Blue (~240°)
+        case _NUM:   return 212; // Magenta (~300°)
+        case _FKEY:  return 43;  // Yellow (~60°)
+        case _EXTRA: return 233; // Rose (~330°)
+        case _CMD:
+        case _BASE:
+        default:     return 0;   // Off (S ignored, V=0)
     }
-    return 0;
 }
 
-static uint32_t bsp_triple_hold_cb(uint32_t t, void *arg) {
-	(void)t; (void)arg;
-	if (bsp_triple_pending && bsp_pressed && !bsp_repeat_active) {
-		bsp_repeat_active = true;
-		bsp_repeat_token = defer_exec(BSPC_REPEAT_INTERVAL_MS, bsp_repeat_cb, NULL);
-		bsp_triple_pending = false;
-	}
-	return 0;
+static inline uint8_t hsv_s_for_layer(uint8_t layer) {
+    switch (layer) {
+        case _CMD:
+        case _BASE:  return 0;   // Off when V=0
+        default:     return 255; // Fully saturated
+    }
+}
+
+static inline uint8_t hsv_v_for_layer(uint8_t layer) {
+    // Global brightness from config; Base/CMD layers off
+    return (layer == _BASE || layer == _CMD) ? 0 : LED_BRIGHTNESS;
 }
 
+// Sync the compositor slots with the current overlay flags and layer state.
+// Only records colors; the frame itself is composed and pushed later.
 static void apply_layer_color(layer_state_t state) {
     if (leader_overlay_active) {
-        // Leader overlay has highest priority: white while waiting
-        rgblight_sethsv_noeeprom(0, 0, LED_BRIGHTNESS);
-        return;
+        // White while all entries are possible, saturating towards
+        // LEADER_NARROW_HUE as the typed prefix narrows them down
+        uint8_t total = leader_entry_count();
+        uint8_t left  = leader_prefix_candidates();
+        uint8_t sat   = total ? (uint8_t)(255u - (uint16_t)left * 255u / total) : 0;
+        led_comp_set(LED_SRC_LEADER, LEADER_NARROW_HUE, sat, LED_BRIGHTNESS);
+    } else {
+        led_comp_clear(LED_SRC_LEADER);
     }
-    if (hrm_overlay_active) {
-        // Preserve HRM overlay color until HRM released
-        return;
+    if (!hrm_overlay_active) {
+        // Set with its own hue when an HRM becomes a hold
+        led_comp_clear(LED_SRC_HRM);
     }
-    if (del_fky_hold_visual) {
+    if (hybrid_key_state(HK_DEL) == HK_DEL_HELD) {
         // DEL hold-command feedback color
-        rgblight_sethsv_noeeprom(CMD_HOLD_HUE, 255, LED_BRIGHTNESS);
-        return;
+        led_comp_set(LED_SRC_CMD, CMD_HOLD_HUE, 255, LED_BRIGHTNESS);
+    } else {
+        led_comp_clear(LED_SRC_CMD);
     }
     uint8_t top = get_highest_layer(state);
-    rgblight_sethsv_noeeprom(hsv_h_for_layer(top), hsv_s_for_layer(top), hsv_v_for_layer(top));
-
-    rgblight_layers_all_off();
-    switch (top) {
-        case _MEDIA: rgblight_set_layer_state(1, true); break;
-        case _NAV:   rgblight_set_layer_state(2, true); break;
-        case _MOUSE: rgblight_set_layer_state(3, true); break;
-        case _SYM_R: rgblight_set_layer_state(4, true); break;
-        case _NUM:   rgblight_set_layer_state(5, true); break;
-        case _FKEY:  rgblight_set_layer_state(6, true); break;
-        case _EXTRA: rgblight_set_layer_state(7, true); break;
-        case _CMD:
-        case _BASE:
-        default:     /* base off */ break;
+#ifdef TYPING_STREAK_HUE
+    if (top == _BASE && streak_tint) {
+        // Dim tint on base while the typing-streak fast path is on
+        led_comp_set(LED_SRC_LAYER, TYPING_STREAK_HUE, 255, LED_BRIGHTNESS / 2);
+        return;
+    }
+#endif
+    if (hsv_v_for_layer(top)) {
+        led_comp_set(LED_SRC_LAYER, hsv_h_for_layer(top), hsv_s_for_layer(top), hsv_v_for_layer(top));
+    } else {
+        led_comp_clear(LED_SRC_LAYER);  // base/CMD: off (or the OS flash)
     }
 }
 
 static uint32_t os_flash_done_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
     (void)trigger_time;
     (void)cb_arg;
-    apply_layer_color(layer_state);
+    led_comp_clear(LED_SRC_OS_FLASH);
     return 0; // stop
 }
-#endif // RGBLIGHT_LAYERS
 
-// Wait until OS detection becomes known, then configure modifier swap and LED flash
-static uint32_t os_setup_wait_cb(uint32_t trigger_time, void *cb_arg) {
-    (void)trigger_time;
-    (void)cb_arg;
-    static uint8_t attempts = 0;
-    attempts++;
+// Show OS color for 800ms at configured brightness (under any active layer color)
+// Windows: BSOD blue, macOS: white, Linux: Ubuntu purple
+static void os_flash_start(void) {
+    led_comp_set(LED_SRC_OS_FLASH, os_profile->flash_hue, os_profile->flash_sat, LED_BRIGHTNESS);
+    defer_exec(800, os_flash_done_cb, NULL);
+}
 
-    os_variant_t os = detected_host_os();
+// Start the LED driver behind the compositor; with FAST_BOOT this runs
+// after USB enumeration instead of in keyboard_post_init_user()
+static void led_init(void) {
+    apply_layer_color(layer_state); // set to current layer (Base off)
+    led_comp_init();
+    led_ready = true;
+    if (os_flash_pending) {
+        os_flash_pending = false;
+        os_flash_start();
+    }
+}
+#else
+// No LED: overlays and layer colors have nothing to show
+static void apply_layer_color(layer_state_t state) {
+    (void)state;
+}
+#endif // LED_COMPOSITOR
+
+// Select the OS profile; every handler reads through os_profile from here on
+static void os_apply(os_variant_t os) {
+    os_profile_select(os);
+    keymap_config.swap_lctl_lgui = os_profile->swap_ctl_gui;
+    keymap_config.swap_rctl_rgui = os_profile->swap_ctl_gui;
+}
+
+// Called by QMK once OS detection settles (and again if it changes).
+// The last known host OS was already applied at boot; switch and persist
+// only when detection disagrees, then show the OS flash.
+bool process_detected_host_os_user(os_variant_t os) {
     if (os == OS_UNSURE) {
-        if (attempts < 30) {
-            return 200; // retry
-        } else {
-            // Give up; just apply current layer color
-#ifdef RGBLIGHT_LAYERS
-            apply_layer_color(layer_state);
-#endif
-            return 0;
-        }
+        return true;
+    }
+    boot_prof_mark(BOOT_PHASE_OS_DETECTED);
+    if (os != os_profile_remembered()) {
+        os_profile_remember(os);
+        os_apply(os);
     }
 
-    bool is_macos = (os == OS_MACOS || os == OS_IOS);
-    keymap_config.swap_lctl_lgui = is_macos;
-    keymap_config.swap_rctl_rgui = is_macos;
-
-#ifdef RGBLIGHT_LAYERS
-    // Show OS color for 800ms at configured brightness, then restore
-    // Windows: BSOD blue, macOS: white, Linux: Ubuntu purple
-    if (os == OS_WINDOWS) {
-        rgblight_sethsv_noeeprom(170, 255, LED_BRIGHTNESS); // Deep blue
-    } else if (is_macos) {
-        rgblight_sethsv_noeeprom(0, 0, LED_BRIGHTNESS);     // White
+#ifdef LED_COMPOSITOR
+    if (led_ready) {
+        os_flash_start();
     } else {
-        rgblight_sethsv_noeeprom(197, 255, LED_BRIGHTNESS); // Ubuntu purple (~280°)
+        os_flash_pending = true;  // FAST_BOOT: flash once LEDs are initialized
     }
-    defer_exec(800, os_flash_done_cb, NULL);
 #endif
-    return 0;
+    return true;
 }
 
 // ============================================================================
@@ -711,10 +694,11 @@ static uint32_t os_setup_wait_cb(uint32_t trigger_time, void *cb_arg) {
 layer_state_t layer_state_set_user(layer_state_t state) {
     // Tri-Layer: When SYM_R and NUM are both active, activate FKEY
     state = update_tri_layer_state(state, _SYM_R, _NUM, _FKEY);
+    telemetry_layers(state);
 
     // No custom ACL handling here (use QMK defaults)
 
-#ifdef RGBLIGHT_LAYERS
+#ifdef LED_COMPOSITOR
     apply_layer_color(state);
 #endif
 
@@ -731,48 +715,39 @@ layer_state_t layer_state_set_user(layer_state_t state) {
 // MAIN PROCESSING
 // ============================================================================
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-    // DEL_FKY hybrid:
-    // tap => start QMK Leader, hold => _CMD layer while held.
-    // While DEL is held, any other pressed key marks it as hold-use and
-    // immediately enables hold-color feedback.
-    if (del_fky_pressed && keycode != DEL_FKY && record->event.pressed) {
-        if (!del_fky_used_as_hold) {
-            del_fky_used_as_hold = true;
-            del_fky_hold_visual = true;
-            cancel_deferred_exec(del_fky_hold_visual_token);
-#ifdef RGBLIGHT_LAYERS
-            apply_layer_color(layer_state);
+bool HOT_FUNC(process_record_user)(uint16_t keycode, keyrecord_t *record) {
+    CYCLE_PROF_SCOPE(PROF_RECORD);
+#ifdef HRM_SPECULATE
+    hrm_speculate_resolve(keycode, record);
 #endif
-        }
+    if (record->event.pressed) {
+        boot_prof_mark(BOOT_PHASE_FIRST_KEY);
+    }
+    tap_adapt_observe(keycode, record);
+
+    // Any other press: DEL held turns into a hold (CMD color), BSPC repeat stops.
+    // Before every handler that may consume the key (umlauts on _CMD included).
+    if (keycode != DEL_FKY) {
+        hybrid_key_other(keycode, record);
     }
 
+    if (!CYCLE_PROF_CALL(PROF_AUTOCORRECT, process_autocorrect_ac(keycode, record))) {
+        return false;
+    }
+    if (!CYCLE_PROF_CALL(PROF_MOUSE, mouse_engine_process(keycode, record))) {
+        return false;
+    }
+    if (!unicode_out_process(keycode, record)) {
+        return false;
+    }
+
+    // DEL_FKY hybrid (hybrid_key_map.h): tap => start QMK Leader, hold => _CMD layer while held.
     if (keycode == DEL_FKY) {
         // If Leader is already active, pass DEL through so Leader can record DEL,DEL.
         if (leader_sequence_active()) {
             return true;
         }
-
-        if (record->event.pressed) {
-            del_fky_pressed = true;
-            del_fky_used_as_hold = false;
-            del_fky_hold_visual = false;
-            layer_on(_CMD);
-            cancel_deferred_exec(del_fky_hold_visual_token);
-            del_fky_hold_visual_token = defer_exec(DEL_HOLD_VISUAL_MS, del_fky_hold_visual_cb, NULL);
-        } else {
-            // DEL press may have been consumed by active Leader processing.
-            if (!del_fky_pressed) {
-                return false;
-            }
-            cancel_deferred_exec(del_fky_hold_visual_token);
-            del_fky_hold_visual = false;
-            layer_off(_CMD);
-            del_fky_pressed = false;
-            if (!del_fky_used_as_hold) {
-                leader_start();
-            }
-        }
+        hybrid_key_process(HK_DEL, record);
         return false;
     }
 
@@ -783,14 +758,17 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     }
 
     // HRM overlay handling: random color at 50 when HRM is held
-    int hrm_idx = hrm_index_for(keycode);
+    int hrm_idx = key_behavior_hrm(keycode, record);
     if (hrm_idx >= 0) {
         if (record->event.pressed) {
+            telemetry_hrm((uint8_t)hrm_idx, record->tap.count > 0);
+            hrm_mods_down |= hrm_mod_bits[hrm_idx];
             hrm_pressed[hrm_idx] = true;
             // schedule hold detection after approx tapping term
-            uint16_t delay = TAPPING_TERM + 35; // close to per-key config
+            uint16_t delay = key_behavior_term(keycode, record) + 5; // just past the key's (adaptive) term
             hrm_tokens[hrm_idx] = defer_exec(delay, hrm_hold_cb, (void *)(uintptr_t)hrm_idx);
         } else {
+            hrm_mods_down &= (uint8_t)~hrm_mod_bits[hrm_idx];
             cancel_deferred_exec(hrm_tokens[hrm_idx]);
             hrm_pressed[hrm_idx] = false;
             if (hrm_is_hold[hrm_idx]) {
@@ -848,7 +826,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 if (hrm_active_count == 0) {
                     uint8_t hue = (uint8_t)((timer_read() * 37u + 123u) & 0xFFu);
                     hrm_overlay_active = true;
-                    rgblight_sethsv_noeeprom(hue, 255, LED_BRIGHTNESS_HOMEROW);
+                    led_comp_set(LED_SRC_HRM, hue, 255, LED_BRIGHTNESS_HOMEROW);
                 }
                 // Count all newly-promoted HRMs
                 // We can't know exactly how many just now; recompute count:
@@ -863,43 +841,27 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         }
     }
 
-    if (keycode == HM_T) {
-        hm_t_pressed = record->event.pressed;
-    } else if (keycode == HM_N) {
-        hm_n_pressed = record->event.pressed;
-    } else if (keycode == HM_A) {
-        hm_a_pressed = record->event.pressed;
-    } else if (keycode == HM_O) {
-        hm_o_pressed = record->event.pressed;
-    } else if (keycode == HM_S) {
-        hm_s_pressed = record->event.pressed;
-    } else if (keycode == HM_E) {
-        hm_e_pressed = record->event.pressed;
-    }
-
     // BSP_NUM custom handling: only triple-tap+hold = Backspace repeat.
     // Otherwise, let LT(_NUM, KC_BSPC) handle tap/hold semantics.
     if (keycode == BSP_NUM) {
         uint8_t mods_now = get_mods();
-        bool shift_effective = ((mods_now & MOD_MASK_SHIFT) != 0) || hm_t_pressed || hm_n_pressed;
-        bool gui_effective = ((mods_now & (MOD_BIT(KC_LGUI) | MOD_BIT(KC_RGUI))) != 0) || hm_a_pressed || hm_o_pressed;
-        bool ctrl_effective = ((mods_now & MOD_MASK_CTRL) != 0) || hm_s_pressed || hm_e_pressed;
-        bool is_macos = (detected_host_os() == OS_MACOS || detected_host_os() == OS_IOS);
-        bool wordmod_effective = is_macos ? gui_effective : ctrl_effective;
+        uint8_t mods_effective = mods_now | hrm_mods_down;
+        bool shift_effective = (mods_effective & MOD_MASK_SHIFT) != 0;
+        bool wordmod_effective = (mods_effective & os_profile->word_mods) != 0;  // Cmd on macOS, Ctrl elsewhere
 
         if (record->event.pressed) {
             // Word-delete chords (OS-aware) take precedence
             if (wordmod_effective && shift_effective) {
                 uint8_t saved = get_mods();
                 clear_mods(); send_keyboard_report();
-                if (is_macos) tap_code16(LALT(KC_DEL)); else tap_code16(LCTL(KC_DEL));
+                tap_code16(os_profile->word_del);
                 set_mods(saved); send_keyboard_report();
                 return false;
             }
             if (wordmod_effective && !shift_effective) {
                 uint8_t saved = get_mods();
                 clear_mods(); send_keyboard_report();
-                if (is_macos) tap_code16(LALT(KC_BSPC)); else tap_code16(LCTL(KC_BSPC));
+                tap_code16(os_profile->word_bspc);
                 set_mods(saved); send_keyboard_report();
                 return false;
             }
@@ -912,24 +874,8 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 return false;
             }
 
-            // Triple-tap detection to start BSPC auto-repeat; otherwise let LT handle
-            bsp_pressed = true;
-            if (timer_elapsed(bsp_last_tap_time) < BSPC_TRIPLE_TERM_MS) {
-                bsp_tap_count++;
-            } else {
-                bsp_tap_count = 1;
-            }
-            bsp_last_tap_time = timer_read();
-
-			if (bsp_tap_count >= 3) {
-				bsp_triple_pending = true;
-				bsp_repeat_active = false;
-				cancel_deferred_exec(bsp_triple_hold_token);
-				bsp_triple_hold_token = defer_exec(BSPC_TRIPLE_HOLD_MS, bsp_triple_hold_cb, NULL);
-				return false; // warten auf Hold, kein sofortiger Repeat
-			}
-
-			return true; // LT(_NUM, KC_BSPC) macht Tap/Hold normal
+            // Triple-tap + hold = BSPC auto-repeat; otherwise LT(_NUM, KC_BSPC) taps/holds normally
+            return hybrid_key_process(HK_BSPC, record);
         } else { // release
             // Release delete-hold
             if (bsp_del_active) {
@@ -940,36 +886,13 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
                 bsp_del_active = false;
                 return false;
             }
-
-			if (bsp_triple_pending && !bsp_repeat_active) {
-				cancel_deferred_exec(bsp_triple_hold_token);
-				bsp_triple_pending = false;
-				bsp_tap_count = 0;
-				tap_code(KC_BSPC);
-
-				return false;
-            }
-
-            // Stop repeat if it was active
-            if (bsp_repeat_active) {
-                bsp_repeat_active = false;
-                cancel_deferred_exec(bsp_repeat_token);
-                bsp_tap_count = 0;
-                return false;
-            }
-            return true; // normal LT behavior
-        }
-    } else {
-        // Cancel repeat when other key is pressed
-        if (record->event.pressed && bsp_repeat_active) {
-            bsp_repeat_active = false;
-            cancel_deferred_exec(bsp_repeat_token);
+            return hybrid_key_process(HK_BSPC, record);
         }
     }
 
     // OS-aware App Switcher keys (toggle/step/last)
     if (keycode == APP_SW_TOG || keycode == APP_SW_TAB || keycode == APP_SW_PREV) {
-        uint16_t mod = app_sw_mod_for_os();
+        uint16_t mod = os_profile->app_sw_mod;
         switch (keycode) {
             case APP_SW_TOG:
                 if (record->event.pressed) {
@@ -1041,6 +964,7 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     static bool mbtn3_active = false;
     static deferred_token mbtn3_token = 0;
     uint32_t mbtn3_hold_cb(uint32_t t, void *arg) {
+        CYCLE_PROF_SCOPE(PROF_DEFER);
         (void)t; (void)arg;
         if (mbtn3_pressed && !mbtn3_active) {
             register_code(MS_BTN3);
@@ -1090,25 +1014,72 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         }
     }
 
-    // Let MS_ACL0/1/2 fall through to QMK default handling (momentary accel)
-
     return true;
 }
 
-// Initialize - enable rgblight and show OS flash briefly, then restore layer color
+// Earliest user hook: wear-leveling EEPROM is mounted, matrix pins set up
+void keyboard_pre_init_user(void) {
+    boot_prof_begin();
+    boot_prof_mark(BOOT_PHASE_PRE_INIT);
+    key_behavior_init();
+}
+
+#ifdef FAST_BOOT
+static uint32_t boot_deferred_init_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)trigger_time;
+    (void)cb_arg;
+#ifdef LED_COMPOSITOR
+    led_init();
+#endif
+    boot_prof_mark(BOOT_PHASE_DEFERRED_INIT);
+    return 0;
+}
+#endif
+
+// USB enumeration finished: with FAST_BOOT, run the deferred init after the
+// first report has had a chance to go out
+void notify_usb_device_state_change_user(struct usb_device_state usb_device_state) {
+    if (usb_device_state.configure_state != USB_DEVICE_STATE_CONFIGURED || boot_prof_reached(BOOT_PHASE_USB_CONFIGURED)) {
+        return;
+    }
+    boot_prof_mark(BOOT_PHASE_USB_CONFIGURED);
+#ifdef FAST_BOOT
+    defer_exec(FAST_BOOT_DEFER_MS, boot_deferred_init_cb, NULL);
+#endif
+}
+
+// Initialize - start the LEDs and show OS flash briefly, then restore layer color
 void keyboard_post_init_user(void) {
-#ifdef RGBLIGHT_LAYERS
-    rgblight_enable_noeeprom();
-    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
-    // Attach our layer segments to QMK's rgblight layering system
-    rgblight_layers = my_rgb_layers;
-    apply_layer_color(layer_state); // set to current layer (Base off)
+    boot_prof_mark(BOOT_PHASE_POST_INIT_BEGIN);
+    ee_cache_init();  // before any module reads its persisted state
+    tune_init();      // before modules that derive state from timing parameters
+    combo_index_init();
+#ifdef HRM_SPECULATE
+    hrm_speculate_init();
+#endif
+    autocorrect_ac_init();
+    ac_learn_init();
+    tap_adapt_init();
+    hybrid_key_init();
+    telemetry_init();
+#if defined(LED_COMPOSITOR) && !defined(FAST_BOOT)
+    led_init();
 #endif
-    // Configure OS-dependent behavior and (optionally) LED flash once OS is known
-    defer_exec(200, os_setup_wait_cb, NULL);
+    // Apply the last known host OS right away (correct before the first scan);
+    // detection confirms or corrects it in process_detected_host_os_user()
+    os_variant_t last_os = os_profile_remembered();
+    if (last_os != OS_UNSURE) {
+        os_apply(last_os);
+    }
+    boot_prof_mark(BOOT_PHASE_POST_INIT_END);
 }
 
-// Matrix scan - keep empty (no LED work here)
+// Matrix scan - no LED work here; only the one-shot boot stamp (single compare after boot)
 void matrix_scan_user(void) {
-    // Intentionally empty to avoid frequent LED updates
+    boot_prof_mark(BOOT_PHASE_FIRST_SCAN);
+}
+
+void housekeeping_task_user(void) {
+    out_queue_task();
 }
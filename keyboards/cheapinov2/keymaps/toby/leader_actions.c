@@ -1,58 +1,110 @@
-// Copyright 2024
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
 // Leader actions: OS-aware window management and common shortcuts
 
 #include QMK_KEYBOARD_H
 #include "leader_actions.h"
-#include "os_detection.h"
+#include "os_profile.h"
 #include "keyboards/cheapinov2/keymaps/toby/config.h"
 #include "toby_keycodes.h"
 #include "leader_map.h"
+#include "telemetry.h"
+#include "string_out.h"
 
-// Helpers to expand a declarative map into imperative checks
-#define APPLY_LEADER1(K1, ACT_LNX, ACT_MAC, ACT_WIN) \
-    if (leader_sequence_one_key(K1)) { \
-        os_variant_t _os = detected_host_os(); \
-        if (_os == OS_MACOS || _os == OS_IOS) tap_code16(ACT_MAC); \
-        else if (_os == OS_WINDOWS) tap_code16(ACT_WIN); \
-        else tap_code16(ACT_LNX); \
-    }
-
-#define APPLY_LEADER2(K1, K2, ACT_LNX, ACT_MAC, ACT_WIN) \
-    if (leader_sequence_two_keys(K1, K2)) { \
-        os_variant_t _os = detected_host_os(); \
-        if (_os == OS_MACOS || _os == OS_IOS) tap_code16(ACT_MAC); \
-        else if (_os == OS_WINDOWS) tap_code16(ACT_WIN); \
-        else tap_code16(ACT_LNX); \
-    }
+// Longest sequence the map can declare (LEADER3)
+#define LEADER_MAX_KEYS 3
 
-#define APPLY_LEADER3(K1, K2, K3, ACT_LNX, ACT_MAC, ACT_WIN) \
-    if (leader_sequence_three_keys(K1, K2, K3)) { \
-        os_variant_t _os = detected_host_os(); \
-        if (_os == OS_MACOS || _os == OS_IOS) tap_code16(ACT_MAC); \
-        else if (_os == OS_WINDOWS) tap_code16(ACT_WIN); \
-        else tap_code16(ACT_LNX); \
-    }
+// One flattened map entry; unused key slots are KC_NO
+typedef struct {
+    uint16_t keys[LEADER_MAX_KEYS];
+    uint8_t  len;
+    uint16_t acts[LEADER_COL_COUNT];  // indexed by os_profile->leader_col
+    const char *text;                 // LEADER_STR*: typed instead of acts
+} leader_entry_t;
 
-void leader_handle_sequences(bool is_macos) {
-    (void)is_macos;
-    // One-key sequences
+// Expand the declarative map into a flat table (1-, 2- and 3-key entries)
+static const leader_entry_t leader_entries[] = {
 #ifdef LEADER_MAP_1KEY
-#define LEADER1(K1, ACT_LNX, ACT_MAC, ACT_WIN) APPLY_LEADER1(K1, ACT_LNX, ACT_MAC, ACT_WIN)
+#define LEADER1(K1, ACT_LNX, ACT_MAC, ACT_WIN) {{K1, KC_NO, KC_NO}, 1, {ACT_LNX, ACT_MAC, ACT_WIN}, NULL},
+#define LEADER_STR1(K1, TEXT) {{K1, KC_NO, KC_NO}, 1, {KC_NO, KC_NO, KC_NO}, TEXT},
     LEADER_MAP_1KEY
 #undef LEADER1
+#undef LEADER_STR1
 #endif
-
-    // Two-key sequences
 #ifdef LEADER_MAP_2KEY
-#define LEADER2(K1, K2, ACT_LNX, ACT_MAC, ACT_WIN) APPLY_LEADER2(K1, K2, ACT_LNX, ACT_MAC, ACT_WIN)
+#define LEADER2(K1, K2, ACT_LNX, ACT_MAC, ACT_WIN) {{K1, K2, KC_NO}, 2, {ACT_LNX, ACT_MAC, ACT_WIN}, NULL},
+#define LEADER_STR2(K1, K2, TEXT) {{K1, K2, KC_NO}, 2, {KC_NO, KC_NO, KC_NO}, TEXT},
     LEADER_MAP_2KEY
 #undef LEADER2
+#undef LEADER_STR2
 #endif
-
-    // Three-key sequences
 #ifdef LEADER_MAP_3KEY
-#define LEADER3(K1, K2, K3, ACT_LNX, ACT_MAC, ACT_WIN) APPLY_LEADER3(K1, K2, K3, ACT_LNX, ACT_MAC, ACT_WIN)
+#define LEADER3(K1, K2, K3, ACT_LNX, ACT_MAC, ACT_WIN) {{K1, K2, K3}, 3, {ACT_LNX, ACT_MAC, ACT_WIN}, NULL},
+#define LEADER_STR3(K1, K2, K3, TEXT) {{K1, K2, K3}, 3, {KC_NO, KC_NO, KC_NO}, TEXT},
     LEADER_MAP_3KEY
 #undef LEADER3
+#undef LEADER_STR3
 #endif
+};
+
+#define LEADER_ENTRY_COUNT (sizeof(leader_entries) / sizeof(leader_entries[0]))
+
+// Keys typed since leader_start() and the number of entries they still match
+static uint16_t leader_typed[LEADER_MAX_KEYS];
+static uint8_t  leader_typed_len = 0;
+static uint8_t  leader_candidates = LEADER_ENTRY_COUNT;
+
+void leader_prefix_reset(void) {
+    leader_typed_len  = 0;
+    leader_candidates = LEADER_ENTRY_COUNT;
+}
+
+leader_match_t leader_prefix_add(uint16_t keycode) {
+    if (leader_typed_len >= LEADER_MAX_KEYS) {
+        leader_candidates = 0;
+        return LEADER_MATCH_NONE;
+    }
+    leader_typed[leader_typed_len++] = keycode;
+
+    // Entries that still start with the typed keys; remember whether one is complete
+    uint8_t candidates = 0;
+    bool    exact      = false;
+    for (uint8_t i = 0; i < LEADER_ENTRY_COUNT; i++) {
+        const leader_entry_t *e = &leader_entries[i];
+        if (e->len < leader_typed_len) continue;
+        if (memcmp(e->keys, leader_typed, leader_typed_len * sizeof(uint16_t)) != 0) continue;
+        candidates++;
+        if (e->len == leader_typed_len) exact = true;
+    }
+    leader_candidates = candidates;
+
+    if (candidates == 0) return LEADER_MATCH_NONE;
+    // A complete entry that is also a prefix of a longer one waits for the timeout
+    if (exact && candidates == 1) return LEADER_MATCH_UNIQUE;
+    if (leader_typed_len >= LEADER_MAX_KEYS) return exact ? LEADER_MATCH_UNIQUE : LEADER_MATCH_NONE;
+    return LEADER_MATCH_PARTIAL;
+}
+
+uint8_t leader_prefix_candidates(void) {
+    return leader_candidates;
+}
+
+uint8_t leader_entry_count(void) {
+    return LEADER_ENTRY_COUNT;
+}
+
+void leader_handle_sequences(void) {
+    for (uint8_t i = 0; i < LEADER_ENTRY_COUNT; i++) {
+        const leader_entry_t *e = &leader_entries[i];
+        if (e->len != leader_typed_len) continue;
+        if (memcmp(e->keys, leader_typed, leader_typed_len * sizeof(uint16_t)) != 0) continue;
+        telemetry_leader(i);
+        if (e->text) {
+            string_out(e->text);
+        } else {
+            tap_code16(e->acts[os_profile->leader_col]);
+        }
+        return;
+    }
 }
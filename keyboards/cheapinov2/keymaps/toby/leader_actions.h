@@ -4,7 +4,25 @@
 #pragma once
 #include QMK_KEYBOARD_H
 
-// Handle all Leader sequences. Must be called from leader_end_user().
-// Pass true for macOS (Cmd/Rectangle), false for Linux (GNOME).
-void leader_handle_sequences(bool is_macos);
+// Prefix match state of the keys typed so far against leader_map.h
+typedef enum {
+    LEADER_MATCH_NONE,     // no entry starts with the typed keys: abort now
+    LEADER_MATCH_PARTIAL,  // more keys (or the timeout) still needed
+    LEADER_MATCH_UNIQUE,   // exactly one entry left and fully typed: fire now
+} leader_match_t;
+
+// Start a new sequence. Call from leader_start_user().
+void leader_prefix_reset(void);
+
+// Record one leader key (tap keycode as passed to leader_add_user()) and narrow candidates.
+leader_match_t leader_prefix_add(uint16_t keycode);
 
+// Number of map entries still matching the typed prefix (all entries right after start).
+uint8_t leader_prefix_candidates(void);
+
+// Total number of entries in leader_map.h.
+uint8_t leader_entry_count(void);
+
+// Handle all Leader sequences. Must be called from leader_end_user().
+// The action column comes from the active OS profile (os_profile.h).
+void leader_handle_sequences(void);
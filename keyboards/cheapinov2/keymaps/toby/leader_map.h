@@ -4,6 +4,7 @@
 //   LEADER1(K1,               LINUX_ACTION,           MAC_ACTION, WIN_ACTION)  // comment
 //   LEADER2(K1, K2,           LINUX_ACTION,           MAC_ACTION, WIN_ACTION)  // comment
 //   LEADER3(K1, K2, K3,       LINUX_ACTION,           MAC_ACTION, WIN_ACTION)  // comment
+//   LEADER_STR1/2/3(K1, ..., "text")                 // types text on every OS (string_out.h)
 // Use tap_code16-compatible actions (e.g., KC_*, LCTL(KC_X), LGUI(KC_SPC), MAC_WIN_MAXIMIZE, ...)
 
 #pragma once
@@ -52,5 +53,5 @@ LEADER2(KC_F, KC_B,              LALT(KC_LEFT),         LGUI(KC_LBRC),         L
 
 // Three-key sequences (optional)
 #define LEADER_MAP_3KEY \
-/* Example: Leader + G + I + T to send 'git status' (add if wanted) */ \
-/* LEADER3(KC_G, KC_I, KC_T,     SEND_STRING("git status\n"), SEND_STRING("git status\n"), SEND_STRING("git status\n")) */
+/* Snippets: typed as packed NKRO reports */ \
+LEADER_STR3(KC_G, KC_I, KC_T,    "git status\n")
@@ -0,0 +1,101 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// LED compositor: priority stack of slots, one composed color per frame, push on change.
+
+#include QMK_KEYBOARD_H
+#include "color.h"
+#include "ws2812.h"
+#include "led_comp.h"
+#include "cycle_prof.h"
+#include "boot_profile.h"
+#include "toby_hid.h"
+
+static hsv_t          led_slot[LED_SRC_COUNT];
+static uint8_t        led_active = 0;  // bit per slot
+static rgb_t          led_shown;
+static bool           led_shown_valid = false;
+static bool           led_ready       = false;
+static uint16_t       led_last_frame  = 0;
+static deferred_token led_token       = INVALID_DEFERRED_TOKEN;
+
+static struct {
+    uint32_t updates;
+    uint32_t pushed;
+    uint32_t skipped;
+    uint32_t push_max_us;
+} led_stats;
+
+// Compose the stack (lowest set bit = highest priority) and push if it changed
+static void led_comp_frame(void) {
+    hsv_t hsv = {0, 0, 0};
+    if (led_active) hsv = led_slot[__builtin_ctz(led_active)];
+#ifdef RGBLIGHT_LIMIT_VAL
+    if (hsv.v > RGBLIGHT_LIMIT_VAL) hsv.v = RGBLIGHT_LIMIT_VAL;
+#endif
+    rgb_t rgb = hsv.v ? hsv_to_rgb(hsv) : (rgb_t){0, 0, 0};
+    led_last_frame = timer_read();
+    if (led_shown_valid && rgb.r == led_shown.r && rgb.g == led_shown.g && rgb.b == led_shown.b) {
+        led_stats.skipped++;
+        return;
+    }
+    uint32_t t0 = boot_prof_us();
+    CYCLE_PROF_BEGIN(PROF_LED);
+    ws2812_set_color_all(rgb.r, rgb.g, rgb.b);
+    ws2812_flush();
+    CYCLE_PROF_END(PROF_LED);
+    uint32_t us = boot_prof_us() - t0;
+    if (us > led_stats.push_max_us) led_stats.push_max_us = us;
+    led_shown       = rgb;
+    led_shown_valid = true;
+    led_stats.pushed++;
+}
+
+static uint32_t led_comp_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)trigger_time;
+    (void)cb_arg;
+    led_token = INVALID_DEFERRED_TOKEN;
+    led_comp_frame();
+    return 0;
+}
+
+// One pending frame at a time; it picks up every change made before it runs
+static void led_comp_schedule(void) {
+    led_stats.updates++;
+    if (!led_ready || led_token != INVALID_DEFERRED_TOKEN) return;
+    uint16_t since = timer_elapsed(led_last_frame);
+    led_token      = defer_exec(since >= LED_COMP_FRAME_MS ? 1 : LED_COMP_FRAME_MS - since, led_comp_cb, NULL);
+}
+
+void led_comp_init(void) {
+    ws2812_init();
+    led_ready      = true;
+    led_last_frame = timer_read() - LED_COMP_FRAME_MS;
+    led_comp_frame();
+}
+
+void led_comp_set(led_src_t src, uint8_t hue, uint8_t sat, uint8_t val) {
+    hsv_t *s = &led_slot[src];
+    if ((led_active & (1u << src)) && s->h == hue && s->s == sat && s->v == val) return;
+    *s = (hsv_t){hue, sat, val};
+    led_active |= 1u << src;
+    led_comp_schedule();
+}
+
+void led_comp_clear(led_src_t src) {
+    if (!(led_active & (1u << src))) return;
+    led_active &= ~(1u << src);
+    led_comp_schedule();
+}
+
+void led_comp_hid(uint8_t *data, uint8_t length) {
+    bool reset = data[1] == 1;
+    memset(&data[1], 0, length - 1);
+    toby_hid_put_u32(&data[4], led_stats.updates);
+    toby_hid_put_u32(&data[8], led_stats.pushed);
+    toby_hid_put_u32(&data[12], led_stats.skipped);
+    toby_hid_put_u32(&data[16], led_stats.push_max_us);
+    data[20] = led_active;
+    if (reset) memset(&led_stats, 0, sizeof(led_stats));
+}
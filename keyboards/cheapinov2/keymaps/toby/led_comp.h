@@ -0,0 +1,38 @@
+// LED compositor for Cheapino keymap (toby)
+// Each feedback source owns one slot in a fixed priority stack; the highest
+// active slot is the LED color. Setting a slot only stores the color and
+// schedules a frame, so it costs a few stores on the key path. Frames run
+// from a deferred callback at most every LED_COMP_FRAME_MS: the stack is
+// composed once, and the WS2812 is written only when the color changed
+// (the RP2040 vendor driver hands the frame to PIO1 by DMA). Frames pushed
+// vs skipped over raw HID: TOBY_HID_LED_STATS (tools/toby_hid.py leds).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Slots, highest priority first
+typedef enum {
+    LED_SRC_LEADER,    // leader sequence running (tinted as candidates narrow)
+    LED_SRC_HRM,       // home-row modifier held
+    LED_SRC_CMD,       // DEL_FKY held as command layer
+    LED_SRC_LAYER,     // non-base layer (or the base typing-streak tint)
+    LED_SRC_OS_FLASH,  // detected-OS flash
+    LED_SRC_COUNT,
+} led_src_t;
+
+// Frame budget: minimum time between two frames (ms)
+#ifndef LED_COMP_FRAME_MS
+#define LED_COMP_FRAME_MS 16
+#endif
+
+// Start the driver and show the current stack. Before this, slots are only recorded.
+void led_comp_init(void);
+
+// Set / clear a slot. Unchanged values do not schedule a frame.
+void led_comp_set(led_src_t src, uint8_t hue, uint8_t sat, uint8_t val);
+void led_comp_clear(led_src_t src);
+
+// TOBY_HID_LED_STATS. Request: data[1] = 1 to reset counters after reading.
+// Reply: u32 LE slot updates [4], frames pushed [8], frames skipped
+// (color unchanged) [12], longest push µs [16]; [20] active slot mask.
+void led_comp_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,164 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Mouse-key motion in 16.16 fixed point at the poll rate, with sub-pixel carry.
+
+#include QMK_KEYBOARD_H
+#include "mousekey.h"
+#include "mouse_engine.h"
+#include "cycle_prof.h"
+#include "tune.h"
+#include "os_profile.h"
+
+// Wheel counts per detent: hi-res only where the host enables the multiplier
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    define WHEEL_COUNTS (os_profile->wheel_hires ? POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER : 1)
+#else
+#    define WHEEL_COUNTS 1
+#endif
+
+#define FP_ONE 65536
+
+enum {
+    MS_BIT_UP    = 1 << 0,
+    MS_BIT_DOWN  = 1 << 1,
+    MS_BIT_LEFT  = 1 << 2,
+    MS_BIT_RIGHT = 1 << 3,
+    MS_BIT_WH_U  = 1 << 4,
+    MS_BIT_WH_D  = 1 << 5,
+    MS_BIT_WH_L  = 1 << 6,
+    MS_BIT_WH_R  = 1 << 7,
+    MS_BIT_MOVE  = 0x0F,
+    MS_BIT_WHEEL = 0xF0,
+};
+
+static uint8_t        ms_held    = 0;  // MS_BIT_*
+static uint8_t        ms_acl     = 0;  // bit per held MS_ACLn
+static uint16_t       move_start = 0;  // first direction press of this motion
+static uint16_t       wheel_start = 0;
+static uint16_t       last_tick  = 0;
+static uint32_t       speed      = 0;  // px/s, kept while coasting
+static uint32_t       coast_from = 0;  // speed when the last direction key went up
+static int8_t         dir_x = 0, dir_y = 0;
+static int32_t        acc_x = 0, acc_y = 0, acc_v = 0, acc_h = 0;  // 16.16 remainders
+static deferred_token ms_token   = INVALID_DEFERRED_TOKEN;
+
+// Ease-in ramp from BASE to MAX over RAMP ms
+static inline uint32_t ramp(uint32_t base, uint32_t max, uint32_t ramp_ms, uint32_t t) {
+    if (t >= ramp_ms || max <= base) return max;
+    return base + (max - base) * t / ramp_ms * t / ramp_ms;
+}
+
+static inline uint32_t apply_acl(uint32_t v) {
+    if (!ms_acl) return v;
+    return v * (ms_acl & 1 ? tune.acl0_pct : ms_acl & 2 ? tune.acl1_pct : tune.acl2_pct) / 100;
+}
+
+// Integrate RATE (units/s) over DT ms into a 16.16 accumulator; return whole units
+static inline int16_t integrate(int32_t *acc, int8_t dir, uint32_t rate_fp_ms, uint16_t dt) {
+    if (!dir) return 0;
+    *acc += dir * (int32_t)(rate_fp_ms * dt);
+    int32_t whole = *acc / FP_ONE;  // toward zero: remainder keeps its sign
+    *acc -= whole * FP_ONE;
+    return (int16_t)whole;
+}
+
+static inline int8_t clamp8(int16_t v) {
+    return v > 127 ? 127 : v < -127 ? -127 : (int8_t)v;
+}
+
+static uint32_t mouse_engine_tick(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    (void)trigger_time;
+    (void)cb_arg;
+    uint16_t now = timer_read();
+    uint16_t dt  = timer_elapsed(last_tick);
+    last_tick    = now;
+    if (!dt) return MOUSE_ENGINE_TICK_MS;
+
+    if (ms_held & MS_BIT_MOVE) {
+        dir_x = (ms_held & MS_BIT_RIGHT ? 1 : 0) - (ms_held & MS_BIT_LEFT ? 1 : 0);
+        dir_y = (ms_held & MS_BIT_DOWN ? 1 : 0) - (ms_held & MS_BIT_UP ? 1 : 0);
+        speed = ramp(tune.mouse_base_speed, tune.mouse_max_speed, tune.mouse_time_to_max, timer_elapsed(move_start));
+    } else if (speed) {
+        uint32_t step = tune.mouse_decay ? coast_from * dt / tune.mouse_decay + 1 : speed;
+        speed         = speed > step ? speed - step : 0;
+    }
+
+    int8_t x = 0, y = 0, v = 0, h = 0;
+    if (speed) {
+        uint32_t rate = (apply_acl(speed) << 16) / 1000;  // px/ms, 16.16
+        if (dir_x && dir_y) rate = rate * 181 / 256;      // diagonal: same speed, not sqrt(2) faster
+        x = clamp8(integrate(&acc_x, dir_x, rate, dt));
+        y = clamp8(integrate(&acc_y, dir_y, rate, dt));
+    } else {
+        acc_x = acc_y = 0;
+    }
+    if (ms_held & MS_BIT_WHEEL) {
+        uint32_t detents = ramp(tune.wheel_base, tune.wheel_max, tune.wheel_time_to_max, timer_elapsed(wheel_start));
+        uint32_t rate    = (apply_acl(detents) * (uint32_t)WHEEL_COUNTS << 16) / 1000;
+        v = clamp8(integrate(&acc_v, (ms_held & MS_BIT_WH_U ? 1 : 0) - (ms_held & MS_BIT_WH_D ? 1 : 0), rate, dt));
+        h = clamp8(integrate(&acc_h, (ms_held & MS_BIT_WH_R ? 1 : 0) - (ms_held & MS_BIT_WH_L ? 1 : 0), rate, dt));
+    }
+
+    if (x || y || v || h) {
+        report_mouse_t report = mousekey_get_report();  // keeps QMK's button state
+        report.x = x;
+        report.y = y;
+        report.v = v;
+        report.h = h;
+        host_mouse_send(&report);
+    }
+    if (!ms_held && !speed) {
+        ms_token = INVALID_DEFERRED_TOKEN;
+        return 0;
+    }
+    return MOUSE_ENGINE_TICK_MS;
+}
+
+static uint8_t mouse_engine_bit(uint16_t keycode) {
+    switch (keycode) {
+        case MS_UP:   return MS_BIT_UP;
+        case MS_DOWN: return MS_BIT_DOWN;
+        case MS_LEFT: return MS_BIT_LEFT;
+        case MS_RGHT: return MS_BIT_RIGHT;
+        case MS_WHLU: return MS_BIT_WH_U;
+        case MS_WHLD: return MS_BIT_WH_D;
+        case MS_WHLL: return MS_BIT_WH_L;
+        case MS_WHLR: return MS_BIT_WH_R;
+        default:      return 0;
+    }
+}
+
+bool mouse_engine_process(uint16_t keycode, keyrecord_t *record) {
+    bool pressed = record->event.pressed;
+    if (keycode >= MS_ACL0 && keycode <= MS_ACL2) {
+        uint8_t bit = 1u << (keycode - MS_ACL0);
+        ms_acl      = pressed ? (ms_acl | bit) : (ms_acl & ~bit);
+        return false;
+    }
+    uint8_t bit = mouse_engine_bit(keycode);
+    if (!bit) return true;
+
+    if (pressed) {
+        if ((bit & MS_BIT_MOVE) && !(ms_held & MS_BIT_MOVE)) {
+            // A new motion picks up a coasting cursor where it is, not at base
+            uint32_t t = 0;
+            while (t < tune.mouse_time_to_max && ramp(tune.mouse_base_speed, tune.mouse_max_speed, tune.mouse_time_to_max, t) < speed) t += 10;
+            move_start = timer_read() - (uint16_t)t;
+        }
+        if ((bit & MS_BIT_WHEEL) && !(ms_held & MS_BIT_WHEEL)) {
+            wheel_start = timer_read();
+            acc_v = acc_h = 0;
+        }
+        ms_held |= bit;
+    } else {
+        ms_held &= ~bit;
+        if ((bit & MS_BIT_MOVE) && !(ms_held & MS_BIT_MOVE)) coast_from = speed;
+    }
+    if (ms_token == INVALID_DEFERRED_TOKEN && ms_held) {
+        last_tick = timer_read();
+        ms_token  = defer_exec(MOUSE_ENGINE_TICK_MS, mouse_engine_tick, NULL);
+    }
+    return false;
+}
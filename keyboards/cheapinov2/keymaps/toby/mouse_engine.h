@@ -0,0 +1,64 @@
+// Kinetic mouse-key engine for Cheapino keymap (toby)
+// Replaces QMK's mouse-key motion for MS_UP/DOWN/LEFT/RGHT, the four wheel
+// keys and MS_ACL0/1/2 (buttons stay with QMK). While any of them is active a
+// deferred tick runs every MOUSE_ENGINE_TICK_MS (the USB poll interval):
+// speed ramps from base to max over TIME_TO_MAX (ease-in), velocity is
+// integrated in 16.16 fixed point and the sub-pixel remainder is carried to
+// the next tick, so slow motion is smooth instead of whole steps every 16 ms.
+// MS_ACL0/1/2 are momentary speed multipliers (percent, below). Releasing
+// all direction keys coasts to a stop over MOUSE_ENGINE_DECAY_MS.
+// The wheel is integrated the same way in hi-res units: with
+// POINTING_DEVICE_HIRES_SCROLL_ENABLE the descriptor advertises the HID
+// resolution multiplier and one detent is POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+// counts on hosts that set it (os_profile->wheel_hires), 1 count elsewhere.
+// Speeds, ramps and multipliers below are defaults: the engine reads them
+// from `tune` (tune_params.h), adjustable at runtime.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Tick period (ms); 1 = every USB poll at the default 1 kHz
+#ifndef MOUSE_ENGINE_TICK_MS
+#define MOUSE_ENGINE_TICK_MS 1
+#endif
+
+// Cursor speed (px/s): on press, at full ramp, and ramp time (ms)
+#ifndef MOUSE_ENGINE_BASE_SPEED
+#define MOUSE_ENGINE_BASE_SPEED 400
+#endif
+#ifndef MOUSE_ENGINE_MAX_SPEED
+#define MOUSE_ENGINE_MAX_SPEED 1500
+#endif
+#ifndef MOUSE_ENGINE_TIME_TO_MAX
+#define MOUSE_ENGINE_TIME_TO_MAX 600
+#endif
+
+// Coast from the current speed to 0 after the last direction key is released (ms; 0 = stop)
+#ifndef MOUSE_ENGINE_DECAY_MS
+#define MOUSE_ENGINE_DECAY_MS 80
+#endif
+
+// Wheel speed (detents/s): on press, at full ramp, and ramp time (ms)
+#ifndef MOUSE_ENGINE_WHEEL_BASE
+#define MOUSE_ENGINE_WHEEL_BASE 8
+#endif
+#ifndef MOUSE_ENGINE_WHEEL_MAX
+#define MOUSE_ENGINE_WHEEL_MAX 30
+#endif
+#ifndef MOUSE_ENGINE_WHEEL_TIME_TO_MAX
+#define MOUSE_ENGINE_WHEEL_TIME_TO_MAX 1200
+#endif
+
+// Momentary multipliers while MS_ACL0/1/2 is held (percent; lowest held index wins)
+#ifndef MOUSE_ENGINE_ACL0_PCT
+#define MOUSE_ENGINE_ACL0_PCT 25
+#endif
+#ifndef MOUSE_ENGINE_ACL1_PCT
+#define MOUSE_ENGINE_ACL1_PCT 50
+#endif
+#ifndef MOUSE_ENGINE_ACL2_PCT
+#define MOUSE_ENGINE_ACL2_PCT 200
+#endif
+
+// Call from process_record_user(); false = motion/wheel/ACL key handled here.
+bool mouse_engine_process(uint16_t keycode, keyrecord_t *record);
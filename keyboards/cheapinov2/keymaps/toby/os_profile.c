@@ -0,0 +1,117 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-OS action profiles: built at compile time, swapped by a single pointer store.
+
+#include QMK_KEYBOARD_H
+#include "os_profile.h"
+#include "eeconfig.h"
+
+// Marks the EEPROM user word as written by os_profile_remember()
+#define OS_PROFILE_MAGIC 0xC5
+
+// Layout of the EEPROM user word (eeconfig_read_user/eeconfig_update_user)
+typedef union {
+    uint32_t raw;
+    struct {
+        uint8_t  magic;      // OS_PROFILE_MAGIC once a host was detected
+        uint8_t  host_os;    // os_variant_t of the last detected host
+        uint16_t reserved;
+    };
+} os_profile_eeprom_t;
+
+enum { OS_PROFILE_LNX, OS_PROFILE_MAC, OS_PROFILE_WIN, OS_PROFILE_COUNT };
+
+static const os_profile_t os_profiles[OS_PROFILE_COUNT] = {
+    [OS_PROFILE_LNX] = {
+        .word_mods       = MOD_MASK_CTRL,
+        .word_bspc       = LCTL(KC_BSPC),
+        .word_del        = LCTL(KC_DEL),
+        .shortcut_mod    = KC_LCTL,
+        .cmd_copy        = C(S(KC_C)),       // Ctrl+Shift+C (terminal-first)
+        .cmd_paste       = C(S(KC_V)),       // Ctrl+Shift+V (terminal-first)
+        .app_sw_mod      = LINUX_APP_SWITCH_MOD,
+        .win_cycle_mod   = KC_LALT,          // Alt + `
+        .win_cycle_key   = KC_GRV,
+        .win_cycle_shift = true,
+        .leader_col      = LEADER_COL_LNX,
+        .unicode_path    = LINUX_UNICODE_PATH,
+        .compose_key     = LINUX_COMPOSE_KEY,
+        .swap_ctl_gui    = false,
+        .string_pack     = true,             // hid-input walks the NKRO bitmap in usage order
+        .wheel_hires     = true,             // hid-input sets it (Linux 5.0+)
+        .flash_hue       = 197,              // Ubuntu purple (~280°)
+        .flash_sat       = 255,
+    },
+    [OS_PROFILE_MAC] = {
+        .word_mods       = MOD_MASK_GUI,
+        .word_bspc       = LALT(KC_BSPC),    // Option+Backspace
+        .word_del        = LALT(KC_DEL),     // Option+Delete
+        .shortcut_mod    = KC_LGUI,
+        .cmd_copy        = LGUI(KC_C),       // Cmd+C
+        .cmd_paste       = LGUI(KC_V),       // Cmd+V
+        .app_sw_mod      = KC_LGUI,          // Cmd
+        .win_cycle_mod   = KC_LGUI,          // Cmd + `
+        .win_cycle_key   = KC_GRV,
+        .win_cycle_shift = true,
+        .leader_col      = LEADER_COL_MAC,
+        .unicode_path    = UNI_PATH_OPTION,  // Option+U, A (ABC / U.S. layout)
+        .compose_key     = KC_NO,
+        .swap_ctl_gui    = true,
+        .string_pack     = false,            // report order not established: one key per report
+        .wheel_hires     = false,            // never set: each count is a full detent
+        .flash_hue       = 0,                // White
+        .flash_sat       = 0,
+    },
+    [OS_PROFILE_WIN] = {
+        .word_mods       = MOD_MASK_CTRL,
+        .word_bspc       = LCTL(KC_BSPC),
+        .word_del        = LCTL(KC_DEL),
+        .shortcut_mod    = KC_LCTL,
+        .cmd_copy        = C(S(KC_C)),
+        .cmd_paste       = C(S(KC_V)),
+        .app_sw_mod      = KC_LALT,          // Alt
+        // Windows: kein natives same-app cycling → Alt+Esc als globaler Fallback
+        .win_cycle_mod   = KC_LALT,
+        .win_cycle_key   = KC_ESC,
+        .win_cycle_shift = false,
+        .leader_col      = LEADER_COL_WIN,
+        .unicode_path    = WIN_UNICODE_PATH,
+        .compose_key     = WIN_COMPOSE_KEY,
+        .swap_ctl_gui    = false,
+        .string_pack     = false,
+        .wheel_hires     = true,
+        .flash_hue       = 170,              // Deep blue (BSOD)
+        .flash_sat       = 255,
+    },
+};
+
+const os_profile_t *os_profile = &os_profiles[OS_PROFILE_LNX];
+
+void os_profile_select(os_variant_t os) {
+    switch (os) {
+        case OS_MACOS:
+        case OS_IOS:     os_profile = &os_profiles[OS_PROFILE_MAC]; break;
+        case OS_WINDOWS: os_profile = &os_profiles[OS_PROFILE_WIN]; break;
+        default:         os_profile = &os_profiles[OS_PROFILE_LNX]; break;
+    }
+}
+
+static os_profile_eeprom_t os_eeprom;
+static bool os_eeprom_loaded = false;
+
+os_variant_t os_profile_remembered(void) {
+    if (!os_eeprom_loaded) {
+        os_eeprom.raw    = eeconfig_read_user();
+        os_eeprom_loaded = true;
+    }
+    if (os_eeprom.magic != OS_PROFILE_MAGIC) return OS_UNSURE;
+    return (os_variant_t)os_eeprom.host_os;
+}
+
+void os_profile_remember(os_variant_t os) {
+    if (os == OS_UNSURE || os == os_profile_remembered()) return;
+    os_eeprom.magic   = OS_PROFILE_MAGIC;
+    os_eeprom.host_os = (uint8_t)os;
+    eeconfig_update_user(os_eeprom.raw);
+}
@@ -0,0 +1,50 @@
+// OS profile for Cheapino keymap (toby)
+// All OS-dependent modifiers/keycodes in one const struct per host OS.
+// Selected once when OS detection settles; handlers read through os_profile.
+
+#pragma once
+#include QMK_KEYBOARD_H
+#include "os_detection.h"
+#include "unicode_out.h"
+
+// Leader action column in leader_map.h (LINUX_ACTION, MAC_ACTION, WIN_ACTION)
+enum { LEADER_COL_LNX, LEADER_COL_MAC, LEADER_COL_WIN, LEADER_COL_COUNT };
+
+typedef struct {
+    // Word delete (BSPC chords)
+    uint8_t  word_mods;          // mod bits that turn BSPC into word delete
+    uint16_t word_bspc;          // word delete backwards
+    uint16_t word_del;           // word delete forwards
+    // Copy/paste
+    uint8_t  shortcut_mod;       // combo copy/paste/cut modifier (Ctrl/Cmd)
+    uint16_t cmd_copy;           // CMD layer copy (terminal-first)
+    uint16_t cmd_paste;          // CMD layer paste (terminal-first)
+    // App switcher and same-app window cycling
+    uint8_t  app_sw_mod;
+    uint8_t  win_cycle_mod;
+    uint8_t  win_cycle_key;
+    bool     win_cycle_shift;    // reverse direction via Shift
+    // Leader
+    uint8_t  leader_col;         // LEADER_COL_*
+    // Unicode (umlauts)
+    uint8_t  unicode_path;       // UNI_PATH_*
+    uint16_t compose_key;        // for UNI_PATH_COMPOSE
+    // Host setup
+    bool     swap_ctl_gui;       // keymap_config.swap_[lr]ctl_[lr]gui
+    bool     string_pack;        // several string keys per NKRO report (host reads them lowest usage first)
+    bool     wheel_hires;        // host sets the HID resolution multiplier (hi-res wheel counts)
+    uint8_t  flash_hue;          // boot LED flash color
+    uint8_t  flash_sat;
+} os_profile_t;
+
+// Active profile; Linux semantics until OS detection settles.
+extern const os_profile_t *os_profile;
+
+// Swap the active profile for the detected host OS (OS_UNSURE keeps Linux).
+void os_profile_select(os_variant_t os);
+
+// Last detected host OS persisted in the EEPROM user word (OS_UNSURE if none).
+os_variant_t os_profile_remembered(void);
+
+// Persist the detected host OS; only writes when it differs from the stored one.
+void os_profile_remember(os_variant_t os);
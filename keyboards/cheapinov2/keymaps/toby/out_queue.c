@@ -0,0 +1,198 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Output queue: ring of key steps, one keyboard report per USB frame.
+
+#include QMK_KEYBOARD_H
+#include "out_queue.h"
+#include "sof_sync.h"
+#include "toby_hid.h"
+
+typedef struct {
+    uint16_t kc;
+    uint8_t  flags;  // OUT_DOWN, OUT_JOIN
+    uint8_t  src;
+} out_step_t;
+
+static out_step_t out_ring[OUT_QUEUE_LEN];
+static uint8_t    out_head  = 0;  // next step to send
+static uint8_t    out_count = 0;
+static uint8_t    out_mods  = 0;  // modifiers our queued steps hold down
+static uint16_t   out_frame = 0;  // USB frame of the last report sent
+static uint16_t   out_time  = 0;  // timer_read() of the last report sent
+static void (*out_feeder)(void) = NULL;
+
+// Key events that came in while output was queued, replayed in order after it
+static keyevent_t out_held[OUT_QUEUE_HOLD];
+static uint8_t    out_held_len  = 0;
+static uint8_t    out_down      = 0;  // keys pressed, held or not, whose release is still to come
+static uint16_t   out_lost[MATRIX_ROWS];  // presses dropped with no room, one bit per column
+static bool       out_replaying = false;
+
+_Static_assert(MATRIX_COLS <= 16, "out_lost too narrow");
+
+static struct {
+    uint32_t reports[OUT_SRC_COUNT];
+    uint32_t chars[OUT_SRC_COUNT];
+    uint32_t dropped;
+    uint16_t held;
+    uint16_t lost;
+    uint16_t max_depth;
+} out_stats;
+
+// 5-bit QK_MODS modifiers to 8-bit report bits
+static uint8_t out_mod_bits(uint16_t kc) {
+    if (IS_MODIFIER_KEYCODE(kc)) return MOD_BIT(kc);
+    if (!IS_QK_MODS(kc)) return 0;
+    uint8_t m = QK_MODS_GET_MODS(kc);
+    return (m & 0x10) ? (m & 0x0F) << 4 : m;
+}
+
+static uint8_t out_basic(uint16_t kc) {
+    if (IS_MODIFIER_KEYCODE(kc)) return KC_NO;
+    return IS_QK_MODS(kc) ? QK_MODS_GET_BASIC_KEYCODE(kc) : kc;
+}
+
+static void out_apply(const out_step_t *s) {
+    uint8_t bits  = out_mod_bits(s->kc);
+    uint8_t basic = out_basic(s->kc);
+    if (s->flags & OUT_DOWN) {
+        out_mods |= bits;
+        if (basic) add_key(basic);
+    } else {
+        out_mods &= ~bits;
+        if (basic) del_key(basic);
+    }
+}
+
+// Apply one report's steps and send it with our modifiers only; the user's are restored after
+static void out_send(void) {
+    out_step_t *s;
+    do {
+        s = &out_ring[out_head];
+        out_apply(s);
+        out_head = (out_head + 1) % OUT_QUEUE_LEN;
+        out_count--;
+    } while ((s->flags & OUT_JOIN) && out_count);
+    uint8_t real = get_mods();
+    uint8_t weak = get_weak_mods();
+    set_mods(out_mods);
+    clear_weak_mods();
+    send_keyboard_report();
+    set_mods(real);
+    set_weak_mods(weak);
+    out_stats.reports[s->src]++;
+    out_frame = sof_sync_frame();
+    out_time  = timer_read();
+}
+
+// The host has taken the last report (new frame), or there is no SOF to wait for
+static bool out_due(void) {
+    return sof_sync_frame() != out_frame || timer_elapsed(out_time) >= OUT_QUEUE_STALL_MS;
+}
+
+static void out_refill(void) {
+    if (out_feeder && out_count <= OUT_QUEUE_LEN / 2) out_feeder();
+}
+
+void out_queue_push(uint16_t kc, uint8_t flags, out_src_t src) {
+    if (out_count >= OUT_QUEUE_LEN) return;
+    out_ring[(out_head + out_count) % OUT_QUEUE_LEN] = (out_step_t){kc, flags, src};
+    out_count++;
+    if (out_count > out_stats.max_depth) out_stats.max_depth = out_count;
+}
+
+uint8_t out_queue_room(void) {
+    return OUT_QUEUE_LEN - out_count;
+}
+
+void out_queue_down(uint16_t kc, out_src_t src) {
+    out_queue_push(kc, OUT_DOWN, src);
+}
+
+void out_queue_up(uint16_t kc, out_src_t src) {
+    out_queue_push(kc, 0, src);
+}
+
+void out_queue_tap(uint16_t kc, out_src_t src) {
+    out_queue_push(kc, OUT_DOWN, src);
+    out_queue_push(kc, 0, src);
+}
+
+void out_queue_feed(void (*feed)(void)) {
+    out_feeder = feed;
+}
+
+void out_queue_char(out_src_t src) {
+    out_stats.chars[src]++;
+}
+
+void out_queue_drop(void) {
+    out_stats.dropped++;
+}
+
+static bool out_busy(void) {
+    return out_count || out_feeder;
+}
+
+// Run held events through QMK again, oldest first, until one queues output
+static void out_replay(void) {
+    while (out_held_len && !out_busy()) {
+        keyevent_t event = out_held[0];
+        out_held_len--;
+        memmove(&out_held[0], &out_held[1], out_held_len * sizeof(keyevent_t));
+        out_replaying = true;
+        action_exec(event);
+        out_replaying = false;
+    }
+}
+
+void out_queue_task(void) {
+    out_refill();
+    if (out_count && out_due()) out_send();
+    out_replay();
+}
+
+bool out_queue_sync(keyrecord_t *record) {
+    if (out_replaying) return true;
+    keyevent_t e    = record->event;
+    bool       hold = out_busy() || out_held_len;
+    uint16_t   bit  = 1u << e.key.col;
+    if (e.pressed) {
+        // A held press needs room for itself and for every release still to
+        // come (its own included); without it the press is dropped, and its
+        // release with it
+        if (hold && out_held_len + out_down + 2 > OUT_QUEUE_HOLD) {
+            out_lost[e.key.row] |= bit;
+            out_stats.lost++;
+            return false;
+        }
+        out_down++;
+    } else {
+        if (out_lost[e.key.row] & bit) {
+            out_lost[e.key.row] &= ~bit;
+            return false;
+        }
+        if (out_down) out_down--;
+    }
+    // Full only with more keys down at once than it holds: let the rest through
+    if (!hold || out_held_len == OUT_QUEUE_HOLD) return true;
+    out_held[out_held_len++] = e;
+    out_stats.held++;
+    return false;
+}
+
+void out_queue_hid(uint8_t *data, uint8_t length) {
+    bool reset = data[1] == 1;
+    memset(&data[1], 0, length - 1);
+    data[2] = OUT_SRC_COUNT;
+    toby_hid_put_u16(&data[4], out_stats.max_depth);
+    toby_hid_put_u32(&data[6], out_stats.dropped);
+    toby_hid_put_u16(&data[10], out_stats.held);
+    toby_hid_put_u16(&data[12], out_stats.lost);
+    for (uint8_t i = 0; i < OUT_SRC_COUNT && 14 + i * 8 + 8 <= length; i++) {
+        toby_hid_put_u32(&data[14 + i * 8], out_stats.reports[i]);
+        toby_hid_put_u32(&data[18 + i * 8], out_stats.chars[i]);
+    }
+    if (reset) memset(&out_stats, 0, sizeof(out_stats));
+}
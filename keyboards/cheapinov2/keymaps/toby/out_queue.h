@@ -0,0 +1,76 @@
+// Non-blocking keyboard output queue for Cheapino keymap (toby)
+// Multi-key output (Unicode sequences, strings, ...) is queued as key steps
+// instead of being sent in a blocking burst, so process_record_user()
+// returns at once. The main loop sends one keyboard report per USB frame:
+// out_queue_task() waits for the next SOF (sof_sync.h), the rate at which the
+// host polls the keyboard endpoint; with no SOF for OUT_QUEUE_STALL_MS it
+// sends anyway. A step is one key (with its modifiers) going down or up;
+// OUT_JOIN puts a step in the same report as the next one. Queued reports
+// carry only the queue's own modifiers, never the user's held ones. Key
+// events (presses and releases) that come in while output is queued are held
+// back and replayed once it is sent, so typed keys never overtake it and a
+// released modifier never lands in the middle of it. Nothing waits: with the
+// hold buffer full, further presses are dropped (and counted).
+// Reports and characters are counted per source (tools/toby_hid.py out).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Key steps the queue holds
+#ifndef OUT_QUEUE_LEN
+#define OUT_QUEUE_LEN 64
+#endif
+
+// Key events held back while output is queued (presses stop at room for the
+// releases of every key down)
+#ifndef OUT_QUEUE_HOLD
+#define OUT_QUEUE_HOLD 32
+#endif
+
+// Send without a new SOF after this long (ms): suspended or not configured
+#ifndef OUT_QUEUE_STALL_MS
+#define OUT_QUEUE_STALL_MS 2
+#endif
+
+// Step flags
+#define OUT_DOWN 0x01  // key goes down (else up)
+#define OUT_JOIN 0x02  // same report as the next step
+
+// Producers, for the per-source counters
+typedef enum {
+    OUT_SRC_UNICODE,
+    OUT_SRC_STRING,
+    OUT_SRC_COUNT,
+} out_src_t;
+
+// Free steps; enqueue a whole character (or report) only if it fits.
+uint8_t out_queue_room(void);
+
+// Queue kc (basic keycode, modifier keycode, or mods + basic keycode) going
+// down or up (flags OUT_DOWN / OUT_JOIN). down/up/tap: one report per change.
+void out_queue_push(uint16_t kc, uint8_t flags, out_src_t src);
+void out_queue_down(uint16_t kc, out_src_t src);
+void out_queue_up(uint16_t kc, out_src_t src);
+void out_queue_tap(uint16_t kc, out_src_t src);
+
+// Producer that queues more when room frees up (long strings); NULL when done.
+void out_queue_feed(void (*feed)(void));
+
+// One output character queued by src (reports per character), or one dropped.
+void out_queue_char(out_src_t src);
+void out_queue_drop(void);
+
+// Main loop (housekeeping_task_user()): one report per new USB frame, then
+// the held key events once the queue is empty.
+void out_queue_task(void);
+
+// Every physical key event (pre_process_record_user(), first): false when the
+// event is held back behind queued output (or dropped); the caller stops
+// processing it.
+bool out_queue_sync(keyrecord_t *record);
+
+// TOBY_HID_OUT_STATS. Request: data[1] = 1 to reset counters after reading.
+// Reply: [2] source count, u16 LE max queued steps [4], u32 LE dropped
+// characters [6], u16 LE held key events [10] and dropped key presses [12],
+// per source from [14]: u32 LE reports, characters.
+void out_queue_hid(uint8_t *data, uint8_t length);
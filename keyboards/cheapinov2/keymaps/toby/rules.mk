@@ -4,17 +4,29 @@
 # Core QMK Features
 CAPS_WORD_ENABLE = yes         # Caps Word (both shifts or combo)
 REPEAT_KEY_ENABLE = yes        # QK_REP for repeat last key
-MOUSEKEY_ENABLE = yes          # Built-in mouse keys
+MOUSEKEY_ENABLE = yes          # Mouse buttons (motion/wheel: mouse_engine.c)
 KEY_OVERRIDE_ENABLE = yes      # Key overrides (Shift+Bspc = Del)
-COMBO_ENABLE = yes             # Combos for shortcuts
-UNICODEMAP_ENABLE = yes        # Unicode pairs for umlauts (CMD layer)
+COMBO_ENABLE = no              # Combos: own position-indexed engine (combo_index.c)
+UNICODEMAP_ENABLE = no         # Umlauts: per-OS input paths (unicode_out.c)
 LEADER_ENABLE = yes            # Leader key sequences
 OS_DETECTION_ENABLE = yes      # Enabled - works fine, LED was the problem
-AUTOCORRECT_ENABLE = yes       # Built-in typo autocorrect engine
+AUTOCORRECT_ENABLE = no        # Replaced by Aho-Corasick autocorrect (autocorrect_ac.c)
+RAW_ENABLE = yes               # Raw HID command plane (toby_hid.c, tools/toby_hid.py)
+RGBLIGHT_ENABLE = no           # LED driven by the compositor (led_comp.c) ...
+WS2812_DRIVER_REQUIRED = yes   # ... straight through the WS2812 driver
 
 # Advanced Features
 TRI_LAYER_ENABLE = yes         # Enabled - now works with Layer-Tap (trigger keys on both layers)
 
+# RP2040: run the scan/record hot path and keymap table from SRAM (hot_path.h)
+SRAM_HOT_PATH = no
+
+# Scan once per USB frame, timed to finish just before the next SOF (sof_sync.h)
+SOF_ALIGNED_SCAN = no
+
+# Per-subsystem time accounting probes, read over raw HID (cycle_prof.h)
+CYCLE_PROF = no
+
 # Size optimization
 LTO_ENABLE = yes               # Link Time Optimization
 CONSOLE_ENABLE = no            # Disable console for size
@@ -22,3 +34,34 @@ COMMAND_ENABLE = no            # Disable command for size
 
 # Extra sources for this keymap
 SRC += leader_actions.c
+SRC += os_profile.c
+SRC += boot_profile.c
+SRC += toby_hid.c
+SRC += combo_resolver.c
+SRC += combo_index.c
+SRC += autocorrect_ac.c
+SRC += autocorrect_learn.c
+SRC += tap_adapt.c
+SRC += key_behavior.c
+SRC += hybrid_key.c
+SRC += typing_streak.c
+SRC += hrm_speculate.c
+SRC += telemetry.c
+SRC += ee_cache.c
+SRC += led_comp.c
+SRC += mouse_engine.c
+SRC += tune.c
+SRC += event_trace.c
+SRC += out_queue.c
+SRC += unicode_out.c
+SRC += string_out.c
+
+ifeq ($(strip $(SRAM_HOT_PATH)), yes)
+    OPT_DEFS += -DSRAM_HOT_PATH
+endif
+ifeq ($(strip $(SOF_ALIGNED_SCAN)), yes)
+    OPT_DEFS += -DSOF_ALIGNED_SCAN
+endif
+ifeq ($(strip $(CYCLE_PROF)), yes)
+    OPT_DEFS += -DCYCLE_PROF
+endif
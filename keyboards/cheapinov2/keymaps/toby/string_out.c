@@ -0,0 +1,121 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// String output packed into shared NKRO reports, fed into the output queue.
+
+#include QMK_KEYBOARD_H
+#include "string_out.h"
+#include "out_queue.h"
+#include "os_profile.h"
+
+// Worst case per character: two reports of releases, Shift and presses
+#define STR_STEPS_PER_CHAR (4 * STRING_OUT_MAX_HELD + 2)
+
+static const char *str_next = NULL;  // next character to queue, NULL = idle
+static uint16_t    str_then = KC_NO;  // key tapped after the string
+static uint8_t     str_held[STRING_OUT_MAX_HELD];  // keys down as queued
+static uint8_t     str_held_n = 0;
+static uint8_t     str_ups[STRING_OUT_MAX_HELD];   // releases for the next report
+static uint8_t     str_ups_n  = 0;
+static uint8_t     str_run[STRING_OUT_MAX_HELD];   // presses for the next report
+static uint8_t     str_run_n  = 0;
+static bool        str_shift   = false;  // Shift wanted by the next report
+static bool        str_shifted = false;  // Shift down as queued
+
+static bool str_in(const uint8_t *keys, uint8_t n, uint8_t kc) {
+    for (uint8_t i = 0; i < n; i++) {
+        if (keys[i] == kc) return true;
+    }
+    return false;
+}
+
+// Everything held goes up with the next report
+static void str_release(void) {
+    memcpy(&str_ups[str_ups_n], str_held, str_held_n);
+    str_ups_n += str_held_n;
+    str_held_n = 0;
+}
+
+// One report: pending releases, then the Shift change, then the presses
+// (hosts apply a report's modifiers before its keys)
+static void str_flush(void) {
+    uint8_t steps = str_ups_n + (str_shift != str_shifted) + str_run_n;
+    if (!steps) return;
+    for (uint8_t i = 0; i < str_ups_n; i++) {
+        out_queue_push(str_ups[i], --steps ? OUT_JOIN : 0, OUT_SRC_STRING);
+    }
+    if (str_shift != str_shifted) {
+        out_queue_push(KC_LSFT, (str_shift ? OUT_DOWN : 0) | (--steps ? OUT_JOIN : 0), OUT_SRC_STRING);
+        str_shifted = str_shift;
+    }
+    for (uint8_t i = 0; i < str_run_n; i++) {
+        out_queue_push(str_run[i], OUT_DOWN | (--steps ? OUT_JOIN : 0), OUT_SRC_STRING);
+        str_held[str_held_n++] = str_run[i];
+    }
+    str_ups_n = str_run_n = 0;
+}
+
+static void str_char(uint8_t ascii) {
+    if (ascii >= 128) return;
+    uint8_t kc    = pgm_read_byte(&ascii_to_keycode_lut[ascii]);
+    bool    shift = PGM_LOADBIT(ascii_to_shift_lut, ascii);
+    if (kc == KC_NO) return;
+    uint8_t max = keymap_config.nkro && os_profile->string_pack ? STRING_OUT_MAX_HELD : 1;
+    if (str_in(str_run, str_run_n, kc) || str_in(str_held, str_held_n, kc)) {
+        // Repeated key: its release needs a report of its own
+        str_flush();
+        str_release();
+        str_flush();
+    } else if (str_in(str_ups, str_ups_n, kc) || (str_run_n && kc <= str_run[str_run_n - 1])) {
+        // Released in the pending report, or below the run in usage order
+        // (a report's keys reach the host lowest usage first): next report
+        str_flush();
+    }
+    if (str_held_n + str_run_n && (shift != str_shift || str_held_n + str_run_n >= max)) {
+        // Shift change or too many keys down: release them along with the next presses
+        str_flush();
+        str_release();
+    }
+    str_shift            = shift;
+    str_run[str_run_n++] = kc;
+    out_queue_char(OUT_SRC_STRING);
+}
+
+// Feeder: queue characters while a worst-case character still fits
+static void str_feed(void) {
+    while (str_next && out_queue_room() >= STR_STEPS_PER_CHAR) {
+        uint8_t c = pgm_read_byte(str_next);
+        if (!c) {
+            str_flush();
+            str_release();
+            str_shift = false;
+            str_flush();
+            if (str_then != KC_NO) out_queue_tap(str_then, OUT_SRC_STRING);
+            str_next = NULL;
+            out_queue_feed(NULL);
+            return;
+        }
+        str_char(c);
+        str_next++;
+    }
+    str_flush();
+}
+
+bool string_out_busy(void) {
+    return str_next != NULL;
+}
+
+bool string_out_then(const char *str, uint16_t kc) {
+    if (str_next) {
+        out_queue_drop();
+        return false;
+    }
+    str_next = str;
+    str_then = kc;
+    out_queue_feed(str_feed);
+    return true;
+}
+
+bool string_out(const char *str) {
+    return string_out_then(str, KC_NO);
+}
@@ -0,0 +1,36 @@
+// Packed string output for Cheapino keymap (toby)
+// Types ASCII strings (leader snippets, autocorrect fixes) through the output
+// queue (out_queue.h) with as few reports as the host allows. With NKRO
+// (force_nkro), consecutive characters whose keys rise in HID usage order go
+// down together in one report, and keys stay down across reports. A key is
+// released only when it repeats, Shift changes or STRING_OUT_MAX_HELD keys
+// are down, and those releases ride in the same report as the next presses
+// (a repeated key's release needs one of its own). Linux hid-input reads an
+// NKRO bitmap lowest usage first, so packed keys arrive in string order; the
+// other hosts' order is not established, so packing is on only where the OS
+// profile says so (string_pack: Linux). A report goes out per USB frame:
+// "git status\n" takes 9 reports instead of 22, prose about 0.8 per character
+// instead of 2. Elsewhere, and without NKRO (6KRO, boot protocol), one key is
+// down at a time, released with the next press.
+// Characters map through QMK's send_string tables, so the output is what
+// SEND_STRING would type (AltGr/dead-key characters of non-US SEND_STRING
+// layouts are skipped).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Keys held down at once before everything is released
+#ifndef STRING_OUT_MAX_HELD
+#define STRING_OUT_MAX_HELD 6
+#endif
+
+// Queue str (must stay valid until sent: literals, flash tables). Nothing
+// waits for a string still being typed: str is dropped (false).
+bool string_out(const char *str);
+
+// string_out(), then tap kc (basic keycode, or mods + basic keycode) after
+// the string: autocorrect queues the word's boundary key behind its fix.
+bool string_out_then(const char *str, uint16_t kc);
+
+// A string is still being typed.
+bool string_out_busy(void);
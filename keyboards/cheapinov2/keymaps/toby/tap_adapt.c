@@ -0,0 +1,217 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Adaptive tapping terms from per-key tap-duration histograms.
+
+#include QMK_KEYBOARD_H
+#include "tap_adapt.h"
+#include "cycle_prof.h"
+#include "user_eeprom.h"
+#include "ee_cache.h"
+#include "toby_hid.h"
+#include "tune.h"
+
+#define TAP_ADAPT_MAGIC 0x7A
+
+// Persisted terms, keyed by keycode so reordering tap_adapt_keys[] is harmless
+typedef struct {
+    uint8_t  magic;
+    uint8_t  count;
+    uint16_t reserved;
+    struct {
+        uint16_t keycode;
+        uint16_t term;
+    } keys[TAP_ADAPT_MAX_KEYS];
+} tap_adapt_image_t;
+
+_Static_assert(TAP_ADAPT_KEY_COUNT <= TAP_ADAPT_MAX_KEYS, "too many adaptive keys");
+_Static_assert(sizeof(tap_adapt_image_t) <= EE_TAP_ADAPT_SIZE, "tap terms exceed their EEPROM region");
+_Static_assert(EE_USER_DATA_END <= EECONFIG_USER_DATA_SIZE, "EECONFIG_USER_DATA_SIZE too small");
+
+typedef struct {
+    uint16_t hist[TAP_ADAPT_BUCKETS];
+    uint16_t samples;     // sum of hist (decays with it)
+    uint16_t term;        // current term
+    uint16_t press_time;  // event time of the pending press
+    bool     down;
+    bool     chorded;     // another key was pressed while this one was down
+    uint32_t taps;
+    uint32_t holds;
+    uint32_t missed;      // holds released alone (counted as taps)
+    uint32_t late;        // chorded holds released just after the term (counted as taps)
+} tap_adapt_stat_t;
+
+static tap_adapt_stat_t  tap_stats[TAP_ADAPT_KEY_COUNT];
+static tap_adapt_image_t tap_saved;
+static deferred_token    tap_flush_token = INVALID_DEFERRED_TOKEN;
+
+// Tunable at runtime: the base term plus the key's group offset
+static inline uint16_t tap_adapt_ceiling(uint8_t i) {
+    return tune.tapping_term + *tap_adapt_keys[i].offset;
+}
+
+int8_t tap_adapt_index(uint16_t keycode) {
+    for (uint8_t i = 0; i < TAP_ADAPT_KEY_COUNT; i++) {
+        if (tap_adapt_keys[i].keycode == keycode) return (int8_t)i;
+    }
+    return -1;
+}
+
+// Upper edge (ms) of the bucket where the histogram reaches pct percent
+static uint16_t tap_adapt_percentile(const tap_adapt_stat_t *s, uint8_t pct) {
+    uint32_t want = ((uint32_t)s->samples * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint8_t b = 0; b < TAP_ADAPT_BUCKETS; b++) {
+        seen += s->hist[b];
+        if (seen >= want) return (uint16_t)((b + 1) * TAP_ADAPT_BUCKET_MS);
+    }
+    return TAP_ADAPT_BUCKETS * TAP_ADAPT_BUCKET_MS;
+}
+
+// --- Persistence -------------------------------------------------------------
+
+static void tap_adapt_flush_now(void) {
+    tap_adapt_image_t img;
+    memset(&img, 0, sizeof(img));
+    img.magic = TAP_ADAPT_MAGIC;
+    img.count = TAP_ADAPT_KEY_COUNT;
+    for (uint8_t i = 0; i < TAP_ADAPT_KEY_COUNT; i++) {
+        img.keys[i].keycode = tap_adapt_keys[i].keycode;
+        img.keys[i].term    = tap_stats[i].term;
+    }
+    if (memcmp(&img, &tap_saved, sizeof(img)) == 0) return;
+    tap_saved = img;
+    ee_cache_write(&tap_saved, EE_TAP_ADAPT_OFFSET, sizeof(tap_saved));
+}
+
+static uint32_t tap_adapt_flush_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    tap_flush_token = INVALID_DEFERRED_TOKEN;
+    tap_adapt_flush_now();
+    return 0;
+}
+
+void tap_adapt_init(void) {
+    for (uint8_t i = 0; i < TAP_ADAPT_KEY_COUNT; i++) {
+        tap_stats[i].term = tap_adapt_ceiling(i);
+    }
+    ee_cache_read(&tap_saved, EE_TAP_ADAPT_OFFSET, sizeof(tap_saved));
+    if (tap_saved.magic != TAP_ADAPT_MAGIC || tap_saved.count > TAP_ADAPT_MAX_KEYS) {
+        memset(&tap_saved, 0, sizeof(tap_saved));
+        return;
+    }
+    for (uint8_t k = 0; k < tap_saved.count; k++) {
+        int8_t i = tap_adapt_index(tap_saved.keys[k].keycode);
+        if (i < 0) continue;
+        uint16_t term = tap_saved.keys[k].term;
+        if (term >= TAP_ADAPT_MIN_TERM && term <= tap_adapt_ceiling(i)) tap_stats[i].term = term;
+    }
+}
+
+// --- Learning ----------------------------------------------------------------
+
+static void tap_adapt_sample(uint8_t i, uint16_t duration) {
+    tap_adapt_stat_t *s = &tap_stats[i];
+    uint8_t b = duration / TAP_ADAPT_BUCKET_MS;
+    if (b >= TAP_ADAPT_BUCKETS) b = TAP_ADAPT_BUCKETS - 1;
+    s->hist[b]++;
+    if (++s->samples >= TAP_ADAPT_WINDOW) {
+        s->samples = 0;
+        for (uint8_t k = 0; k < TAP_ADAPT_BUCKETS; k++) {
+            s->hist[k] >>= 1;
+            s->samples += s->hist[k];
+        }
+    }
+    if (s->samples < TAP_ADAPT_MIN_SAMPLES || (s->samples & 0x0F)) return;
+
+    // Re-derive every 16 samples
+    uint16_t term = tap_adapt_percentile(s, TAP_ADAPT_PERCENTILE) + TAP_ADAPT_MARGIN;
+    if (term < TAP_ADAPT_MIN_TERM) term = TAP_ADAPT_MIN_TERM;
+    if (term > tap_adapt_ceiling(i)) term = tap_adapt_ceiling(i);
+    if (term + TAP_ADAPT_MAX_DROP < s->term) term = s->term - TAP_ADAPT_MAX_DROP;
+    if (term == s->term) return;
+    s->term = term;
+    if (tap_flush_token == INVALID_DEFERRED_TOKEN) {
+        tap_flush_token = defer_exec(TAP_ADAPT_FLUSH_MS, tap_adapt_flush_cb, NULL);
+    }
+}
+
+uint16_t tap_adapt_term(uint16_t keycode) {
+    return tap_adapt_term_at(tap_adapt_index(keycode));
+}
+
+uint16_t tap_adapt_term_at(int8_t i) {
+    if (i < 0) return tune.tapping_term;
+    uint16_t ceiling = tap_adapt_ceiling(i);  // may have been lowered since the term was learned
+    return tap_stats[i].term < ceiling ? tap_stats[i].term : ceiling;
+}
+
+void tap_adapt_observe(uint16_t keycode, keyrecord_t *record) {
+    int8_t i = tap_adapt_index(keycode);
+    if (record->event.pressed) {
+        // Any press chords the adaptive keys that are down
+        for (uint8_t k = 0; k < TAP_ADAPT_KEY_COUNT; k++) {
+            if (tap_stats[k].down) tap_stats[k].chorded = true;
+        }
+        if (i < 0) return;
+        tap_stats[i].down       = true;
+        tap_stats[i].chorded    = false;
+        tap_stats[i].press_time = record->event.time;
+        return;
+    }
+    if (i < 0 || !tap_stats[i].down) return;
+
+    tap_adapt_stat_t *s = &tap_stats[i];
+    uint16_t duration = TIMER_DIFF_16(record->event.time, s->press_time);
+    s->down = false;
+    if (record->tap.count) {
+        s->taps++;
+        tap_adapt_sample(i, duration);
+    } else {
+        s->holds++;
+        // Held alone and released: the mod/layer did nothing, it was a slow tap
+        if (!s->chorded && duration < tap_adapt_ceiling(i)) {
+            s->missed++;
+            tap_adapt_sample(i, duration);
+        } else if (s->chorded && duration < tap_adapt_term_at(i) + TAP_ADAPT_LATE_MS) {
+            // Chorded and released by term + TAP_ADAPT_LATE_MS: maybe a slow tap
+            // the other key turned into a hold
+            s->late++;
+            tap_adapt_sample(i, duration);
+        }
+    }
+}
+
+// --- Raw HID -----------------------------------------------------------------
+
+void tap_adapt_hid(uint8_t *data, uint8_t length) {
+    uint8_t idx   = data[1];
+    bool    reset = data[2] == 1;
+    memset(&data[1], 0, length - 1);
+    data[1] = idx;
+    data[2] = TAP_ADAPT_KEY_COUNT;
+    data[3] = TAP_ADAPT_PERCENTILE;
+    if (idx >= TAP_ADAPT_KEY_COUNT || length < 30) return;
+
+    tap_adapt_stat_t *s = &tap_stats[idx];
+    toby_hid_put_u16(&data[4], tap_adapt_keys[idx].keycode);
+    toby_hid_put_u16(&data[6], s->term);
+    toby_hid_put_u16(&data[8], tap_adapt_ceiling(idx));
+    toby_hid_put_u16(&data[10], s->samples ? tap_adapt_percentile(s, 50) : 0);
+    toby_hid_put_u16(&data[12], s->samples ? tap_adapt_percentile(s, TAP_ADAPT_PERCENTILE) : 0);
+    toby_hid_put_u32(&data[14], s->taps);
+    toby_hid_put_u32(&data[18], s->holds);
+    toby_hid_put_u32(&data[22], s->missed);
+    toby_hid_put_u32(&data[26], s->late);
+
+    // Reset forgets the histogram and falls back to the ceiling
+    if (reset) {
+        memset(s->hist, 0, sizeof(s->hist));
+        s->samples = 0;
+        s->taps = s->holds = s->missed = s->late = 0;
+        s->term = tap_adapt_ceiling(idx);
+        if (tap_flush_token == INVALID_DEFERRED_TOKEN) {
+            tap_flush_token = defer_exec(TAP_ADAPT_FLUSH_MS, tap_adapt_flush_cb, NULL);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+// Adaptive tapping terms for Cheapino keymap (toby)
+// Streams per-key histograms of tap durations (press to release of keys that
+// resolved as taps) and hold outcomes, and derives each key's tapping term at
+// TAP_ADAPT_PERCENTILE of its taps plus TAP_ADAPT_MARGIN, between
+// TAP_ADAPT_MIN_TERM and the key's configured ceiling (tap_adapt_keys[],
+// generated from the TERM column of key_behavior_map.h).
+// A hold released without any other key pressed counts as a missed tap, so
+// slow taps pull the term back up instead of vanishing from the histogram.
+// A chorded hold released within TAP_ADAPT_LATE_MS after the term is sampled
+// too: it may be a slow tap that another key turned into a hold.
+// Remaining bias: taps are seen only up to term + TAP_ADAPT_LATE_MS, so the
+// histogram is still cut off near the current term and its percentile can
+// sit low. One re-derive (every 16 samples) lowers the term by at most
+// TAP_ADAPT_MAX_DROP, so a low percentile walks it down slowly and the late
+// samples have time to push it back up. Quick real chords (Shift+letter) land
+// in the same window and bias the term up, the safe side.
+// Terms are persisted (rate-limited) in the EEPROM user datablock and are
+// readable over raw HID (TOBY_HID_TAP_TERMS, tools/toby_hid.py terms).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Share of taps that must fit inside the term (%)
+#ifndef TAP_ADAPT_PERCENTILE
+#define TAP_ADAPT_PERCENTILE 98
+#endif
+
+// Added to the percentile (ms)
+#ifndef TAP_ADAPT_MARGIN
+#define TAP_ADAPT_MARGIN 20
+#endif
+
+// Lower bound for any learned term (ms)
+#ifndef TAP_ADAPT_MIN_TERM
+#define TAP_ADAPT_MIN_TERM 120
+#endif
+
+// Chorded holds released up to this long after the term are sampled (ms)
+#ifndef TAP_ADAPT_LATE_MS
+#define TAP_ADAPT_LATE_MS 50
+#endif
+
+// Most one re-derive lowers a term (ms); raising is not limited
+#ifndef TAP_ADAPT_MAX_DROP
+#define TAP_ADAPT_MAX_DROP 10
+#endif
+
+// Taps needed before a key's term adapts
+#ifndef TAP_ADAPT_MIN_SAMPLES
+#define TAP_ADAPT_MIN_SAMPLES 64
+#endif
+
+// Histogram is halved once it holds this many samples (streaming window)
+#ifndef TAP_ADAPT_WINDOW
+#define TAP_ADAPT_WINDOW 2048
+#endif
+
+// Minimum time between EEPROM writes (ms)
+#ifndef TAP_ADAPT_FLUSH_MS
+#define TAP_ADAPT_FLUSH_MS 900000
+#endif
+
+// Histogram bucket width (ms) and count
+#define TAP_ADAPT_BUCKET_MS 10
+#define TAP_ADAPT_BUCKETS   40
+
+// Keys persisted at most (EE_TAP_ADAPT_SIZE)
+#define TAP_ADAPT_MAX_KEYS 16
+
+typedef struct {
+    uint16_t keycode;
+    const uint16_t *offset;  // ceiling = tune.tapping_term + *offset; learned terms never exceed it
+} tap_adapt_key_t;
+
+// Expanded from key_behavior_map.h in keymap.c, TAP_ADAPT_KEY_COUNT entries (config.h)
+extern const tap_adapt_key_t tap_adapt_keys[TAP_ADAPT_KEY_COUNT];
+
+// Load persisted terms. Call from keyboard_post_init_user().
+void tap_adapt_init(void);
+
+// Tapping term for a key (tune.tapping_term for keys not in tap_adapt_keys[]).
+uint16_t tap_adapt_term(uint16_t keycode);
+
+// Index of a key in tap_adapt_keys[], -1 if not adaptive.
+int8_t tap_adapt_index(uint16_t keycode);
+
+// Tapping term by index (tap_adapt_index(); tune.tapping_term for -1).
+uint16_t tap_adapt_term_at(int8_t i);
+
+// Every resolved key event (top of process_record_user()).
+void tap_adapt_observe(uint16_t keycode, keyrecord_t *record);
+
+// TOBY_HID_TAP_TERMS. Request: data[1] = key index, data[2] = 1 to reset stats.
+// Reply: [1] index, [2] key count, [3] percentile, u16 LE keycode [4], term [6],
+// ceiling [8], p50 [10], p-target [12]; u32 LE taps [14], holds [18], missed taps [22],
+// late chorded holds [26].
+void tap_adapt_hid(uint8_t *data, uint8_t length);
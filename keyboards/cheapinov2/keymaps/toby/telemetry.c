@@ -0,0 +1,158 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Usage telemetry: RAM counters, flushed to EEPROM while idle.
+
+#include QMK_KEYBOARD_H
+#include "telemetry.h"
+#include "cycle_prof.h"
+#include "user_eeprom.h"
+#include "ee_cache.h"
+#include "toby_hid.h"
+
+#define TELEMETRY_MAGIC   0x7E
+#define TELEMETRY_VERSION 1
+
+// Layout positions -> matrix (keyboard.json LAYOUT_split_3x5_3)
+static const uint8_t telemetry_layout[TELEMETRY_KEYS][2] = {
+    {4, 10}, {4, 9}, {4, 8}, {4, 7}, {4, 6}, {0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4},
+    {5, 10}, {5, 9}, {5, 8}, {5, 7}, {5, 6}, {1, 0}, {1, 1}, {1, 2}, {1, 3}, {1, 4},
+    {6, 10}, {6, 9}, {6, 8}, {6, 7}, {6, 6}, {2, 0}, {2, 1}, {2, 2}, {2, 3}, {2, 4},
+    {6, 11}, {5, 11}, {4, 11}, {0, 5},  {1, 5}, {2, 5},
+};
+
+// Arena: persisted and exported as-is (little-endian, no padding)
+typedef struct {
+    uint8_t  magic;
+    uint8_t  version;
+    uint8_t  keys;
+    uint8_t  layers;
+    uint8_t  hrms;
+    uint8_t  leader_slots;
+    uint16_t reserved;
+    uint32_t presses[TELEMETRY_KEYS];
+    uint32_t layer_on[TELEMETRY_LAYERS];
+    uint32_t hrm_tap[TELEMETRY_HRMS];
+    uint32_t hrm_hold[TELEMETRY_HRMS];
+    uint16_t leader[TELEMETRY_LEADER_SLOTS];
+    uint16_t bigram[TELEMETRY_KEYS][TELEMETRY_KEYS];  // [previous][current], halved on saturation
+} telemetry_arena_t;
+
+_Static_assert(sizeof(telemetry_arena_t) <= EE_TELEMETRY_SIZE, "telemetry arena exceeds its EEPROM region");
+_Static_assert(EE_USER_DATA_END <= EECONFIG_USER_DATA_SIZE, "EECONFIG_USER_DATA_SIZE too small");
+
+static telemetry_arena_t tm;
+static uint8_t           tm_pos_of[MATRIX_ROWS][MATRIX_COLS];  // 0 = not a layout key, else index + 1
+static uint8_t           tm_prev      = 0;                     // previous press, index + 1
+static layer_state_t     tm_layer_prev = 0;
+
+// Idle flush: armed by the first change, re-armed until the board is idle
+static bool           tm_dirty      = false;
+static uint32_t       tm_last_event = 0;
+static uint32_t       tm_last_flush = 0;
+static deferred_token tm_token      = INVALID_DEFERRED_TOKEN;
+
+static void telemetry_reset_arena(void) {
+    memset(&tm, 0, sizeof(tm));
+    tm.magic        = TELEMETRY_MAGIC;
+    tm.version      = TELEMETRY_VERSION;
+    tm.keys         = TELEMETRY_KEYS;
+    tm.layers       = TELEMETRY_LAYERS;
+    tm.hrms         = TELEMETRY_HRMS;
+    tm.leader_slots = TELEMETRY_LEADER_SLOTS;
+}
+
+static uint32_t telemetry_flush_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    uint32_t idle  = timer_elapsed32(tm_last_event);
+    uint32_t since = timer_elapsed32(tm_last_flush);
+    if (idle < TELEMETRY_IDLE_MS) return TELEMETRY_IDLE_MS - idle;
+    if (since < TELEMETRY_FLUSH_MS) return TELEMETRY_FLUSH_MS - since;
+
+    ee_cache_write(&tm, EE_TELEMETRY_OFFSET, sizeof(tm));
+    tm_dirty      = false;
+    tm_last_flush = timer_read32();
+    tm_token      = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+static inline void telemetry_touch(void) {
+    tm_last_event = timer_read32();
+    if (tm_dirty) return;
+    tm_dirty = true;
+    tm_token = defer_exec(TELEMETRY_IDLE_MS, telemetry_flush_cb, NULL);
+}
+
+void telemetry_init(void) {
+    for (uint8_t i = 0; i < TELEMETRY_KEYS; i++) {
+        tm_pos_of[telemetry_layout[i][0]][telemetry_layout[i][1]] = i + 1;
+    }
+    ee_cache_read(&tm, EE_TELEMETRY_OFFSET, sizeof(tm));
+    if (tm.magic != TELEMETRY_MAGIC || tm.version != TELEMETRY_VERSION) {
+        telemetry_reset_arena();
+    }
+}
+
+void telemetry_key(keyrecord_t *record) {
+    if (!record->event.pressed) return;
+    uint8_t row = record->event.key.row, col = record->event.key.col;
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) return;
+    uint8_t pos = tm_pos_of[row][col];
+    if (!pos) return;
+
+    tm.presses[pos - 1]++;
+    if (tm_prev) {
+        uint16_t *b = &tm.bigram[tm_prev - 1][pos - 1];
+        if (*b == UINT16_MAX) {
+            // Keep ratios: halve the whole table once a cell saturates
+            for (uint16_t i = 0; i < TELEMETRY_KEYS * TELEMETRY_KEYS; i++) (&tm.bigram[0][0])[i] >>= 1;
+        }
+        (*b)++;
+    }
+    tm_prev = pos;
+    telemetry_touch();
+}
+
+void telemetry_layers(layer_state_t state) {
+    layer_state_t added = state & ~tm_layer_prev;
+    tm_layer_prev       = state;
+    for (uint8_t l = 0; added && l < TELEMETRY_LAYERS; l++, added >>= 1) {
+        if (added & 1) tm.layer_on[l]++;
+    }
+}
+
+void telemetry_hrm(uint8_t hrm, bool tap) {
+    if (hrm >= TELEMETRY_HRMS) return;
+    if (tap) {
+        tm.hrm_tap[hrm]++;
+    } else {
+        tm.hrm_hold[hrm]++;
+    }
+}
+
+void telemetry_leader(uint8_t entry) {
+    if (entry >= TELEMETRY_LEADER_SLOTS || tm.leader[entry] == UINT16_MAX) return;
+    tm.leader[entry]++;
+}
+
+void telemetry_hid(uint8_t *data, uint8_t length) {
+    uint8_t  op     = data[1];
+    uint16_t offset = toby_hid_get_u16(&data[2]);
+    memset(&data[1], 0, length - 1);
+
+    if (op == 1) {
+        telemetry_reset_arena();
+        tm_prev = 0;
+        telemetry_touch();
+        offset = 0;
+    }
+    data[1] = op;
+    toby_hid_put_u16(&data[2], offset);
+    toby_hid_put_u16(&data[4], sizeof(tm));
+    if (offset >= sizeof(tm) || length <= 8) return;
+
+    uint16_t n = sizeof(tm) - offset;
+    if (n > length - 8) n = length - 8;
+    data[6] = (uint8_t)n;
+    memcpy(&data[8], (const uint8_t *)&tm + offset, n);
+}
@@ -0,0 +1,51 @@
+// Usage telemetry for Cheapino keymap (toby)
+// Counts per-key presses, bigrams between the 36 physical keys, layer
+// activations, HRM tap/hold outcomes and leader sequence use in one RAM
+// arena. Recording is a few increments per event; the arena is handed to the
+// EEPROM write-behind cache (ee_cache.c) only after TELEMETRY_IDLE_MS without
+// key events, and at most once per TELEMETRY_FLUSH_MS.
+// Export: raw HID (TOBY_HID_TELEMETRY), decoded by tools/toby_hid.py telemetry.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// Physical keys (LAYOUT_split_3x5_3 order)
+#define TELEMETRY_KEYS 36
+
+// Layers counted (bits of layer_state)
+#define TELEMETRY_LAYERS 16
+
+// Home-row mods (keymap HRM_*_IDX order)
+#define TELEMETRY_HRMS 8
+
+// Leader entries counted (leader_map.h order)
+#define TELEMETRY_LEADER_SLOTS 32
+
+// Keyboard must be idle this long before a flush (ms)
+#ifndef TELEMETRY_IDLE_MS
+#define TELEMETRY_IDLE_MS 60000
+#endif
+
+// Minimum time between flushes (ms)
+#ifndef TELEMETRY_FLUSH_MS
+#define TELEMETRY_FLUSH_MS 1800000
+#endif
+
+// Load the persisted arena. Call from keyboard_post_init_user().
+void telemetry_init(void);
+
+// Every physical key event (pre_process_record_user()).
+void telemetry_key(keyrecord_t *record);
+
+// Layer state after each change (layer_state_set_user()).
+void telemetry_layers(layer_state_t state);
+
+// HRM press resolved as tap or hold.
+void telemetry_hrm(uint8_t hrm, bool tap);
+
+// Leader entry fired (index into leader_map.h entries).
+void telemetry_leader(uint8_t entry);
+
+// TOBY_HID_TELEMETRY. Request: data[1] = 0 read / 1 reset, data[2..3] = offset.
+// Reply: [2..3] offset, [4..5] arena size, [6] chunk length, arena bytes from [8].
+void telemetry_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,157 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Raw HID dispatcher: one switch on the command byte, handlers live with their module.
+
+#include QMK_KEYBOARD_H
+#include "raw_hid.h"
+#include "toby_hid.h"
+#include "boot_profile.h"
+#include "combo_resolver.h"
+#include "autocorrect_learn.h"
+#include "tap_adapt.h"
+#include "hrm_speculate.h"
+#include "telemetry.h"
+#include "ee_cache.h"
+#include "led_comp.h"
+#include "tune.h"
+#include "event_trace.h"
+#include "out_queue.h"
+#include "scan_stats.h"
+#include "sof_sync.h"
+#include "cycle_prof.h"
+
+// Board-level scan statistics have no module of their own in the keymap.
+// Request: data[1] = first bucket (0xFF = reset). Reply: [2] bucket count,
+// [3] bucket width µs, u16 LE min [4] / max [6] µs, 6 u32 LE buckets from [8].
+static void scan_hist_hid(uint8_t *data, uint8_t length) {
+    uint8_t first = data[1];
+    memset(&data[1], 0, length - 1);
+    if (first == 0xFF) {
+        scan_stats_reset();
+        return;
+    }
+    const scan_stats_t *st = scan_stats_get();
+    data[1] = first;
+    data[2] = SCAN_HIST_BUCKETS;
+    data[3] = SCAN_HIST_WIDTH_US;
+    toby_hid_put_u16(&data[4], st->min_us);
+    toby_hid_put_u16(&data[6], st->max_us);
+    for (uint8_t i = 0; first + i < SCAN_HIST_BUCKETS && 8 + i * 4 + 4 <= length; i++) {
+        toby_hid_put_u32(&data[8 + i * 4], st->hist[first + i]);
+    }
+}
+
+// Board-level SOF sync statistics. Request: data[1] = 0xFF reset, 0xFE summary,
+// else first slack bucket. Summary: u16 LE min [4] / max [6] slack µs, scan
+// estimate µs [8]; u32 LE events [10], unsynced [14], scans [18], frames [22];
+// [26] 1 if built with SOF_ALIGNED_SCAN. Buckets: [2] count, [3] width µs,
+// 7 u32 LE from [4].
+static void sof_stats_hid(uint8_t *data, uint8_t length) {
+    uint8_t first = data[1];
+    memset(&data[1], 0, length - 1);
+    if (first == 0xFF) {
+        sof_stats_reset();
+        return;
+    }
+    const sof_stats_t *st = sof_stats_get();
+    data[1] = first;
+    if (first == 0xFE) {
+        toby_hid_put_u16(&data[4], st->min_slack_us);
+        toby_hid_put_u16(&data[6], st->max_slack_us);
+        toby_hid_put_u16(&data[8], st->scan_est_us);
+        toby_hid_put_u32(&data[10], st->events);
+        toby_hid_put_u32(&data[14], st->unsynced);
+        toby_hid_put_u32(&data[18], st->scans);
+        toby_hid_put_u32(&data[22], st->frames);
+#ifdef SOF_ALIGNED_SCAN
+        data[26] = 1;
+#endif
+        return;
+    }
+    data[2] = SOF_SLACK_BUCKETS;
+    data[3] = SOF_SLACK_WIDTH_US;
+    for (uint8_t i = 0; first + i < SOF_SLACK_BUCKETS && 4 + i * 4 + 4 <= length; i++) {
+        toby_hid_put_u32(&data[4 + i * 4], st->hist[first + i]);
+    }
+}
+
+#ifdef CYCLE_PROF
+// Board-level per-subsystem time. Request: data[1] = first subsystem (0xFF =
+// reset). Reply: [2] subsystem count, [3] entries in this reply, from [4]
+// per subsystem u32 LE total µs, calls, max µs.
+static void cycle_prof_hid(uint8_t *data, uint8_t length) {
+    uint8_t first = data[1];
+    memset(&data[1], 0, length - 1);
+    if (first == 0xFF) {
+        cycle_prof_reset();
+        return;
+    }
+    const cycle_prof_t *prof = cycle_prof_get();
+    uint8_t             n    = 0;
+    data[1]                  = first;
+    data[2]                  = PROF_COUNT;
+    for (uint8_t i = first; i < PROF_COUNT && 4 + n * 12 + 12 <= length; i++, n++) {
+        toby_hid_put_u32(&data[4 + n * 12], prof[i].total_us);
+        toby_hid_put_u32(&data[8 + n * 12], prof[i].count);
+        toby_hid_put_u32(&data[12 + n * 12], prof[i].max_us);
+    }
+    data[3] = n;
+}
+#endif
+
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (length < 2) return;
+    switch (data[0]) {
+        case TOBY_HID_BOOT_LOG:
+            boot_prof_hid_read(data, length);
+            break;
+        case TOBY_HID_COMBO_STATS:
+            combo_resolver_hid_stats(data, length);
+            break;
+        case TOBY_HID_AC_LEARNED:
+            ac_learn_hid(data, length);
+            break;
+        case TOBY_HID_TAP_TERMS:
+            tap_adapt_hid(data, length);
+            break;
+        case TOBY_HID_SPEC_STATS:
+            hrm_speculate_hid(data, length);
+            break;
+        case TOBY_HID_TELEMETRY:
+            telemetry_hid(data, length);
+            break;
+        case TOBY_HID_EE_CACHE:
+            ee_cache_hid(data, length);
+            break;
+        case TOBY_HID_SCAN_HIST:
+            scan_hist_hid(data, length);
+            break;
+        case TOBY_HID_SOF_STATS:
+            sof_stats_hid(data, length);
+            break;
+        case TOBY_HID_LED_STATS:
+            led_comp_hid(data, length);
+            break;
+        case TOBY_HID_TUNE:
+            tune_hid(data, length);
+            break;
+        case TOBY_HID_OUT_STATS:
+            out_queue_hid(data, length);
+            break;
+#ifdef EVENT_TRACE
+        case TOBY_HID_EVENT_TRACE:
+            event_trace_hid(data, length);
+            break;
+#endif
+#ifdef CYCLE_PROF
+        case TOBY_HID_CYCLE_PROF:
+            cycle_prof_hid(data, length);
+            break;
+#endif
+        default:
+            data[0] = TOBY_HID_UNHANDLED;
+            break;
+    }
+    raw_hid_send(data, length);
+}
@@ -0,0 +1,47 @@
+// Raw HID command plane for Cheapino keymap (toby)
+// Request:  data[0] = command id, data[1..] command-specific.
+// Reply:    same buffer, data[0] echoed (TOBY_HID_UNHANDLED if unknown).
+// Host side: tools/toby_hid.py
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+enum toby_hid_cmd {
+    TOBY_HID_BOOT_LOG    = 0x01,  // boot_profile.c: read boot-phase timestamps
+    TOBY_HID_COMBO_STATS = 0x02,  // combo_resolver.c: buffering latency stats
+    TOBY_HID_AC_LEARNED  = 0x03,  // autocorrect_learn.c: learned typo pairs
+    TOBY_HID_TAP_TERMS   = 0x04,  // tap_adapt.c: adaptive tapping terms
+    TOBY_HID_SPEC_STATS  = 0x05,  // hrm_speculate.c: speculative modifier outcomes
+    TOBY_HID_TELEMETRY   = 0x06,  // telemetry.c: usage counters arena
+    TOBY_HID_EE_CACHE    = 0x07,  // ee_cache.c: write-behind flush counters
+    TOBY_HID_SCAN_HIST   = 0x08,  // matrix.c (keyboard): scan-time histogram
+    TOBY_HID_LED_STATS   = 0x09,  // led_comp.c: frames pushed vs skipped
+    TOBY_HID_SOF_STATS   = 0x0A,  // sof_sync.c (keyboard): report slack before the next SOF
+    TOBY_HID_TUNE        = 0x0B,  // tune.c: read/write runtime timing parameters
+    TOBY_HID_EVENT_TRACE = 0x0C,  // event_trace.c: key event capture (EVENT_TRACE builds)
+    TOBY_HID_CYCLE_PROF  = 0x0D,  // cycle_prof.c (board): time per subsystem (CYCLE_PROF builds)
+    TOBY_HID_OUT_STATS   = 0x0E,  // out_queue.c: queued output reports per character
+};
+
+#define TOBY_HID_UNHANDLED 0xFF
+
+// Little-endian field helpers for reply payloads
+static inline void toby_hid_put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void toby_hid_put_u32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t toby_hid_get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t toby_hid_get_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
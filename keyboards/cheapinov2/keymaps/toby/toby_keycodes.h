@@ -15,4 +15,8 @@ enum custom_keycodes {
     M_DBL_MOD,
     M_TGL_MOD,
     M_MBTN3,
+    UNI_AE,       // ä/Ä, per-OS input path (unicode_out.c)
+    UNI_OE,       // ö/Ö
+    UNI_UE,       // ü/Ü
+    UNI_SS,       // ß/ẞ
 };
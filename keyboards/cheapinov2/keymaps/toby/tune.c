@@ -0,0 +1,106 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Runtime tuning plane: RAM parameters, versioned EEPROM block, raw HID get/set.
+
+#include QMK_KEYBOARD_H
+#include "tune.h"
+#include "ee_cache.h"
+#include "user_eeprom.h"
+#include "toby_hid.h"
+
+#define TUNE_MAGIC   0x75
+#define TUNE_VERSION 1
+
+typedef struct {
+    uint16_t    def, min, max;
+    const char *name;
+} tune_param_t;
+
+static const tune_param_t tune_params[TUNE_COUNT] = {
+#define TUNE(name, d, lo, hi) {d, lo, hi, #name},
+    TUNE_PARAMS
+#undef TUNE
+};
+
+// Persisted block: values by index; count grows as entries are appended
+typedef struct {
+    uint8_t  magic;
+    uint8_t  version;
+    uint8_t  count;
+    uint8_t  reserved;
+    uint16_t v[(EE_TUNE_SIZE - 4) / 2];
+} tune_image_t;
+
+_Static_assert(sizeof(tune_image_t) == EE_TUNE_SIZE, "tune image size");
+_Static_assert(TUNE_COUNT <= (EE_TUNE_SIZE - 4) / 2, "EE_TUNE too small for TUNE_PARAMS");
+
+tune_t tune = {{
+#define TUNE(name, d, lo, hi) .name = d,
+    TUNE_PARAMS
+#undef TUNE
+}};
+
+static bool tune_valid(uint8_t id, uint16_t value) {
+    return value >= tune_params[id].min && value <= tune_params[id].max;
+}
+
+// Values other modules keep outside `tune`
+static void tune_apply(void) {
+    matrix_io_delay = tune.matrix_io_delay;
+}
+
+static void tune_save(void) {
+    tune_image_t img;
+    memset(&img, 0, sizeof(img));
+    img.magic   = TUNE_MAGIC;
+    img.version = TUNE_VERSION;
+    img.count   = TUNE_COUNT;
+    memcpy(img.v, tune.v, sizeof(tune.v));
+    ee_cache_write(&img, EE_TUNE_OFFSET, sizeof(img));
+}
+
+void tune_init(void) {
+    tune_image_t img;
+    ee_cache_read(&img, EE_TUNE_OFFSET, sizeof(img));
+    if (img.magic == TUNE_MAGIC && img.version == TUNE_VERSION) {
+        for (uint8_t i = 0; i < TUNE_COUNT && i < img.count; i++) {
+            if (tune_valid(i, img.v[i])) tune.v[i] = img.v[i];
+        }
+    }
+    tune_apply();
+}
+
+void tune_hid(uint8_t *data, uint8_t length) {
+    uint8_t  op    = data[1];
+    uint8_t  id    = data[2];
+    uint16_t value = toby_hid_get_u16(&data[5]);
+    uint8_t  status = 0;
+    memset(&data[3], 0, length - 3);
+    data[3] = TUNE_COUNT;
+    // A bad id changes nothing, reset included
+    if (id >= TUNE_COUNT) {
+        data[4] = 1;
+        return;
+    }
+    if (op == 2) {
+        for (uint8_t i = 0; i < TUNE_COUNT; i++) tune.v[i] = tune_params[i].def;
+        tune_apply();
+        tune_save();
+    } else if (op == 1) {
+        if (tune_valid(id, value)) {
+            tune.v[id] = value;
+            tune_apply();
+            tune_save();
+        } else {
+            status = 2;
+        }
+    }
+    const tune_param_t *p = &tune_params[id];
+    data[4] = status;
+    toby_hid_put_u16(&data[5], tune.v[id]);
+    toby_hid_put_u16(&data[7], p->min);
+    toby_hid_put_u16(&data[9], p->max);
+    toby_hid_put_u16(&data[11], p->def);
+    strncpy((char *)&data[13], p->name, length - 14);
+}
@@ -0,0 +1,40 @@
+// Runtime tuning plane for Cheapino keymap (toby)
+// Every timing parameter in tune_params.h lives in the RAM struct `tune`;
+// code reads it as a plain field (tune.tapping_term), the compile-time
+// #defines are only the defaults. Values are loaded at boot from a
+// versioned block in the EEPROM user datablock (EE_TUNE) and set over raw
+// HID (TOBY_HID_TUNE, tools/toby_hid.py tune NAME VALUE): a change applies
+// at once and is persisted through the write-behind cache.
+
+#pragma once
+#include QMK_KEYBOARD_H
+#include "tune_params.h"
+
+enum {
+#define TUNE(name, def, lo, hi) TUNE_ID_##name,
+    TUNE_PARAMS
+#undef TUNE
+    TUNE_COUNT,
+};
+
+typedef union {
+    struct {
+#define TUNE(name, def, lo, hi) uint16_t name;
+        TUNE_PARAMS
+#undef TUNE
+    };
+    uint16_t v[TUNE_COUNT];
+} tune_t;
+
+extern tune_t tune;
+
+// Load persisted values (defaults for missing/invalid ones). Call right after ee_cache_init().
+void tune_init(void);
+
+// TOBY_HID_TUNE. Request: data[1] op (0 = get, 1 = set + persist, 2 = all
+// defaults + persist), data[2] param id (checked for every op), u16 LE value
+// [5] for set.
+// Reply: [1] op, [2] id, [3] param count, [4] status (0 ok, 1 bad id,
+// 2 out of range), u16 LE value [5], min [7], max [9], default [11],
+// name from [13] (NUL-terminated).
+void tune_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,51 @@
+// Runtime-tunable timing parameters for Cheapino keymap (toby)
+// Single source of the tuning plane (tune.c, tools/toby_hid.py tune).
+// TUNE(name, default, min, max): one uint16_t field of `tune`, read directly
+// by the code that uses it. Names are at most 18 characters. The persisted
+// block is index based: append new entries at the end, and bump
+// TUNE_VERSION in tune.c when an existing entry changes meaning.
+
+#pragma once
+
+#include "mouse_engine.h"
+#include "matrix_io.h"
+
+// Defaults of the keymap's own timings (ms)
+#ifndef BSPC_TRIPLE_TERM_MS
+#define BSPC_TRIPLE_TERM_MS 400  // window for the third BSPC tap
+#endif
+#ifndef BSPC_TRIPLE_HOLD_MS
+#define BSPC_TRIPLE_HOLD_MS 80  // hold after the third tap before repeat starts
+#endif
+#ifndef BSPC_REPEAT_INTERVAL_MS
+#define BSPC_REPEAT_INTERVAL_MS 35
+#endif
+#ifndef DEL_HOLD_VISUAL_MS
+#define DEL_HOLD_VISUAL_MS 140  // DEL_FKY held this long shows the command color
+#endif
+
+// clang-format off
+#define TUNE_PARAMS \
+    TUNE(tapping_term,      TAPPING_TERM,             80,  500) \
+    TUNE(hrm_offset,        0,                         0,  200) \
+    TUNE(hrm_gui_offset,    30,                        0,  200) \
+    TUNE(thumb_offset,      50,                        0,  200) \
+    TUNE(combo_term,        COMBO_TERM,               20,  300) \
+    TUNE(leader_timeout,    LEADER_TIMEOUT_MS,       200, 5000) \
+    TUNE(bspc_triple_term,  BSPC_TRIPLE_TERM_MS,     100, 1000) \
+    TUNE(bspc_triple_hold,  BSPC_TRIPLE_HOLD_MS,      10,  500) \
+    TUNE(bspc_repeat_ms,    BSPC_REPEAT_INTERVAL_MS,  10,  200) \
+    TUNE(del_hold_visual,   DEL_HOLD_VISUAL_MS,       20, 1000) \
+    TUNE(app_sw_release,    APP_SW_AUTORELEASE_MS,   200, 5000) \
+    TUNE(matrix_io_delay,   MATRIX_IO_DELAY,           1,  100) \
+    TUNE(mouse_base_speed,  MOUSE_ENGINE_BASE_SPEED,  10, 5000) \
+    TUNE(mouse_max_speed,   MOUSE_ENGINE_MAX_SPEED,   10, 8000) \
+    TUNE(mouse_time_to_max, MOUSE_ENGINE_TIME_TO_MAX,  1, 5000) \
+    TUNE(mouse_decay,       MOUSE_ENGINE_DECAY_MS,     0, 1000) \
+    TUNE(wheel_base,        MOUSE_ENGINE_WHEEL_BASE,   1,  100) \
+    TUNE(wheel_max,         MOUSE_ENGINE_WHEEL_MAX,    1,  100) \
+    TUNE(wheel_time_to_max, MOUSE_ENGINE_WHEEL_TIME_TO_MAX, 1, 5000) \
+    TUNE(acl0_pct,          MOUSE_ENGINE_ACL0_PCT,     1,  400) \
+    TUNE(acl1_pct,          MOUSE_ENGINE_ACL1_PCT,     1,  400) \
+    TUNE(acl2_pct,          MOUSE_ENGINE_ACL2_PCT,     1,  400)
+// clang-format on
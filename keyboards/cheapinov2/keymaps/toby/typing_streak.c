@@ -0,0 +1,84 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Typing streak: tap-hold keys resolve as taps while typing.
+
+#include QMK_KEYBOARD_H
+#include "typing_streak.h"
+#include "cycle_prof.h"
+#include "hrm_speculate.h"
+
+// Keys whose press was rewritten to a tap keycode, until their release
+static keypos_t streak_pos[TYPING_STREAK_HELD];
+static uint16_t streak_kc[TYPING_STREAK_HELD];
+static uint8_t  streak_held = 0;
+
+static uint16_t       streak_last_press = 0;
+static bool           streak_last_alpha = false;
+static bool           streak_on         = false;
+static deferred_token streak_end_token  = INVALID_DEFERRED_TOKEN;
+
+static uint16_t streak_tap_keycode(uint16_t keycode) {
+    if (IS_QK_MOD_TAP(keycode)) return QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    if (IS_QK_LAYER_TAP(keycode)) return QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    return keycode;
+}
+
+static uint32_t streak_end_cb(uint32_t trigger_time, void *cb_arg) {
+    CYCLE_PROF_SCOPE(PROF_DEFER);
+    streak_end_token = INVALID_DEFERRED_TOKEN;
+    streak_on        = false;
+    typing_streak_changed(false);
+    return 0;
+}
+
+bool typing_streak_active(void) {
+    return streak_last_alpha && timer_elapsed(streak_last_press) < TYPING_STREAK_MS;
+}
+
+void typing_streak_process(uint16_t keycode, keyrecord_t *record) {
+    keypos_t pos = record->event.key;
+
+    if (!record->event.pressed) {
+        for (uint8_t i = 0; i < streak_held; i++) {
+            if (streak_pos[i].row != pos.row || streak_pos[i].col != pos.col) continue;
+            record->keycode = streak_kc[i];
+            streak_pos[i]   = streak_pos[--streak_held];
+            streak_kc[i]    = streak_kc[streak_held];
+            return;
+        }
+        return;
+    }
+
+    // Modifiers reported only on speculation (undecided HRM in a roll) do not end the streak
+    bool in_streak = streak_last_alpha && TIMER_DIFF_16(record->event.time, streak_last_press) < TYPING_STREAK_MS &&
+                     !(get_mods() & ~hrm_speculate_mods());
+    uint16_t tap = streak_tap_keycode(keycode);
+
+    if (in_streak && tap != keycode && streak_held < TYPING_STREAK_HELD && typing_streak_eligible(keycode)) {
+        record->keycode          = tap;
+        streak_pos[streak_held]  = pos;
+        streak_kc[streak_held++] = tap;
+    }
+
+    streak_last_press = record->event.time;
+    streak_last_alpha = tap >= KC_A && tap <= KC_Z;
+
+    // LED feedback: one timer per streak, pushed out on every alpha press
+    if (!streak_last_alpha) {
+        if (streak_on) {
+            cancel_deferred_exec(streak_end_token);
+            streak_end_token = INVALID_DEFERRED_TOKEN;
+            streak_on        = false;
+            typing_streak_changed(false);
+        }
+    } else if (in_streak) {
+        if (!streak_on) {
+            streak_on        = true;
+            streak_end_token = defer_exec(TYPING_STREAK_MS, streak_end_cb, NULL);
+            typing_streak_changed(true);
+        } else {
+            extend_deferred_exec(streak_end_token, TYPING_STREAK_MS);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// Typing-streak fast path for Cheapino keymap (toby)
+// While typing (previous press was an alpha within TYPING_STREAK_MS and no
+// modifier is held; speculative HRM mods do not count), eligible tap-hold
+// keys (HRMs, thumb LTs) are rewritten to their tap keycode in
+// pre_process_record_user(): they skip tap-hold resolution entirely, so
+// rolls come out at once and never turn into mods.
+// The release of such a key is rewritten the same way.
+// typing_streak_active() is read by the LED code (TYPING_STREAK_HUE).
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+// A press this soon after an alpha press continues the streak (ms)
+#ifndef TYPING_STREAK_MS
+#define TYPING_STREAK_MS 150
+#endif
+
+// Eligible keys held down at once during a streak
+#define TYPING_STREAK_HELD 8
+
+// Provided by the keymap: tap-hold keys allowed to take the fast path
+bool typing_streak_eligible(uint16_t keycode);
+
+// Provided by the keymap: a streak started or ended (LED feedback)
+void typing_streak_changed(bool active);
+
+// Call from pre_process_record_user() before anything that buffers keys.
+void typing_streak_process(uint16_t keycode, keyrecord_t *record);
+
+// A streak is running (last alpha press within TYPING_STREAK_MS).
+bool typing_streak_active(void);
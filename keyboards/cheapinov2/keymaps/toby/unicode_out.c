@@ -0,0 +1,103 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-OS native Unicode input paths, queued as report steps.
+
+#include QMK_KEYBOARD_H
+#include "unicode_out.h"
+#include "out_queue.h"
+#include "os_profile.h"
+#include "toby_keycodes.h"
+
+typedef struct {
+    uint16_t cp;         // code point (hex path)
+    uint16_t opt[2];     // macOS Option sequence, KC_NO-padded
+    uint16_t compose[2]; // keys after the compose key
+    uint8_t  cp1252;     // Windows Alt+0nnn code, 0 = not in cp1252
+} uni_char_t;
+
+// [key][capital]. ẞ has no Option sequence nor cp1252 code: those paths type SS.
+static const uni_char_t uni_chars[][2] = {
+    [UNI_AE - UNI_AE] = {
+        {0x00E4, {A(KC_U), KC_A}, {S(KC_QUOT), KC_A}, 228},       // ä
+        {0x00C4, {A(KC_U), S(KC_A)}, {S(KC_QUOT), S(KC_A)}, 196}, // Ä
+    },
+    [UNI_OE - UNI_AE] = {
+        {0x00F6, {A(KC_U), KC_O}, {S(KC_QUOT), KC_O}, 246},       // ö
+        {0x00D6, {A(KC_U), S(KC_O)}, {S(KC_QUOT), S(KC_O)}, 214}, // Ö
+    },
+    [UNI_UE - UNI_AE] = {
+        {0x00FC, {A(KC_U), KC_U}, {S(KC_QUOT), KC_U}, 252},       // ü
+        {0x00DC, {A(KC_U), S(KC_U)}, {S(KC_QUOT), S(KC_U)}, 220}, // Ü
+    },
+    [UNI_SS - UNI_AE] = {
+        {0x00DF, {A(KC_S), KC_NO}, {KC_S, KC_S}, 223},            // ß
+        {0x1E9E, {S(KC_S), S(KC_S)}, {S(KC_S), S(KC_S)}, 0},      // ẞ
+    },
+};
+
+static const uint16_t uni_hex_keys[16] = {
+    KC_0, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F,
+};
+
+static const uint16_t uni_kp_keys[10] = {
+    KC_P0, KC_P1, KC_P2, KC_P3, KC_P4, KC_P5, KC_P6, KC_P7, KC_P8, KC_P9,
+};
+
+static void uni_taps(const uint16_t keys[2]) {
+    for (uint8_t i = 0; i < 2 && keys[i] != KC_NO; i++) {
+        out_queue_tap(keys[i], OUT_SRC_UNICODE);
+    }
+}
+
+static void uni_send(const uni_char_t *c) {
+    switch (os_profile->unicode_path) {
+        case UNI_PATH_OPTION:
+            uni_taps(c->opt);
+            break;
+        case UNI_PATH_COMPOSE:
+            out_queue_tap(os_profile->compose_key, OUT_SRC_UNICODE);
+            uni_taps(c->compose);
+            break;
+        case UNI_PATH_ALTCODE: {
+            if (!c->cp1252) {
+                uni_taps(c->opt);
+                break;
+            }
+            // Alt codes need NumLock on: toggle it around the code if it is off
+            bool num_off = !host_keyboard_led_state().num_lock;
+            if (num_off) out_queue_tap(KC_NUM, OUT_SRC_UNICODE);
+            out_queue_down(KC_LALT, OUT_SRC_UNICODE);
+            out_queue_tap(KC_P0, OUT_SRC_UNICODE);
+            out_queue_tap(uni_kp_keys[c->cp1252 / 100], OUT_SRC_UNICODE);
+            out_queue_tap(uni_kp_keys[c->cp1252 / 10 % 10], OUT_SRC_UNICODE);
+            out_queue_tap(uni_kp_keys[c->cp1252 % 10], OUT_SRC_UNICODE);
+            out_queue_up(KC_LALT, OUT_SRC_UNICODE);
+            if (num_off) out_queue_tap(KC_NUM, OUT_SRC_UNICODE);
+            break;
+        }
+        default:
+            out_queue_tap(C(S(KC_U)), OUT_SRC_UNICODE);
+            for (int8_t shift = 12; shift >= 0; shift -= 4) {
+                out_queue_tap(uni_hex_keys[(c->cp >> shift) & 0xF], OUT_SRC_UNICODE);
+            }
+            out_queue_tap(KC_SPC, OUT_SRC_UNICODE);
+            break;
+    }
+    out_queue_char(OUT_SRC_UNICODE);
+}
+
+// Longest sequence: Alt code with NumLock toggled (2 + 1 + 8 + 1 + 2 steps)
+#define UNI_MAX_STEPS 14
+
+bool unicode_out_process(uint16_t keycode, keyrecord_t *record) {
+    if (keycode < UNI_AE || keycode > UNI_SS) return true;
+    if (!record->event.pressed) return false;
+    if (out_queue_room() < UNI_MAX_STEPS) {
+        out_queue_drop();
+        return false;
+    }
+    bool capital = ((get_mods() | get_oneshot_mods()) & MOD_MASK_SHIFT) || host_keyboard_led_state().caps_lock || is_caps_word_on();
+    uni_send(&uni_chars[keycode - UNI_AE][capital]);
+    return false;
+}
@@ -0,0 +1,22 @@
+// Unicode output for Cheapino keymap (toby)
+// Umlaut keys (UNI_AE/OE/UE/SS, CMD layer) type through the shortest input
+// path the host has natively, chosen by the OS profile (os_profile.h):
+//   UNI_PATH_OPTION   macOS Option dead keys: Option+U, A            (4 reports)
+//   UNI_PATH_COMPOSE  Compose key, then e.g. " A (Linux XKB, WinCompose) (6)
+//   UNI_PATH_ALTCODE  Windows Alt + numpad cp1252 code, Alt+0228     (10)
+//   UNI_PATH_HEX      IBus Ctrl+Shift+U, hex code point, Space       (12)
+// Shift, Caps Lock or Caps Word select the capital. Sequences go through the
+// output queue (out_queue.h), which counts reports per character.
+
+#pragma once
+#include QMK_KEYBOARD_H
+
+typedef enum {
+    UNI_PATH_HEX,
+    UNI_PATH_COMPOSE,
+    UNI_PATH_OPTION,
+    UNI_PATH_ALTCODE,
+} uni_path_t;
+
+// Call from process_record_user(); false = umlaut key handled here.
+bool unicode_out_process(uint16_t keycode, keyrecord_t *record);
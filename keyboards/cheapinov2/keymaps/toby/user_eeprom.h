@@ -0,0 +1,25 @@
+// EEPROM user datablock layout for Cheapino keymap (toby)
+// The datablock (EECONFIG_USER_DATA_SIZE in config.h) lives in the RP2040
+// wear-leveled flash. Each module owns a fixed region; append new regions at
+// the end so existing data stays valid. The 32-bit user word is os_profile.c's.
+// Modules access their region through the write-behind cache (ee_cache.h).
+
+#pragma once
+
+// autocorrect_learn.c: learned typo pairs
+#define EE_AC_LEARN_OFFSET 0
+#define EE_AC_LEARN_SIZE   212
+
+// tap_adapt.c: learned tapping terms
+#define EE_TAP_ADAPT_OFFSET (EE_AC_LEARN_OFFSET + EE_AC_LEARN_SIZE)
+#define EE_TAP_ADAPT_SIZE   68
+
+// telemetry.c: usage counters arena
+#define EE_TELEMETRY_OFFSET (EE_TAP_ADAPT_OFFSET + EE_TAP_ADAPT_SIZE)
+#define EE_TELEMETRY_SIZE   2936
+
+// tune.c: runtime timing parameters (versioned)
+#define EE_TUNE_OFFSET (EE_TELEMETRY_OFFSET + EE_TELEMETRY_SIZE)
+#define EE_TUNE_SIZE   64
+
+#define EE_USER_DATA_END (EE_TUNE_OFFSET + EE_TUNE_SIZE)
@@ -28,24 +28,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "encoder.h"
 #include "ghosting.h"
 #include "print.h"
-
-// How long the scanning code waits for changed io to settle.
-// Adjust from default 30 to weigh up for increased time spent ghost-hunting.
-// (the rp2040 does not seem to have any problems with this value...)
-#define MATRIX_IO_DELAY 25
+#include "hot_path.h"
+#include "scan_stats.h"
+#include "sof_sync.h"
+#include "matrix_io.h"
+#include "cycle_prof.h"
 
 #define COL_SHIFTER ((uint16_t)1)
 
-static const pin_t row_pins[] = MATRIX_ROW_PINS;
-static const pin_t col_pins[] = MATRIX_COL_PINS;
+static const pin_t row_pins[] HOT_DATA(row_pins) = MATRIX_ROW_PINS;
+static const pin_t col_pins[] HOT_DATA(col_pins) = MATRIX_COL_PINS;
 static matrix_row_t previous_matrix[MATRIX_ROWS];
+uint8_t             matrix_io_delay = MATRIX_IO_DELAY;
 
-static void select_row(uint8_t row) {
+static void HOT_FUNC(select_row)(uint8_t row) {
     setPinOutput(row_pins[row]);
     writePinLow(row_pins[row]);
 }
 
-static void unselect_row(uint8_t row) { setPinInputHigh(row_pins[row]); }
+static void HOT_FUNC(unselect_row)(uint8_t row) { setPinInputHigh(row_pins[row]); }
 
 static void unselect_rows(void) {
     for (uint8_t x = 0; x < MATRIX_ROWS; x++) {
@@ -53,12 +54,12 @@ static void unselect_rows(void) {
     }
 }
 
-static void select_col(uint8_t col) {
+static void HOT_FUNC(select_col)(uint8_t col) {
     setPinOutput(col_pins[col]);
     writePinLow(col_pins[col]);
 }
 
-static void unselect_col(uint8_t col) {
+static void HOT_FUNC(unselect_col)(uint8_t col) {
     setPinInputHigh(col_pins[col]);
 }
 
@@ -68,10 +69,10 @@ static void unselect_cols(void) {
     }
 }
 
-static void read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
+static void HOT_FUNC(read_cols_on_row)(matrix_row_t current_matrix[], uint8_t current_row) {
     // Select row and wait for row selection to stabilize
     select_row(current_row);
-    wait_us(MATRIX_IO_DELAY);
+    wait_us(matrix_io_delay);
 
     // For each col...
     for (uint8_t col_index = 0; col_index < MATRIX_COLS / 2; col_index++) {
@@ -90,10 +91,10 @@ static void read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     unselect_row(current_row);
 }
 
-static void read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col) {
+static void HOT_FUNC(read_rows_on_col)(matrix_row_t current_matrix[], uint8_t current_col) {
     // Select col and wait for col selection to stabilize
     select_col(current_col*2);
-    wait_us(MATRIX_IO_DELAY);
+    wait_us(matrix_io_delay);
 
     uint16_t column_index_bitmask = COL_SHIFTER << (current_col * 2);
     // For each row...
@@ -119,34 +120,71 @@ void matrix_init_custom(void) {
     debounce_init(MATRIX_ROWS);
 }
 
-void store_old_matrix(matrix_row_t current_matrix[]) {
+void HOT_FUNC(store_old_matrix)(matrix_row_t current_matrix[]) {
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
         previous_matrix[i] = current_matrix[i];
     }
 }
 
-bool has_matrix_changed(matrix_row_t current_matrix[]) {
+bool HOT_FUNC(has_matrix_changed)(matrix_row_t current_matrix[]) {
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
         if (previous_matrix[i] != current_matrix[i]) return true;
     }
     return false;
 }
 
-bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+static scan_stats_t scan_stats = {.min_us = UINT16_MAX};
+
+const scan_stats_t *scan_stats_get(void) {
+    return &scan_stats;
+}
+
+void scan_stats_reset(void) {
+    memset(&scan_stats, 0, sizeof(scan_stats));
+    scan_stats.min_us = UINT16_MAX;
+}
+
+static void HOT_FUNC(scan_stats_add)(uint32_t us) {
+    uint32_t bucket = us / SCAN_HIST_WIDTH_US;
+    scan_stats.hist[bucket < SCAN_HIST_BUCKETS ? bucket : SCAN_HIST_BUCKETS - 1]++;
+    if (us > UINT16_MAX) us = UINT16_MAX;
+    if (us < scan_stats.min_us) scan_stats.min_us = us;
+    if (us > scan_stats.max_us) scan_stats.max_us = us;
+}
+
+bool HOT_FUNC(matrix_scan_custom)(matrix_row_t current_matrix[]) {
+    // SOF_ALIGNED_SCAN: one scan per USB frame, finishing just before the next poll
+    if (!sof_sync_scan_due()) {
+        CYCLE_PROF_BEGIN(PROF_DEBOUNCE);
+        return false;
+    }
+    uint32_t start = TIMER->TIMERAWL;
     store_old_matrix(current_matrix);
     // Set row, read cols
+    CYCLE_PROF_BEGIN(PROF_SCAN_ROWS);
     for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
         read_cols_on_row(current_matrix, current_row);
     }
+    CYCLE_PROF_END(PROF_SCAN_ROWS);
     // Set col, read rows
+    CYCLE_PROF_BEGIN(PROF_SCAN_COLS);
     for (uint8_t current_col = 0; current_col < MATRIX_COLS/2; current_col++) {
         read_rows_on_col(current_matrix, current_col);
     }
+    CYCLE_PROF_END(PROF_SCAN_COLS);
 
+    CYCLE_PROF_BEGIN(PROF_ENCODER);
     fix_encoder_action(current_matrix);
+    CYCLE_PROF_END(PROF_ENCODER);
 
+    CYCLE_PROF_BEGIN(PROF_GHOSTING);
     fix_ghosting(current_matrix);
-
-    return has_matrix_changed(current_matrix);
+    CYCLE_PROF_END(PROF_GHOSTING);
+
+    bool changed = has_matrix_changed(current_matrix);
+    uint32_t us      = TIMER->TIMERAWL - start;
+    scan_stats_add(us);
+    sof_sync_scan_done(us);
+    CYCLE_PROF_BEGIN(PROF_DEBOUNCE);
+    return changed;
 }
-
@@ -0,0 +1,17 @@
+//
+// Matrix pin settle time (matrix.c), adjustable at runtime
+//
+
+#pragma once
+
+#include <stdint.h>
+
+// How long the scanning code waits for changed io to settle (µs, default).
+// Adjust from default 30 to weigh up for increased time spent ghost-hunting.
+// (the rp2040 does not seem to have any problems with this value...)
+#ifndef MATRIX_IO_DELAY
+#    define MATRIX_IO_DELAY 25
+#endif
+
+// Current settle time; starts at MATRIX_IO_DELAY (the keymap's tune.c sets it)
+extern uint8_t matrix_io_delay;
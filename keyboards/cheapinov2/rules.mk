@@ -11,3 +11,5 @@ WEAR_LEVELING_DRIVER = rp2040_flash
 SRC += encoder.c
 SRC += ghosting.c
 SRC += matrix.c
+SRC += sof_sync.c
+SRC += cycle_prof.c
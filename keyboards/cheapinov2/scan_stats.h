@@ -0,0 +1,19 @@
+//
+// Matrix scan-time distribution (matrix_scan_custom() duration, RP2040 µs timer)
+//
+
+#pragma once
+
+#include <stdint.h>
+
+#define SCAN_HIST_BUCKETS  64
+#define SCAN_HIST_WIDTH_US 8  // last bucket also takes everything above
+
+typedef struct {
+    uint32_t hist[SCAN_HIST_BUCKETS];
+    uint16_t min_us;
+    uint16_t max_us;
+} scan_stats_t;
+
+const scan_stats_t *scan_stats_get(void);
+void                scan_stats_reset(void);
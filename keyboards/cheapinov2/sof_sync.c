@@ -0,0 +1,85 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// USB SOF timestamps, SOF-aligned scan scheduling and report slack statistics.
+
+#include "quantum.h"
+#include "hot_path.h"
+#include "sof_sync.h"
+
+static uint16_t    sof_frame  = 0xFFFF;  // last frame number seen
+static uint32_t    sof_time   = 0;       // µs timer at the poll that saw it
+static bool        sof_seen   = false;
+#ifdef SOF_ALIGNED_SCAN
+static uint16_t    scanned_in = 0xFFFF;  // frame of the last aligned scan
+#endif
+static sof_stats_t sof_stats  = {.min_slack_us = UINT16_MAX};
+
+static inline uint32_t sof_now(void) {
+    return TIMER->TIMERAWL;
+}
+
+static void HOT_FUNC(sof_poll)(uint32_t now) {
+    uint16_t frame = USB->SOFRD & 0x7FF;
+    if (frame != sof_frame) {
+        sof_frame = frame;
+        sof_time  = now;
+        sof_seen  = true;
+        sof_stats.frames++;
+    }
+}
+
+bool HOT_FUNC(sof_sync_scan_due)(void) {
+    uint32_t now = sof_now();
+    sof_poll(now);
+#ifdef SOF_ALIGNED_SCAN
+    uint32_t age = now - sof_time;
+    if (!sof_seen || age >= SOF_SYNC_TIMEOUT_US) return true;
+    if (scanned_in == sof_frame) return false;
+    uint32_t budget = sof_stats.scan_est_us + SOF_SYNC_PROCESS_US + SOF_SYNC_LEAD_US;
+    if (budget < SOF_PERIOD_US && age < SOF_PERIOD_US - budget) return false;
+    scanned_in = sof_frame;
+#endif
+    return true;
+}
+
+uint16_t sof_sync_frame(void) {
+    sof_poll(sof_now());
+    return sof_frame;
+}
+
+void HOT_FUNC(sof_sync_scan_done)(uint32_t us) {
+    // Decaying maximum: follows longer scans at once, shorter ones slowly
+    uint16_t est = sof_stats.scan_est_us;
+    est -= est / 64;
+    sof_stats.scan_est_us = us > est ? (uint16_t)MIN(us, UINT16_MAX) : est;
+    sof_stats.scans++;
+}
+
+void post_process_record_kb(uint16_t keycode, keyrecord_t *record) {
+    uint32_t now = sof_now();
+    sof_poll(now);
+    uint32_t age = now - sof_time;
+    sof_stats.events++;
+    if (!sof_seen || age >= SOF_PERIOD_US) {
+        sof_stats.unsynced++;
+    } else {
+        uint16_t slack  = SOF_PERIOD_US - age;
+        uint16_t bucket = slack / SOF_SLACK_WIDTH_US;
+        sof_stats.hist[bucket < SOF_SLACK_BUCKETS ? bucket : SOF_SLACK_BUCKETS - 1]++;
+        if (slack < sof_stats.min_slack_us) sof_stats.min_slack_us = slack;
+        if (slack > sof_stats.max_slack_us) sof_stats.max_slack_us = slack;
+    }
+    post_process_record_user(keycode, record);
+}
+
+const sof_stats_t *sof_stats_get(void) {
+    return &sof_stats;
+}
+
+void sof_stats_reset(void) {
+    uint16_t est = sof_stats.scan_est_us;
+    memset(&sof_stats, 0, sizeof(sof_stats));
+    sof_stats.min_slack_us = UINT16_MAX;
+    sof_stats.scan_est_us  = est;
+}
@@ -0,0 +1,61 @@
+//
+// USB start-of-frame sync (RP2040, full speed: one SOF per 1 ms frame)
+//
+// The SOF frame number register is polled from the scan loop; the first
+// poll that sees it change timestamps the SOF with the 1 MHz timer.
+// Every processed key event records its slack: µs left until the next SOF
+// when its report was ready (post_process_record_kb). Always on, so the
+// free-running scan can be compared with the aligned one.
+//
+// With SOF_ALIGNED_SCAN = yes in rules.mk, matrix_scan_custom() runs once
+// per frame, started so that scan + event processing end SOF_SYNC_LEAD_US
+// before the next SOF; the remaining loop passes skip the matrix. Without a
+// SOF for SOF_SYNC_TIMEOUT_US (suspended, not configured) it free-runs.
+//
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SOF_PERIOD_US 1000
+
+// Margin between report ready and the next SOF (µs)
+#ifndef SOF_SYNC_LEAD_US
+#    define SOF_SYNC_LEAD_US 60
+#endif
+
+// Budget for event processing after the scan (µs)
+#ifndef SOF_SYNC_PROCESS_US
+#    define SOF_SYNC_PROCESS_US 120
+#endif
+
+#ifndef SOF_SYNC_TIMEOUT_US
+#    define SOF_SYNC_TIMEOUT_US 3000
+#endif
+
+#define SOF_SLACK_BUCKETS  32
+#define SOF_SLACK_WIDTH_US 32  // last bucket also takes everything above
+
+typedef struct {
+    uint32_t hist[SOF_SLACK_BUCKETS];  // slack per key event
+    uint32_t events;
+    uint32_t unsynced;      // events with no SOF in the last frame
+    uint32_t scans;         // matrix scans run
+    uint32_t frames;        // SOFs seen
+    uint16_t min_slack_us;
+    uint16_t max_slack_us;
+    uint16_t scan_est_us;   // scan duration the schedule plans with
+} sof_stats_t;
+
+// Poll the SOF register. Returns true when matrix_scan_custom() should scan now.
+bool sof_sync_scan_due(void);
+
+// Current USB frame number (polls the SOF register); changes once per SOF.
+uint16_t sof_sync_frame(void);
+
+// Duration of the scan that just ran (feeds the schedule).
+void sof_sync_scan_done(uint32_t us);
+
+const sof_stats_t *sof_stats_get(void);
+void               sof_stats_reset(void);
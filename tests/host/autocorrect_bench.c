@@ -0,0 +1,120 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// process_autocorrect_ac() per key press against dictionary size. Built once
+// per size from build/ac_N/: a dictionary of N entries from dictgen.py
+// (the keymap's own 13, then synthetic English and German words), compiled
+// by autocorrect_gen.py next to a copy of autocorrect_ac.c so the copy picks
+// up that autocorrect_ac_data.h. Every size types the same text (words of the
+// 10000-entry dictionary, 1 in 10 as its typo); each press is timed.
+//
+// Stand-alone, without the rest of the keymap: the learner and the output
+// queue are stubs, so the rows show the automaton step alone. Table reads
+// per press are counted too: they are the step's work and stay flat, while
+// the ns rise once the tables outgrow the host's caches.
+//
+// usage: autocorrect_bench_N [-q] TEXT   (-q: no table header)
+
+#include "quantum.h"
+
+// Count the automaton's table reads
+static uint32_t reads;
+#undef pgm_read_word
+#undef pgm_read_dword
+#define pgm_read_word(p) (reads++, *(const uint16_t *)(p))
+#define pgm_read_dword(p) (reads++, *(const uint32_t *)(p))
+
+#include "autocorrect_ac.c"
+
+#include "bench.h"
+
+#define BENCH_PASSES 5
+
+// ---------------------------------------------------------------------------
+// Stubs for what autocorrect_ac.c calls
+// ---------------------------------------------------------------------------
+
+static uint32_t corrections;
+
+uint8_t get_mods(void) {
+    return 0;
+}
+
+uint8_t get_oneshot_mods(void) {
+    return 0;
+}
+
+void ac_learn_char(char c) {}
+void ac_learn_boundary(void) {}
+void ac_learn_backspace(void) {}
+void ac_learn_reset(void) {}
+
+uint8_t out_queue_room(void) {
+    return 255;
+}
+
+void out_queue_tap(uint16_t kc, out_src_t src) {}
+void out_queue_char(out_src_t src) {}
+void out_queue_drop(void) {}
+
+bool string_out_busy(void) {
+    return false;
+}
+
+bool string_out(const char *str) {
+    corrections++;
+    return true;
+}
+
+bool string_out_then(const char *str, uint16_t kc) {
+    corrections++;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static uint16_t keycode_for(char c) {
+    if (c >= 'a' && c <= 'z') return KC_A + (c - 'a');
+    if (c == '\'') return KC_QUOT;
+    if (c == '\n') return KC_ENT;
+    return KC_SPC;
+}
+
+int main(int argc, char **argv) {
+    bool header = !(argc > 1 && strcmp(argv[1], "-q") == 0);
+    FILE *f     = argc > 1 ? fopen(argv[argc - 1], "r") : NULL;
+    if (!f) {
+        fprintf(stderr, "usage: %s [-q] TEXT\n", argv[0]);
+        return 2;
+    }
+    static char text[1 << 20];
+    size_t      len = fread(text, 1, sizeof(text), f);
+    fclose(f);
+
+    static uint32_t samples[sizeof(text) * BENCH_PASSES];
+    size_t          n         = 0;
+    uint32_t        max_reads = 0;
+    autocorrect_ac_init();
+    for (int pass = 0; pass < BENCH_PASSES; pass++) {
+        corrections = reads = 0;
+        for (size_t i = 0; i < len; i++) {
+            keyrecord_t rec    = {.event = {.pressed = true, .type = KEY_EVENT}};
+            uint16_t    kc     = keycode_for(text[i]);
+            uint32_t    before = reads;
+            BENCH_TIME(samples, n, process_autocorrect_ac(kc, &rec));
+            n++;
+            if (reads - before > max_reads) max_reads = reads - before;
+        }
+    }
+
+    char name[64];
+    size_t bytes = sizeof(ac_children) + sizeof(ac_first) + sizeof(ac_fail) + sizeof(ac_output) + sizeof(ac_corrections) + sizeof(ac_text);
+    snprintf(name, sizeof(name), "%u entries, %u states, %zu KB", AC_CORRECTION_COUNT, AC_STATE_COUNT, (bytes + 512) / 1024);
+    if (header) {
+        printf("%zu key presses x %u passes\n", len, BENCH_PASSES);
+        bench_header("per key press");
+    }
+    bench_row(name, samples, n);
+    printf("%40s table reads per press %.2f, max %u; %u corrections\n", "", (double)reads / len, max_reads, corrections);
+    return 0;
+}
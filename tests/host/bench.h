@@ -0,0 +1,61 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-call timing for the host benchmarks (tests/host/*_bench.c)
+// Each call is timed on its own with the monotonic clock; the clock's own
+// cost (median of empty intervals) is subtracted, and the table shows mean,
+// median and p99 per call in ns. Host numbers rank the implementations; they
+// are not RP2040 timings (a Cortex-M0+ at 125 MHz is some 30x slower).
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline uint64_t bench_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Median cost of an empty bench_ns() interval
+static uint32_t bench_overhead(void) {
+    static uint32_t overhead = UINT32_MAX;
+    if (overhead != UINT32_MAX) return overhead;
+    enum { N = 10001 };
+    static uint32_t s[N];
+    for (int i = 0; i < N; i++) {
+        uint64_t t0 = bench_ns();
+        s[i]        = (uint32_t)(bench_ns() - t0);
+    }
+    qsort(s, N, sizeof(s[0]), bench_cmp);
+    return overhead = s[N / 2];
+}
+
+// Time one call of EXPR into SAMPLES[I]
+#define BENCH_TIME(samples, i, expr)                                   \
+    do {                                                               \
+        uint64_t _t0 = bench_ns();                                     \
+        expr;                                                          \
+        uint32_t _d  = (uint32_t)(bench_ns() - _t0);                   \
+        (samples)[i] = _d > bench_overhead() ? _d - bench_overhead() : 0; \
+    } while (0)
+
+static void bench_header(const char *what) {
+    printf("%-40s %10s %9s %9s %9s\n", what, "calls", "mean ns", "p50 ns", "p99 ns");
+}
+
+// Sorts SAMPLES
+static void bench_row(const char *name, uint32_t *samples, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) sum += samples[i];
+    qsort(samples, n, sizeof(samples[0]), bench_cmp);
+    printf("%-40s %10zu %9.1f %9u %9u\n", name, n, n ? sum / n : 0, n ? samples[n / 2] : 0, n ? samples[n * 99 / 100] : 0);
+}
@@ -0,0 +1,236 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// combo_index.c against QMK's combo walk with BENCH_COMBOS synthetic combos
+// of 2-4 keys over the 36 positions. One seeded event stream (typing, rolls
+// and chords of defined combos) goes through both engines; every event is
+// timed on its own.
+//
+// The QMK walk is process_combo()'s per-event loop (quantum/process_keycode/
+// process_combo.c): every combo's COMBO_END-terminated key list is searched
+// for the keycode, its state bits updated and tested for all-down. The key
+// buffer, timers and term resolution around it are left out, so it is a
+// lower bound on QMK's cost. combo_index.c runs whole, resolver and buffer
+// included, with stubs for the timer and tap-hold hand-off (a combo's term
+// never expires; attempts end on the next key).
+//
+// Built on its own, without the rest of the keymap.
+//
+// usage: combo_bench [SEED]
+
+#include "quantum.h"
+
+// Stand-alone: no cycle_prof table to link against
+#undef CYCLE_PROF
+#undef COMBO_COUNT
+#define BENCH_COMBOS 256
+#define COMBO_COUNT BENCH_COMBOS
+#include "combo_index.c"
+
+#include "bench.h"
+
+#define BENCH_KEYS 36
+#define BENCH_EVENTS 20000
+#define BENCH_PASSES 10
+
+// Key N of the base layer is KC_A + N; N walks the LAYOUT rows
+#define BK(n) (KC_A + (n) % BENCH_KEYS)
+
+// Combo I: 2, 3, 3 or 4 keys (I % 4) at a stride of 1-11 positions, so
+// its keys are distinct; combos may share keys and key sets, as in QMK
+#define BENCH_STRIDE(i) (1 + (i) % 11)
+#define BENCH_KEY(i, j) BK((i) * 5 + (j) * BENCH_STRIDE(i))
+// clang-format off
+#define BENCH_COMBO(i) [i] = {{BENCH_KEY(i, 0), BENCH_KEY(i, 1), \
+                               (i) % 4 ? BENCH_KEY(i, 2) : KC_NO, (i) % 4 == 3 ? BENCH_KEY(i, 3) : KC_NO}},
+#define BENCH_COMBO4(i)  BENCH_COMBO(i) BENCH_COMBO((i) + 1) BENCH_COMBO((i) + 2) BENCH_COMBO((i) + 3)
+#define BENCH_COMBO16(i) BENCH_COMBO4(i) BENCH_COMBO4((i) + 4) BENCH_COMBO4((i) + 8) BENCH_COMBO4((i) + 12)
+#define BENCH_COMBO64(i) BENCH_COMBO16(i) BENCH_COMBO16((i) + 16) BENCH_COMBO16((i) + 32) BENCH_COMBO16((i) + 48)
+// clang-format on
+
+const combo_def_t combo_defs[COMBO_COUNT] = {BENCH_COMBO64(0) BENCH_COMBO64(64) BENCH_COMBO64(128) BENCH_COMBO64(192)};
+
+_Static_assert(COMBO_COUNT == 256, "BENCH_COMBO64 x4 fills 256 combos");
+
+// ---------------------------------------------------------------------------
+// Stubs for what combo_index.c calls
+// ---------------------------------------------------------------------------
+
+static uint32_t fired, replayed;
+
+static keypos_t bench_pos(uint8_t n) {
+    // LAYOUT_split_3x5_3: right half rows 0-2 cols 0-5, left half rows 4-6 cols 6-11
+    return n < 18 ? (keypos_t){.row = n / 6, .col = n % 6} : (keypos_t){.row = 4 + (n - 18) / 6, .col = 6 + (n - 18) % 6};
+}
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (key.row < 3 && key.col < 6) return BK(key.row * 6 + key.col);
+    if (key.row >= 4 && key.row < 7 && key.col >= 6) return BK(18 + (key.row - 4) * 6 + key.col - 6);
+    return KC_NO;
+}
+
+void process_combo_event(uint16_t combo_index, bool pressed) {
+    if (pressed) fired++;
+}
+
+void action_tapping_process(keyrecord_t record) {
+    replayed++;
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    return 1;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    return true;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return 0;
+}
+
+void combo_resolver_attempt(void) {}
+
+uint16_t combo_resolver_term(uint16_t combo_index) {
+    return COMBO_TERM;
+}
+
+void combo_resolver_fired(uint16_t combo_index) {}
+
+void combo_resolver_flushed(uint16_t added_ms, bool early) {}
+
+// ---------------------------------------------------------------------------
+// QMK's walk
+// ---------------------------------------------------------------------------
+
+#define COMBO_END KC_NO
+
+typedef struct {
+    const uint16_t *keys;
+    uint16_t        state;
+    bool            active;
+} qmk_combo_t;
+
+static qmk_combo_t key_combos[COMBO_COUNT];
+
+static bool qmk_find_key_index_and_count(const uint16_t *keys, uint16_t keycode, uint16_t *key_index, uint8_t *key_count) {
+    while (true) {
+        uint16_t key = keys[*key_count];  // pgm_read_word() on AVR
+        if (key == COMBO_END) break;
+        if (keycode == key) *key_index = *key_count;
+        (*key_count)++;
+    }
+    return *key_index != (uint16_t)-1;
+}
+
+static bool qmk_process_single_combo(qmk_combo_t *combo, uint16_t keycode, keyrecord_t *record) {
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    // Every combo's list is walked on every event
+    if (!qmk_find_key_index_and_count(combo->keys, keycode, &key_index, &key_count)) return false;
+    if (record->event.pressed) {
+        combo->state |= 1u << key_index;
+        if (!combo->active && combo->state == (1u << key_count) - 1) {
+            combo->active = true;
+            fired++;
+        }
+    } else {
+        combo->state &= ~(1u << key_index);
+        if (!combo->state) combo->active = false;
+    }
+    return true;
+}
+
+static bool qmk_process_combo(uint16_t keycode, keyrecord_t *record) {
+    bool is_combo_key = false;
+    for (uint16_t i = 0; i < COMBO_COUNT; i++) {
+        is_combo_key |= qmk_process_single_combo(&key_combos[i], keycode, record);
+    }
+    return !is_combo_key;
+}
+
+// ---------------------------------------------------------------------------
+// Event stream
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t key;
+    bool    pressed;
+} bench_event_t;
+
+static bench_event_t events[BENCH_EVENTS + 2 * COMBO_MAX_KEYS];
+static uint32_t      event_count;
+static uint32_t      rng;
+
+static uint32_t next(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static void emit(uint8_t key, bool pressed) {
+    events[event_count++] = (bench_event_t){key, pressed};
+}
+
+static uint8_t key_number(uint16_t kc) {
+    return (uint8_t)(kc - KC_A);
+}
+
+// One in eight strokes is a defined combo, one in four of the rest a roll
+static void make_events(void) {
+    while (event_count < BENCH_EVENTS) {
+        uint32_t kind = next() % 8;
+        if (kind == 0) {
+            const combo_def_t *c = &combo_defs[next() % COMBO_COUNT];
+            uint8_t            n = 0;
+            while (n < COMBO_MAX_KEYS && c->keys[n] != KC_NO) emit(key_number(c->keys[n++]), true);
+            for (uint8_t i = 0; i < n; i++) emit(key_number(c->keys[i]), false);
+        } else if (kind < 3) {
+            uint8_t a = next() % BENCH_KEYS, b = (a + 1 + next() % (BENCH_KEYS - 1)) % BENCH_KEYS;
+            emit(a, true);
+            emit(b, true);
+            emit(a, false);
+            emit(b, false);
+        } else {
+            uint8_t a = next() % BENCH_KEYS;
+            emit(a, true);
+            emit(a, false);
+        }
+    }
+}
+
+static uint32_t samples[BENCH_EVENTS * BENCH_PASSES + 2 * COMBO_MAX_KEYS * BENCH_PASSES];
+
+typedef bool (*bench_engine_t)(uint16_t keycode, keyrecord_t *record);
+
+static volatile bool sink;
+
+static void run(const char *name, bench_engine_t engine) {
+    size_t n = 0;
+    fired = replayed = 0;
+    for (int pass = 0; pass < BENCH_PASSES; pass++) {
+        for (uint32_t i = 0; i < event_count; i++) {
+            keyrecord_t rec = {.event = {.key = bench_pos(events[i].key), .pressed = events[i].pressed, .type = KEY_EVENT}};
+            BENCH_TIME(samples, n, sink = engine(BK(events[i].key), &rec));
+            n++;
+        }
+    }
+    bench_row(name, samples, n);
+}
+
+int main(int argc, char **argv) {
+    rng = (argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 1) * 2654435761u + 1;
+    make_events();
+
+    combo_index_init();
+    for (uint16_t i = 0; i < COMBO_COUNT; i++) key_combos[i].keys = combo_defs[i].keys;
+
+    printf("%u combos of 2-4 keys over %u positions, %u events x %u passes\n", COMBO_COUNT, BENCH_KEYS, event_count, BENCH_PASSES);
+    bench_header("per key event");
+    run("QMK combo walk", qmk_process_combo);
+    uint32_t qmk_fired = fired;
+    run("combo_index_process", combo_index_process);
+    printf("combos fired: QMK walk %u, combo_index %u\n", qmk_fired, fired);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+# Copyright 2024 Toby
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Synthetic autocorrect dictionaries and typing text for autocorrect_bench.c.
+
+Usage:
+  python3 dictgen.py ENTRIES            dictionary (autocorrect_dictionary.txt format)
+  python3 dictgen.py --text WORDS       text typed by the benchmark
+
+The dictionary starts with the keymap's own autocorrect_dictionary.txt, then
+adds English- and German-like words built from syllables, each with one
+typo (swapped, dropped or doubled letter) as `:typo: -> word`. The sequence is
+seeded, so a smaller dictionary is a prefix of a larger one. The text mixes
+words of the largest dictionary with 1 in 10 typed as their typo.
+"""
+
+import random
+import sys
+from pathlib import Path
+
+MAX_ENTRIES = 10000
+KEYMAP_DICT = Path(__file__).resolve().parent / "../../keyboards/cheapinov2/keymaps/toby/autocorrect_dictionary.txt"
+
+# fmt: off
+ENGLISH = ["the", "con", "ter", "in", "ing", "er", "ex", "pro", "re", "com", "ment", "tion", "able", "ly", "ness",
+           "per", "ver", "sub", "trans", "inter", "form", "port", "struct", "graph", "light", "work", "play", "set",
+           "ward", "less", "ful", "ous", "ive", "al", "ic", "ate", "ure", "ight", "ough", "ance", "ence", "ship"]
+GERMAN  = ["ver", "ge", "be", "ent", "zer", "un", "ung", "heit", "keit", "schaft", "lich", "isch", "bar", "sam",
+           "en", "er", "ern", "stein", "haus", "berg", "wald", "land", "zeit", "arbeit", "schrei", "spiel", "werk",
+           "stadt", "strasse", "bahn", "fahr", "kraft", "stell", "steh", "sprech", "nehm", "bring", "denk", "lauf"]
+# fmt: on
+
+
+def keymap_entries():
+    entries = []
+    for raw in KEYMAP_DICT.read_text(encoding="utf-8").splitlines():
+        line = raw.split("#", 1)[0].strip()
+        if "->" in line:
+            typo, word = (part.strip() for part in line.split("->", 1))
+            entries.append((typo, word))
+    return entries
+
+
+def typo_of(word, rng):
+    i = rng.randrange(len(word) - 1)
+    kind = rng.randrange(3)
+    if kind == 0:
+        return word[:i] + word[i + 1] + word[i] + word[i + 2 :]
+    if kind == 1:
+        return word[:i] + word[i + 1 :]
+    return word[: i + 1] + word[i] + word[i + 1 :]
+
+
+def entries(count):
+    rng = random.Random(2024)
+    result = keymap_entries()
+    typos = {t for t, _ in result}
+    words = {w for _, w in result}
+    while len(result) < count:
+        syllables = ENGLISH if rng.randrange(2) else GERMAN
+        word = "".join(rng.choice(syllables) for _ in range(rng.randint(2, 4)))
+        if word in words:
+            continue
+        typo = typo_of(word, rng)
+        if typo == word or f":{typo}:" in typos or typo in words:
+            continue
+        words.add(word)
+        typos.add(f":{typo}:")
+        result.append((f":{typo}:", word))
+    return result[:count]
+
+
+def main():
+    if len(sys.argv) == 3 and sys.argv[1] == "--text":
+        rng = random.Random(7)
+        pool = entries(MAX_ENTRIES)
+        out = []
+        for n in range(int(sys.argv[2])):
+            typo, word = rng.choice(pool)
+            out.append(typo.strip(":") if rng.randrange(10) == 0 else word)
+            out.append("\n" if n % 12 == 11 else " ")
+        sys.stdout.write("".join(out))
+    elif len(sys.argv) == 2:
+        count = int(sys.argv[1])
+        if count > MAX_ENTRIES:
+            sys.exit(f"at most {MAX_ENTRIES} entries")
+        width = max(len(t) for t, _ in entries(count))
+        for typo, word in entries(count):
+            print(f"{typo:<{width}} -> {word}")
+    else:
+        sys.exit(__doc__)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,1176 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// QMK core emulation for the host build: virtual clock, deferred executors,
+// reports, layers, tap-hold, leader and the record pipeline, following QMK's
+// own code paths (action.c, action_tapping.c, action_util.c, leader.c,
+// deferred_exec.c) closely enough that the keymap sees the same call order.
+// Not emulated: Caps Word, key overrides, Repeat Key, one-shot mods, retro
+// tapping and Chordal Hold's multi-key buffer rules (only the first press
+// after a tap-hold key is checked for the same hand).
+
+#include <stdio.h>
+#include "quantum.h"
+#include "host_qmk.h"
+#include "matrix_io.h"
+#include "scan_stats.h"
+
+// ---------------------------------------------------------------------------
+// Virtual clock
+// ---------------------------------------------------------------------------
+
+static uint32_t host_us          = 0;
+static uint32_t host_last_input  = 0;  // ms of the last matrix event
+
+host_timer_hw_t *host_timer_hw(void) {
+    static host_timer_hw_t hw;
+    hw.TIMERAWH = 0;
+    hw.TIMERAWL = host_us;
+    return &hw;
+}
+
+// Polling the frame number costs a µs, so busy-waits for the next SOF end
+host_usb_hw_t *host_usb_hw(void) {
+    static host_usb_hw_t hw;
+    host_us++;
+    hw.SOFRD = (host_us / 1000) & 0x7FF;
+    return &hw;
+}
+
+#ifndef __x86_64__
+#    include <time.h>
+uint32_t host_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+#endif
+
+uint16_t timer_read(void) {
+    return (uint16_t)(host_us / 1000);
+}
+
+uint32_t timer_read32(void) {
+    return host_us / 1000;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return TIMER_DIFF_32(timer_read32(), last);
+}
+
+void wait_ms(uint32_t ms) {
+    host_us += ms * 1000;
+}
+
+void wait_us(uint32_t us) {
+    host_us += us;
+}
+
+uint32_t last_input_activity_elapsed(void) {
+    return timer_read32() - host_last_input;
+}
+
+uint32_t host_now(void) {
+    return timer_read32();
+}
+
+// ---------------------------------------------------------------------------
+// Deferred executors (deferred_exec.c)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    deferred_token         token;
+    uint32_t               trigger_time;
+    deferred_exec_callback callback;
+    void                  *cb_arg;
+} host_executor_t;
+
+static host_executor_t executors[MAX_DEFERRED_EXECUTORS];
+static deferred_token  current_token  = 0;
+static uint32_t        last_exec_time = 0;
+
+static host_executor_t *executor_find(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN) return NULL;
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        if (executors[i].token == token) return &executors[i];
+    }
+    return NULL;
+}
+
+static deferred_token allocate_token(void) {
+    deferred_token first = ++current_token;
+    while (current_token == INVALID_DEFERRED_TOKEN || executor_find(current_token)) {
+        ++current_token;
+        if (current_token == first) return INVALID_DEFERRED_TOKEN;
+    }
+    return current_token;
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    // QMK rejects zero delays
+    if (!callback || delay_ms == 0) return INVALID_DEFERRED_TOKEN;
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        host_executor_t *entry = &executors[i];
+        if (entry->token != INVALID_DEFERRED_TOKEN) continue;
+        deferred_token token = allocate_token();
+        if (token == INVALID_DEFERRED_TOKEN) return INVALID_DEFERRED_TOKEN;
+        *entry = (host_executor_t){token, timer_read32() + delay_ms, callback, cb_arg};
+        return token;
+    }
+    fprintf(stderr, "host: out of deferred executors\n");
+    return INVALID_DEFERRED_TOKEN;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+    host_executor_t *entry = executor_find(token);
+    if (!entry || delay_ms == 0) return false;
+    entry->trigger_time = timer_read32() + delay_ms;
+    return true;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    host_executor_t *entry = executor_find(token);
+    if (!entry) return false;
+    *entry = (host_executor_t){0};
+    return true;
+}
+
+static void deferred_exec_task(void) {
+    uint32_t now = timer_read32();
+    if ((int32_t)TIMER_DIFF_32(now, last_exec_time) <= 0) return;
+    last_exec_time = now;
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        host_executor_t *entry = &executors[i];
+        if (entry->token == INVALID_DEFERRED_TOKEN || (int32_t)TIMER_DIFF_32(entry->trigger_time, now) > 0) continue;
+        uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+        if (delay_ms > 0) {
+            entry->trigger_time += delay_ms;
+        } else {
+            *entry = (host_executor_t){0};
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Host driver and report sink
+// ---------------------------------------------------------------------------
+
+static void (*host_sink)(const host_report_t *report) = NULL;
+static led_t host_leds = {0};
+
+void host_set_sink(void (*sink)(const host_report_t *report)) {
+    host_sink = sink;
+}
+
+static void host_emit(host_report_t *r) {
+    r->time = timer_read32();
+    if (host_sink) host_sink(r);
+}
+
+static uint8_t host_driver_leds(void) {
+    return host_leds.raw;
+}
+
+static void host_driver_send_keyboard(report_keyboard_t *report) {
+    host_report_t r = {.kind = HOST_REPORT_KEYBOARD};
+    r.keyboard.mods = report->mods;
+    for (int i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t k = report->keys[i];
+        if (k && (k >> 3) < NKRO_REPORT_BITS) r.keyboard.bits[k >> 3] |= 1 << (k & 7);
+    }
+    host_emit(&r);
+}
+
+static void host_driver_send_nkro(report_nkro_t *report) {
+    host_report_t r = {.kind = HOST_REPORT_KEYBOARD, .keyboard = *report};
+    host_emit(&r);
+}
+
+static void host_driver_send_mouse(report_mouse_t *report) {
+    host_report_t r = {.kind = HOST_REPORT_MOUSE, .mouse = *report};
+    host_emit(&r);
+}
+
+#define REPORT_ID_SYSTEM 3
+#define REPORT_ID_CONSUMER 4
+
+static void host_driver_send_extra(report_extra_t *report) {
+    host_report_t r = {.kind = report->report_id == REPORT_ID_SYSTEM ? HOST_REPORT_SYSTEM : HOST_REPORT_CONSUMER, .usage = report->usage};
+    host_emit(&r);
+}
+
+static host_driver_t  host_log_driver = {host_driver_leds, host_driver_send_keyboard, host_driver_send_nkro, host_driver_send_mouse, host_driver_send_extra};
+static host_driver_t *host_driver     = &host_log_driver;
+
+host_driver_t *host_get_driver(void) {
+    return host_driver;
+}
+
+void host_set_driver(host_driver_t *driver) {
+    host_driver = driver;
+}
+
+led_t host_keyboard_led_state(void) {
+    return (led_t){.raw = host_driver->keyboard_leds()};
+}
+
+void host_set_leds(led_t leds) {
+    host_leds = leds;
+}
+
+void host_mouse_send(report_mouse_t *report) {
+    host_driver->send_mouse(report);
+}
+
+static void host_extra_send(uint8_t report_id, uint16_t usage) {
+    static uint16_t last[2];
+    uint16_t       *prev = &last[report_id == REPORT_ID_SYSTEM];
+    if (usage == *prev) return;
+    *prev                 = usage;
+    report_extra_t report = {.report_id = report_id, .usage = usage};
+    host_driver->send_extra(&report);
+}
+
+// ---------------------------------------------------------------------------
+// Keyboard report, modifiers, keys (action_util.c, action.c)
+// ---------------------------------------------------------------------------
+
+keymap_config_t keymap_config;
+
+static uint8_t       real_mods = 0;
+static uint8_t       weak_mods = 0;
+static report_nkro_t nkro_report;
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+void add_mods(uint8_t mods) {
+    real_mods |= mods;
+}
+void del_mods(uint8_t mods) {
+    real_mods &= ~mods;
+}
+void set_mods(uint8_t mods) {
+    real_mods = mods;
+}
+void clear_mods(void) {
+    real_mods = 0;
+}
+uint8_t get_weak_mods(void) {
+    return weak_mods;
+}
+void add_weak_mods(uint8_t mods) {
+    weak_mods |= mods;
+}
+void del_weak_mods(uint8_t mods) {
+    weak_mods &= ~mods;
+}
+void set_weak_mods(uint8_t mods) {
+    weak_mods = mods;
+}
+void clear_weak_mods(void) {
+    weak_mods = 0;
+}
+uint8_t get_oneshot_mods(void) {
+    return 0;
+}
+
+bool is_caps_word_on(void) {
+    return false;
+}
+
+void add_key(uint8_t key) {
+    if ((key >> 3) < NKRO_REPORT_BITS) nkro_report.bits[key >> 3] |= 1 << (key & 7);
+}
+
+void del_key(uint8_t key) {
+    if ((key >> 3) < NKRO_REPORT_BITS) nkro_report.bits[key >> 3] &= ~(1 << (key & 7));
+}
+
+static bool is_key_pressed(uint8_t key) {
+    return (key >> 3) < NKRO_REPORT_BITS && (nkro_report.bits[key >> 3] & (1 << (key & 7)));
+}
+
+// Sent only when it differs from the last one (send_nkro_report/send_6kro_report)
+void send_keyboard_report(void) {
+    nkro_report.mods = real_mods | weak_mods;
+    if (keymap_config.nkro) {
+        static report_nkro_t last;
+        if (memcmp(&nkro_report, &last, sizeof(last)) == 0) return;
+        last = nkro_report;
+        host_driver->send_nkro(&nkro_report);
+    } else {
+        static report_keyboard_t last;
+        report_keyboard_t        report = {.mods = nkro_report.mods};
+        for (int k = 0, n = 0; k < NKRO_REPORT_BITS * 8 && n < KEYBOARD_REPORT_KEYS; k++) {
+            if (is_key_pressed(k)) report.keys[n++] = k;
+        }
+        if (memcmp(&report, &last, sizeof(last)) == 0) return;
+        last = report;
+        host_driver->send_keyboard(&report);
+    }
+}
+
+void register_mods(uint8_t mods) {
+    if (mods) {
+        add_mods(mods);
+        send_keyboard_report();
+    }
+}
+void unregister_mods(uint8_t mods) {
+    if (mods) {
+        del_mods(mods);
+        send_keyboard_report();
+    }
+}
+void register_weak_mods(uint8_t mods) {
+    if (mods) {
+        add_weak_mods(mods);
+        send_keyboard_report();
+    }
+}
+void unregister_weak_mods(uint8_t mods) {
+    if (mods) {
+        del_weak_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+// Mouse buttons (mousekey.c); motion and wheel belong to mouse_engine.c
+static report_mouse_t mouse_report;
+
+void mousekey_on(uint8_t code) {
+    if (code >= MS_BTN1 && code <= MS_BTN8) mouse_report.buttons |= 1 << (code - MS_BTN1);
+}
+void mousekey_off(uint8_t code) {
+    if (code >= MS_BTN1 && code <= MS_BTN8) mouse_report.buttons &= ~(1 << (code - MS_BTN1));
+}
+void mousekey_send(void) {
+    host_mouse_send(&mouse_report);
+}
+report_mouse_t mousekey_get_report(void) {
+    return mouse_report;
+}
+
+static uint16_t keycode_to_consumer(uint8_t code) {
+    switch (code) {
+        case KC_AUDIO_MUTE:       return 0x00E2;
+        case KC_AUDIO_VOL_UP:     return 0x00E9;
+        case KC_AUDIO_VOL_DOWN:   return 0x00EA;
+        case KC_MEDIA_NEXT_TRACK: return 0x00B5;
+        case KC_MEDIA_PREV_TRACK: return 0x00B6;
+        case KC_MEDIA_STOP:       return 0x00B7;
+        case KC_MEDIA_PLAY_PAUSE: return 0x00CD;
+        default:                  return 0;
+    }
+}
+
+void register_code(uint8_t code) {
+    if (code == KC_NO) return;
+    if (IS_BASIC_KEYCODE(code)) {
+        // Force a new key press if the key is already pressed
+        if (is_key_pressed(code)) {
+            del_key(code);
+            send_keyboard_report();
+        }
+        add_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_SYSTEM_KEYCODE(code)) {
+        host_extra_send(REPORT_ID_SYSTEM, 0x81 + (code - KC_SYSTEM_POWER));
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        host_extra_send(REPORT_ID_CONSUMER, keycode_to_consumer(code));
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey_on(code);
+        mousekey_send();
+    }
+}
+
+void unregister_code(uint8_t code) {
+    if (code == KC_NO) return;
+    if (IS_BASIC_KEYCODE(code)) {
+        del_key(code);
+        send_keyboard_report();
+    } else if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+        send_keyboard_report();
+    } else if (IS_SYSTEM_KEYCODE(code)) {
+        host_extra_send(REPORT_ID_SYSTEM, 0);
+    } else if (IS_CONSUMER_KEYCODE(code)) {
+        host_extra_send(REPORT_ID_CONSUMER, 0);
+    } else if (IS_MOUSE_KEYCODE(code)) {
+        mousekey_off(code);
+        mousekey_send();
+    }
+}
+
+void tap_code(uint8_t code) {
+    register_code(code);
+    unregister_code(code);
+}
+
+// QK_MODS bits of a 16-bit keycode as report modifier bits
+static uint8_t mods16_bits(uint16_t code) {
+    if (!IS_QK_MODS(code)) return 0;
+    uint8_t m = QK_MODS_GET_MODS(code);
+    return (m & 0x10) ? (m & 0x0F) << 4 : m;
+}
+
+void register_code16(uint16_t code) {
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        register_mods(mods16_bits(code));
+    } else {
+        register_weak_mods(mods16_bits(code));
+    }
+    register_code(code);
+}
+
+void unregister_code16(uint16_t code) {
+    unregister_code(code);
+    if (IS_MODIFIER_KEYCODE(code) || code == KC_NO) {
+        unregister_mods(mods16_bits(code));
+    } else {
+        unregister_weak_mods(mods16_bits(code));
+    }
+}
+
+void tap_code16(uint16_t code) {
+    register_code16(code);
+    unregister_code16(code);
+}
+
+// ---------------------------------------------------------------------------
+// Layers and keymap lookup (action_layer.c, keymap_common.c)
+// ---------------------------------------------------------------------------
+
+layer_state_t layer_state         = 0;
+layer_state_t default_layer_state = 1;
+
+void layer_state_set(layer_state_t state) {
+    layer_state = layer_state_set_user(state);
+}
+
+void layer_on(uint8_t layer) {
+    layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+    layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+bool layer_state_is(uint8_t layer) {
+    if (!layer_state) return layer == 0;
+    return (layer_state & ((layer_state_t)1 << layer)) != 0;
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3) {
+    layer_state_t mask12 = ((layer_state_t)1 << layer1) | ((layer_state_t)1 << layer2);
+    layer_state_t mask3  = (layer_state_t)1 << layer3;
+    return (state & mask12) == mask12 ? (state | mask3) : (state & ~mask3);
+}
+
+// Topmost active layer with a non-transparent key
+static uint8_t layer_switch_get_layer(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+    for (int8_t i = 31; i >= 0; i--) {
+        if ((layers & ((layer_state_t)1 << i)) && keymap_key_to_keycode(i, key) != KC_TRNS) return i;
+    }
+    return 0;
+}
+
+// Source layer of each pressed key, so its release uses the same keycode
+static uint8_t source_layers[MATRIX_ROWS][MATRIX_COLS];
+
+static uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
+    if (event.key.row >= MATRIX_ROWS || event.key.col >= MATRIX_COLS) return KC_NO;
+    uint8_t layer;
+    if (event.pressed && update_layer_cache) {
+        layer                                      = layer_switch_get_layer(event.key);
+        source_layers[event.key.row][event.key.col] = layer;
+    } else {
+        layer = source_layers[event.key.row][event.key.col];
+    }
+    return keymap_key_to_keycode(layer, event.key);
+}
+
+static uint16_t get_record_keycode(keyrecord_t *record, bool update_layer_cache) {
+    if (record->keycode) return record->keycode;
+    return get_event_keycode(record->event, update_layer_cache);
+}
+
+// keycode_config()/mod_config(): Ctrl/GUI swap for keymap-derived actions
+static uint16_t keycode_config(uint16_t keycode) {
+    switch (keycode) {
+        case KC_LEFT_CTRL:  return keymap_config.swap_lctl_lgui ? KC_LEFT_GUI : keycode;
+        case KC_LEFT_GUI:   return keymap_config.swap_lctl_lgui ? KC_LEFT_CTRL : keycode;
+        case KC_RIGHT_CTRL: return keymap_config.swap_rctl_rgui ? KC_RIGHT_GUI : keycode;
+        case KC_RIGHT_GUI:  return keymap_config.swap_rctl_rgui ? KC_RIGHT_CTRL : keycode;
+        default:            return keycode;
+    }
+}
+
+static uint8_t mod_config(uint8_t mod) {
+    if (keymap_config.swap_lctl_lgui) {
+        if ((mod & MOD_RGUI) == MOD_LGUI) {
+            mod &= ~MOD_LGUI;
+            mod |= MOD_LCTL;
+        } else if ((mod & MOD_RCTL) == MOD_LCTL) {
+            mod &= ~MOD_LCTL;
+            mod |= MOD_LGUI;
+        }
+    }
+    if (keymap_config.swap_rctl_rgui) {
+        if ((mod & MOD_RGUI) == MOD_RGUI) {
+            mod &= ~MOD_RGUI;
+            mod |= MOD_RCTL;
+        } else if ((mod & MOD_RCTL) == MOD_RCTL) {
+            mod &= ~MOD_RCTL;
+            mod |= MOD_RGUI;
+        }
+    }
+    return mod;
+}
+
+static uint8_t mods5_bits(uint8_t mods) {
+    return (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+}
+
+// ---------------------------------------------------------------------------
+// Leader (leader.c, process_leader.c)
+// ---------------------------------------------------------------------------
+
+static bool     leading     = false;
+static uint16_t leader_time = 0;
+
+void leader_start(void) {
+    if (leading) return;
+    leader_start_user();
+    leading     = true;
+    leader_time = timer_read();
+}
+
+void leader_end(void) {
+    leading = false;
+    leader_end_user();
+}
+
+bool leader_sequence_active(void) {
+    return leading;
+}
+
+bool leader_sequence_timed_out(void) {
+    return timer_elapsed(leader_time) > LEADER_TIMEOUT;
+}
+
+static void leader_task(void) {
+    if (leader_sequence_active() && leader_sequence_timed_out()) leader_end();
+}
+
+static bool process_leader(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return true;
+    if (leader_sequence_active() && !leader_sequence_timed_out()) {
+        if (IS_QK_MOD_TAP(keycode)) {
+            keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+        } else if (IS_QK_LAYER_TAP(keycode)) {
+            keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+        }
+#ifdef LEADER_PER_KEY_TIMING
+        leader_time = timer_read();
+#endif
+        if (leader_add_user(keycode)) leader_end();
+        return false;
+    }
+    if (keycode == QK_LEADER) leader_start();
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Record pipeline (action.c, quantum.c)
+// ---------------------------------------------------------------------------
+
+__attribute__((weak)) void post_process_record_user(uint16_t keycode, keyrecord_t *record) {}
+
+// Keymap action of a keycode: default QMK handling once the keymap let it through
+static void process_action(keyrecord_t *record, uint16_t keycode) {
+    keyevent_t event     = record->event;
+    uint8_t    tap_count = record->tap.count;
+    if (event.pressed) clear_weak_mods();
+
+    keycode = keycode_config(keycode);
+    if (IS_QK_MOD_TAP(keycode)) {
+        uint8_t mods = mods5_bits(mod_config(QK_MOD_TAP_GET_MODS(keycode)));
+        uint8_t code = keycode_config(QK_MOD_TAP_GET_TAP_KEYCODE(keycode));
+        if (event.pressed) {
+            if (tap_count > 0) {
+                register_code(code);
+            } else {
+                register_mods(mods);
+            }
+        } else {
+            if (tap_count > 0) {
+                unregister_code(code);
+            } else {
+                unregister_mods(mods);
+            }
+        }
+    } else if (IS_QK_LAYER_TAP(keycode)) {
+        uint8_t layer = QK_LAYER_TAP_GET_LAYER(keycode);
+        uint8_t code  = keycode_config(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode));
+        if (event.pressed) {
+            if (tap_count > 0) {
+                register_code(code);
+            } else {
+                layer_on(layer);
+            }
+        } else {
+            if (tap_count > 0) {
+                unregister_code(code);
+            } else {
+                layer_off(layer);
+            }
+        }
+    } else if (IS_QK_MODS(keycode)) {
+        uint8_t mods = mods5_bits(mod_config(QK_MODS_GET_MODS(keycode)));
+        uint8_t code = keycode_config(QK_MODS_GET_BASIC_KEYCODE(keycode));
+        bool    real = IS_MODIFIER_KEYCODE(code) || code == KC_NO;
+        if (event.pressed) {
+            if (real) {
+                add_mods(mods);
+            } else {
+                add_weak_mods(mods);
+            }
+            send_keyboard_report();
+            register_code(code);
+        } else {
+            unregister_code(code);
+            if (real) {
+                del_mods(mods);
+            } else {
+                del_weak_mods(mods);
+            }
+            send_keyboard_report();
+        }
+    } else if (keycode <= 0xFF) {
+        if (event.pressed) {
+            register_code(keycode);
+        } else {
+            unregister_code(keycode);
+        }
+    }
+    // Quantum keycodes (QK_BOOT, QK_REP, AC_*) and the keymap's own: nothing
+}
+
+static bool process_record_quantum(keyrecord_t *record) {
+    uint16_t keycode = get_record_keycode(record, true);
+    return process_record_user(keycode, record) && process_leader(keycode, record);
+}
+
+static void process_record(keyrecord_t *record) {
+    if (record->event.type == TICK_EVENT) return;
+    if (!process_record_quantum(record)) return;
+    process_action(record, get_record_keycode(record, false));
+    post_process_record_kb(get_record_keycode(record, false), record);
+}
+
+// ---------------------------------------------------------------------------
+// Tap-hold (action_tapping.c)
+// ---------------------------------------------------------------------------
+
+#define WAITING_BUFFER_SIZE 8
+
+static keyrecord_t tapping_key = {0};
+static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE];
+static uint8_t     waiting_buffer_head = 0;
+static uint8_t     waiting_buffer_tail = 0;
+
+#define IS_EVENT(e) ((e).type != TICK_EVENT)
+#define IS_NOEVENT(e) ((e).type == TICK_EVENT)
+#define KEYEQ(a, b) ((a).row == (b).row && (a).col == (b).col)
+#define IS_TAPPING() IS_EVENT(tapping_key.event)
+#define IS_TAPPING_RECORD(r) (IS_TAPPING() && KEYEQ(tapping_key.event.key, (r)->event.key))
+
+static bool is_tap_keycode(uint16_t keycode) {
+    return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+}
+
+// The keymap's action at the position (QMK does not look at record->keycode here without COMBO_ENABLE)
+static bool is_tap_record(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) return false;
+    keypos_t key = record->event.key;
+    return is_tap_keycode(keymap_key_to_keycode(layer_switch_get_layer(key), key));
+}
+
+static uint16_t tapping_keycode(void) {
+    return get_record_keycode(&tapping_key, false);
+}
+
+static bool within_tapping_term(keyevent_t e) {
+    return TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_term(tapping_keycode(), &tapping_key);
+}
+
+static bool within_quick_tap_term(keyevent_t e) {
+    return TIMER_DIFF_16(e.time, tapping_key.event.time) < get_quick_tap_term(tapping_keycode(), &tapping_key);
+}
+
+static bool waiting_buffer_enq(keyrecord_t record) {
+    if (IS_NOEVENT(record.event)) return true;
+    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+        fprintf(stderr, "host: waiting buffer full\n");
+        return false;
+    }
+    waiting_buffer[waiting_buffer_head] = record;
+    waiting_buffer_head                 = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    return true;
+}
+
+static bool waiting_buffer_typed(keyevent_t event) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed != waiting_buffer[i].event.pressed) return true;
+    }
+    return false;
+}
+
+// A new tapping key whose release is already buffered is a tap
+static void waiting_buffer_scan_tap(void) {
+    if (tapping_key.tap.count > 0 || !tapping_key.event.pressed) return;
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+        keyrecord_t *candidate = &waiting_buffer[i];
+        if (KEYEQ(candidate->event.key, tapping_key.event.key) && !candidate->event.pressed && within_tapping_term(candidate->event)) {
+            tapping_key.tap.count = 1;
+            candidate->tap.count  = 1;
+            process_record(&tapping_key);
+            return;
+        }
+    }
+}
+
+#ifdef CHORDAL_HOLD
+// Keys Chordal Hold settled as tapped: their release is a tap release even
+// after another key took over as the tapping key (registered_taps[])
+#    define REGISTERED_TAPS_SIZE 8
+
+static keypos_t registered_taps[REGISTERED_TAPS_SIZE];
+static uint8_t  num_registered_taps = 0;
+
+static void registered_taps_add(keypos_t key) {
+    if (num_registered_taps < REGISTERED_TAPS_SIZE) registered_taps[num_registered_taps++] = key;
+}
+
+static bool registered_taps_take(keypos_t key) {
+    for (uint8_t i = 0; i < num_registered_taps; i++) {
+        if (KEYEQ(registered_taps[i], key)) {
+            registered_taps[i] = registered_taps[--num_registered_taps];
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+__attribute__((weak)) bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record) {
+    // Handedness from keyboard.json: matrix rows 0-2 are the right half, 4-6 the left
+    if (other_record->event.type != KEY_EVENT) return true;
+    return (tap_hold_record->event.key.row >= 4) != (other_record->event.key.row >= 4);
+}
+
+static bool process_tapping(keyrecord_t *keyp) {
+    keyevent_t event = keyp->event;
+
+#ifdef CHORDAL_HOLD
+    if (IS_EVENT(event) && !event.pressed && registered_taps_take(event.key)) keyp->tap.count = 1;
+#endif
+
+    if (!IS_TAPPING()) {
+        if (IS_EVENT(event) && event.pressed && is_tap_record(keyp)) {
+            tapping_key = *keyp;
+            waiting_buffer_scan_tap();
+        } else {
+            process_record(keyp);
+        }
+        return true;
+    }
+
+    if (tapping_key.event.pressed) {
+        if (within_tapping_term(event)) {
+            if (IS_NOEVENT(event)) return true;
+            if (tapping_key.tap.count == 0) {
+                if (IS_TAPPING_RECORD(keyp) && !event.pressed) {
+                    // First tap
+                    tapping_key.tap.count = 1;
+                    process_record(&tapping_key);
+                    keyp->tap = tapping_key.tap;
+                    return false;
+                }
+                if (!event.pressed && waiting_buffer_typed(event) && get_permissive_hold(tapping_keycode(), &tapping_key)) {
+                    // A key pressed and released inside: hold
+                    process_record(&tapping_key);
+                    tapping_key = (keyrecord_t){0};
+                    return false;
+                }
+#ifdef CHORDAL_HOLD
+                if (event.pressed && waiting_buffer_head == waiting_buffer_tail &&
+                    !get_chordal_hold(tapping_keycode(), &tapping_key, get_record_keycode(keyp, false), keyp)) {
+                    // Same hand: settle as tapped
+                    tapping_key.tap.count = 1;
+                    registered_taps_add(tapping_key.event.key);
+                    process_record(&tapping_key);
+                    return false;
+                }
+#endif
+                if (!event.pressed && !waiting_buffer_typed(event)) {
+                    // Release of a key pressed before the tapping key
+                    process_record(keyp);
+                    return true;
+                }
+                if (event.pressed) {
+                    tapping_key.tap.interrupted = true;
+                    if (get_hold_on_other_key_press(tapping_keycode(), &tapping_key)) {
+                        process_record(&tapping_key);
+                        tapping_key = (keyrecord_t){0};
+                    }
+                }
+                return false;
+            }
+            // Tapped, still down
+            if (IS_TAPPING_RECORD(keyp) && !event.pressed) {
+                keyp->tap = tapping_key.tap;
+                process_record(keyp);
+                tapping_key = *keyp;
+                return true;
+            }
+            if (is_tap_record(keyp) && event.pressed) {
+                tapping_key = *keyp;
+                waiting_buffer_scan_tap();
+                return true;
+            }
+            process_record(keyp);
+            return true;
+        }
+        // After the tapping term
+        if (tapping_key.tap.count == 0) {
+            process_record(&tapping_key);
+            tapping_key = (keyrecord_t){0};
+            return false;
+        }
+        if (IS_NOEVENT(event)) return true;
+        if (IS_TAPPING_RECORD(keyp) && !event.pressed) {
+            keyp->tap = tapping_key.tap;
+            process_record(keyp);
+            tapping_key = (keyrecord_t){0};
+            return true;
+        }
+        if (is_tap_record(keyp) && event.pressed) {
+            tapping_key = *keyp;
+            waiting_buffer_scan_tap();
+            return true;
+        }
+        process_record(keyp);
+        return true;
+    }
+
+    // Tapping key released (tapped): sequential taps within the term
+    if (within_tapping_term(event)) {
+        if (IS_NOEVENT(event)) return true;
+        if (event.pressed) {
+            if (IS_TAPPING_RECORD(keyp)) {
+                if (within_quick_tap_term(event) && !tapping_key.tap.interrupted && tapping_key.tap.count > 0) {
+                    keyp->tap = tapping_key.tap;
+                    if (keyp->tap.count < 15) keyp->tap.count += 1;
+                    process_record(keyp);
+                    tapping_key = *keyp;
+                    return true;
+                }
+                tapping_key = *keyp;
+                return true;
+            }
+            if (is_tap_record(keyp)) {
+                tapping_key = *keyp;
+                waiting_buffer_scan_tap();
+                return true;
+            }
+            tapping_key.tap.interrupted = true;
+        }
+        process_record(keyp);
+        return true;
+    }
+    tapping_key = (keyrecord_t){0};
+    return false;
+}
+
+void action_tapping_process(keyrecord_t record) {
+    if (!process_tapping(&record)) {
+        if (!waiting_buffer_enq(record)) {
+            tapping_key         = (keyrecord_t){0};
+            waiting_buffer_head = waiting_buffer_tail = 0;
+        }
+    }
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
+        if (!process_tapping(&waiting_buffer[waiting_buffer_tail])) break;
+    }
+}
+
+void action_exec(keyevent_t event) {
+    keyrecord_t record = {.event = event};
+    if (IS_EVENT(event)) {
+        host_last_input = timer_read32();
+        // pre_process_record_quantum(): the keycode with the layer cache updated on press
+        if (!pre_process_record_user(get_record_keycode(&record, true), &record)) return;
+    }
+    action_tapping_process(record);
+}
+
+// ---------------------------------------------------------------------------
+// EEPROM, raw HID, LEDs, OS detection, board hooks
+// ---------------------------------------------------------------------------
+
+static uint32_t ee_user;
+static uint8_t  ee_datablock[EECONFIG_USER_DATA_SIZE];
+
+uint32_t eeconfig_read_user(void) {
+    return ee_user;
+}
+
+void eeconfig_update_user(uint32_t val) {
+    ee_user = val;
+}
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length) {
+    if (offset >= sizeof(ee_datablock)) return;
+    memcpy(data, &ee_datablock[offset], MIN(length, sizeof(ee_datablock) - offset));
+}
+
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length) {
+    if (offset >= sizeof(ee_datablock)) return;
+    memcpy(&ee_datablock[offset], data, MIN(length, sizeof(ee_datablock) - offset));
+}
+
+static uint8_t *raw_reply     = NULL;
+static uint8_t  raw_reply_len = 0;
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    if (raw_reply && data != raw_reply) memcpy(raw_reply, data, MIN(length, raw_reply_len));
+}
+
+void host_raw_hid(uint8_t *data, uint8_t length) {
+    raw_reply     = data;
+    raw_reply_len = length;
+    raw_hid_receive(data, length);
+    raw_reply = NULL;
+}
+
+static rgb_t ws2812_color;
+
+void ws2812_init(void) {}
+
+void ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    ws2812_color = (rgb_t){red, green, blue};
+}
+
+void ws2812_flush(void) {
+    host_report_t r = {.kind = HOST_REPORT_LED, .led = ws2812_color};
+    host_emit(&r);
+}
+
+rgb_t hsv_to_rgb(hsv_t hsv) {
+    if (hsv.s == 0) return (rgb_t){hsv.v, hsv.v, hsv.v};
+    uint16_t h = hsv.h, s = hsv.s, v = hsv.v;
+    uint8_t  region    = h * 6 / 255;
+    uint8_t  remainder = (h * 2 - region * 85) * 3;
+    uint8_t  p         = (v * (255 - s)) >> 8;
+    uint8_t  q         = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    uint8_t  t         = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+        case 6:
+        case 0:  return (rgb_t){v, t, p};
+        case 1:  return (rgb_t){q, v, p};
+        case 2:  return (rgb_t){p, v, t};
+        case 3:  return (rgb_t){p, q, v};
+        case 4:  return (rgb_t){t, p, v};
+        default: return (rgb_t){v, p, q};
+    }
+}
+
+static os_variant_t host_os = OS_UNSURE;
+
+os_variant_t detected_host_os(void) {
+    return host_os;
+}
+
+// Board sources that are not built here (matrix.c)
+uint8_t matrix_io_delay = MATRIX_IO_DELAY;
+
+static scan_stats_t scan_stats = {.min_us = UINT16_MAX};
+
+const scan_stats_t *scan_stats_get(void) {
+    return &scan_stats;
+}
+
+void scan_stats_reset(void) {
+    memset(&scan_stats, 0, sizeof(scan_stats));
+    scan_stats.min_us = UINT16_MAX;
+}
+
+// US ANSI send_string tables (send_string_keycodes.h)
+// clang-format off
+const uint8_t ascii_to_shift_lut[16] = {
+    0x00, 0x00, 0x00, 0x00, 0x7E, 0x0F, 0x00, 0xD4,
+    0xFF, 0xFF, 0xFF, 0xC7, 0x00, 0x00, 0x00, 0x78,
+};
+
+const uint8_t ascii_to_keycode_lut[128] = {
+    ['\b'] = KC_BSPC, ['\t'] = KC_TAB, ['\n'] = KC_ENT, [0x1B] = KC_ESC,
+    [' '] = KC_SPC, ['!'] = KC_1, ['"'] = KC_QUOT, ['#'] = KC_3, ['$'] = KC_4, ['%'] = KC_5, ['&'] = KC_7,
+    ['\''] = KC_QUOT, ['('] = KC_9, [')'] = KC_0, ['*'] = KC_8, ['+'] = KC_EQL, [','] = KC_COMM,
+    ['-'] = KC_MINS, ['.'] = KC_DOT, ['/'] = KC_SLSH,
+    ['0'] = KC_0, ['1'] = KC_1, ['2'] = KC_2, ['3'] = KC_3, ['4'] = KC_4,
+    ['5'] = KC_5, ['6'] = KC_6, ['7'] = KC_7, ['8'] = KC_8, ['9'] = KC_9,
+    [':'] = KC_SCLN, [';'] = KC_SCLN, ['<'] = KC_COMM, ['='] = KC_EQL, ['>'] = KC_DOT, ['?'] = KC_SLSH, ['@'] = KC_2,
+    ['A'] = KC_A, ['B'] = KC_B, ['C'] = KC_C, ['D'] = KC_D, ['E'] = KC_E, ['F'] = KC_F, ['G'] = KC_G,
+    ['H'] = KC_H, ['I'] = KC_I, ['J'] = KC_J, ['K'] = KC_K, ['L'] = KC_L, ['M'] = KC_M, ['N'] = KC_N,
+    ['O'] = KC_O, ['P'] = KC_P, ['Q'] = KC_Q, ['R'] = KC_R, ['S'] = KC_S, ['T'] = KC_T, ['U'] = KC_U,
+    ['V'] = KC_V, ['W'] = KC_W, ['X'] = KC_X, ['Y'] = KC_Y, ['Z'] = KC_Z,
+    ['['] = KC_LBRC, ['\\'] = KC_BSLS, [']'] = KC_RBRC, ['^'] = KC_6, ['_'] = KC_MINS, ['`'] = KC_GRV,
+    ['a'] = KC_A, ['b'] = KC_B, ['c'] = KC_C, ['d'] = KC_D, ['e'] = KC_E, ['f'] = KC_F, ['g'] = KC_G,
+    ['h'] = KC_H, ['i'] = KC_I, ['j'] = KC_J, ['k'] = KC_K, ['l'] = KC_L, ['m'] = KC_M, ['n'] = KC_N,
+    ['o'] = KC_O, ['p'] = KC_P, ['q'] = KC_Q, ['r'] = KC_R, ['s'] = KC_S, ['t'] = KC_T, ['u'] = KC_U,
+    ['v'] = KC_V, ['w'] = KC_W, ['x'] = KC_X, ['y'] = KC_Y, ['z'] = KC_Z,
+    ['{'] = KC_LBRC, ['|'] = KC_BSLS, ['}'] = KC_RBRC, ['~'] = KC_GRV, [0x7F] = KC_DEL,
+};
+// clang-format on
+
+// ---------------------------------------------------------------------------
+// Main loop (keyboard.c, main.c)
+// ---------------------------------------------------------------------------
+
+#define HOST_EVENT_QUEUE 64
+
+static keyevent_t host_events[HOST_EVENT_QUEUE];
+static uint8_t    host_event_count = 0;
+
+void host_event(uint8_t row, uint8_t col, bool pressed) {
+    if (host_event_count >= HOST_EVENT_QUEUE) {
+        fprintf(stderr, "host: event queue full\n");
+        return;
+    }
+    host_events[host_event_count++] = (keyevent_t){.key = {.col = col, .row = row}, .type = KEY_EVENT, .pressed = pressed};
+}
+
+void host_step(void) {
+    uint32_t ms = timer_read32();
+    matrix_scan_user();
+    if (host_event_count) {
+        // Events queued in the same ms are one scan's changes
+        keyevent_t events[HOST_EVENT_QUEUE];
+        uint8_t    n = host_event_count;
+        memcpy(events, host_events, n * sizeof(keyevent_t));
+        host_event_count = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            events[i].time = timer_read() | 1;
+            action_exec(events[i]);
+        }
+    } else {
+        action_exec((keyevent_t){.type = TICK_EVENT, .time = timer_read() | 1});
+    }
+    leader_task();
+    deferred_exec_task();
+    housekeeping_task_kb();
+    // A pass that blocked (wait_ms) ends in a later ms
+    uint32_t now = timer_read32();
+    host_us      = ((now > ms ? now : ms) + 1) * 1000;
+}
+
+void host_run_until(uint32_t ms) {
+    while (timer_read32() < ms) host_step();
+}
+
+void host_boot(os_variant_t os) {
+    keymap_config.nkro = true;  // force_nkro
+    keyboard_pre_init_user();
+    keyboard_post_init_user();
+    notify_usb_device_state_change_user((struct usb_device_state){.configure_state = USB_DEVICE_STATE_CONFIGURED});
+    if (os != OS_UNSURE) {
+        host_run_until(HOST_OS_DETECT_MS);
+        host_os = os;
+        process_detected_host_os_user(os);
+    }
+    host_run_until(HOST_BOOT_MS);
+}
+
+// ---------------------------------------------------------------------------
+// Report text
+// ---------------------------------------------------------------------------
+
+// clang-format off
+static const char *const host_key_names[256] = {
+    [KC_A] = "A", [KC_B] = "B", [KC_C] = "C", [KC_D] = "D", [KC_E] = "E", [KC_F] = "F", [KC_G] = "G",
+    [KC_H] = "H", [KC_I] = "I", [KC_J] = "J", [KC_K] = "K", [KC_L] = "L", [KC_M] = "M", [KC_N] = "N",
+    [KC_O] = "O", [KC_P] = "P", [KC_Q] = "Q", [KC_R] = "R", [KC_S] = "S", [KC_T] = "T", [KC_U] = "U",
+    [KC_V] = "V", [KC_W] = "W", [KC_X] = "X", [KC_Y] = "Y", [KC_Z] = "Z",
+    [KC_1] = "1", [KC_2] = "2", [KC_3] = "3", [KC_4] = "4", [KC_5] = "5",
+    [KC_6] = "6", [KC_7] = "7", [KC_8] = "8", [KC_9] = "9", [KC_0] = "0",
+    [KC_ENT] = "ENT", [KC_ESC] = "ESC", [KC_BSPC] = "BSPC", [KC_TAB] = "TAB", [KC_SPC] = "SPC",
+    [KC_MINS] = "MINS", [KC_EQL] = "EQL", [KC_LBRC] = "LBRC", [KC_RBRC] = "RBRC", [KC_BSLS] = "BSLS",
+    [KC_NUHS] = "NUHS", [KC_SCLN] = "SCLN", [KC_QUOT] = "QUOT", [KC_GRV] = "GRV", [KC_COMM] = "COMM",
+    [KC_DOT] = "DOT", [KC_SLSH] = "SLSH", [KC_CAPS] = "CAPS",
+    [KC_F1] = "F1", [KC_F2] = "F2", [KC_F3] = "F3", [KC_F4] = "F4", [KC_F5] = "F5", [KC_F6] = "F6",
+    [KC_F7] = "F7", [KC_F8] = "F8", [KC_F9] = "F9", [KC_F10] = "F10", [KC_F11] = "F11", [KC_F12] = "F12",
+    [KC_PSCR] = "PSCR", [KC_SCRL] = "SCRL", [KC_PAUS] = "PAUS", [KC_INS] = "INS", [KC_HOME] = "HOME",
+    [KC_PGUP] = "PGUP", [KC_DEL] = "DEL", [KC_END] = "END", [KC_PGDN] = "PGDN", [KC_RGHT] = "RGHT",
+    [KC_LEFT] = "LEFT", [KC_DOWN] = "DOWN", [KC_UP] = "UP", [KC_NUM] = "NUM", [KC_PMNS] = "PMNS",
+    [KC_P1] = "P1", [KC_P2] = "P2", [KC_P3] = "P3", [KC_P4] = "P4", [KC_P5] = "P5",
+    [KC_P6] = "P6", [KC_P7] = "P7", [KC_P8] = "P8", [KC_P9] = "P9", [KC_P0] = "P0",
+    [KC_APP] = "APP", [KC_PEQL] = "PEQL",
+};
+// clang-format on
+
+static const char *const host_mod_names[8] = {"LCTL", "LSFT", "LALT", "LGUI", "RCTL", "RSFT", "RALT", "RGUI"};
+
+void host_format(const host_report_t *r, char *buf, size_t len) {
+    size_t n = 0;
+#define HOST_PUT(...) (n += (size_t)snprintf(buf + n, n < len ? len - n : 0, __VA_ARGS__))
+    switch (r->kind) {
+        case HOST_REPORT_KEYBOARD: {
+            HOST_PUT("kbd");
+            bool any = false;
+            for (int m = 0; m < 8; m++) {
+                if (!(r->keyboard.mods & (1 << m))) continue;
+                HOST_PUT("%s%s", any ? "+" : " ", host_mod_names[m]);
+                any = true;
+            }
+            for (int k = 0; k < NKRO_REPORT_BITS * 8; k++) {
+                if (!(r->keyboard.bits[k >> 3] & (1 << (k & 7)))) continue;
+                if (host_key_names[k]) {
+                    HOST_PUT(" %s", host_key_names[k]);
+                } else {
+                    HOST_PUT(" 0x%02X", k);
+                }
+                any = true;
+            }
+            if (!any) HOST_PUT(" -");
+            break;
+        }
+        case HOST_REPORT_MOUSE:
+            HOST_PUT("mouse %02X x=%d y=%d v=%d h=%d", r->mouse.buttons, r->mouse.x, r->mouse.y, r->mouse.v, r->mouse.h);
+            break;
+        case HOST_REPORT_CONSUMER:
+            HOST_PUT("consumer %04X", r->usage);
+            break;
+        case HOST_REPORT_SYSTEM:
+            HOST_PUT("system %04X", r->usage);
+            break;
+        case HOST_REPORT_LED:
+            HOST_PUT("led %d %d %d", r->led.r, r->led.g, r->led.b);
+            break;
+    }
+#undef HOST_PUT
+}
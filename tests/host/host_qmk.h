@@ -0,0 +1,63 @@
+// Host emulation of the QMK core for the toby keymap (tests/host)
+// Runs the keymap sources on Linux against a virtual clock: one main-loop
+// pass per virtual ms (matrix events or a tick, tap-hold, leader timeout,
+// deferred executors, housekeeping), with every report the keymap sends
+// handed to a sink instead of USB.
+
+#pragma once
+#include "quantum.h"
+
+// Trace time 0 is this many virtual ms after power-on: USB configured, the
+// deferred LED init, OS detection and its LED flash are over by then
+#define HOST_BOOT_MS 1500
+
+// OS detection settles this long after power-on
+#define HOST_OS_DETECT_MS 250
+
+typedef enum {
+    HOST_REPORT_KEYBOARD,
+    HOST_REPORT_MOUSE,
+    HOST_REPORT_CONSUMER,
+    HOST_REPORT_SYSTEM,
+    HOST_REPORT_LED,
+} host_report_kind_t;
+
+// One report as the host sees it
+typedef struct {
+    host_report_kind_t kind;
+    uint32_t           time;  // virtual ms
+    union {
+        report_nkro_t  keyboard;  // 6KRO reports are converted
+        report_mouse_t mouse;
+        uint16_t       usage;
+        rgb_t          led;
+    };
+} host_report_t;
+
+// Receives every report from boot on (NULL: drop them)
+void host_set_sink(void (*sink)(const host_report_t *report));
+
+// One line of text for a report: "kbd LSFT A B", "mouse 01 x=3 y=0 v=0 h=0", "led 0 0 0", ...
+void host_format(const host_report_t *report, char *buf, size_t len);
+
+// Power on, enumerate, detect OS (OS_UNSURE: detection never settles) and
+// run until HOST_BOOT_MS
+void host_boot(os_variant_t os);
+
+// Virtual time (ms since power-on)
+uint32_t host_now(void);
+
+// Matrix change seen by the next main-loop pass
+void host_event(uint8_t row, uint8_t col, bool pressed);
+
+// One main-loop pass at the current ms, then on to the next ms
+void host_step(void);
+
+// Main-loop passes until the clock reaches MS
+void host_run_until(uint32_t ms);
+
+// Host keyboard LEDs (Num Lock, Caps Lock, ...)
+void host_set_leds(led_t leds);
+
+// Raw HID request to the keymap; the reply overwrites DATA
+void host_raw_hid(uint8_t *data, uint8_t length);
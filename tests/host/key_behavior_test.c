@@ -0,0 +1,199 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// key_behavior.c against the per-key switch tables keymap.c had before
+// key_behavior_map.h (git show dac284c^:.../keymap.c), copied below as
+// old_*(). Every keycode of every layer at its own position, then every
+// 16-bit keycode at every position (keycodes rewritten in pre-process, or
+// replayed from another layer) and without a record, must get the same
+// tapping term, permissive hold, hold on other key press, quick tap term and
+// HRM index. Terms are compared at boot (ceilings) and again after enough
+// fast taps for tap_adapt.c to shrink them.
+//
+// Built in place of host_keymap.c: it includes keymap.c for HM_A & co.
+
+#include <stdio.h>
+#include "host_keymap.c"
+#include "host_qmk.h"
+
+// clang-format off
+static const tap_adapt_key_t old_tap_adapt_keys[] = {
+    // Home row mods - GUI keys get slightly more time
+    {HM_A, &tune.hrm_gui_offset},
+    {HM_O, &tune.hrm_gui_offset},
+    {HM_R, &tune.hrm_offset},
+    {HM_S, &tune.hrm_offset},
+    {HM_T, &tune.hrm_offset},
+    {HM_N, &tune.hrm_offset},
+    {HM_E, &tune.hrm_offset},
+    {HM_I, &tune.hrm_offset},
+    // Thumb keys - longer tapping term for comfort
+    {ESC_MED, &tune.thumb_offset},
+    {SPC_NAV, &tune.thumb_offset},
+    {TAB_MOU, &tune.thumb_offset},
+    {ENT_SYM, &tune.thumb_offset},
+    {BSP_NUM, &tune.thumb_offset},
+};
+// clang-format on
+
+static uint16_t old_get_tapping_term(uint16_t keycode, keyrecord_t *record) {
+    return tap_adapt_term(keycode);
+}
+
+// Per-key permissive hold
+static bool old_get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        // Enable for thumb keys only (recommended with Chordal Hold)
+        case ESC_MED:
+        case SPC_NAV:
+        case TAB_MOU:
+        case ENT_SYM:
+        case DEL_FKY:
+            return true;
+        case BSP_NUM:
+            // Disable HOOKP for BSPC/NUM to avoid unintended NUM activation after quick BSPC + next key
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Per-key hold on other key press
+static bool old_get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        // Enable for thumb layer keys for faster layer access
+        case ESC_MED:
+        case TAB_MOU:
+        case ENT_SYM:
+        case BSP_NUM:
+        case DEL_FKY:
+            return true;
+        case SPC_NAV:
+            // Keep disabled to avoid accidental NAV; tri-layer uses ENT_SYM + BSP_NUM
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Per-key quick tap term - enables fast repeat for Backspace with guard
+static uint16_t old_get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        case BSP_NUM:
+            // Managed by BSPC state machine; disable quick-tap repeat
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+static int old_hrm_index_for(uint16_t kc) {
+    switch (kc) {
+        case HM_A: return HRM_A_IDX;
+        case HM_R: return HRM_R_IDX;
+        case HM_S: return HRM_S_IDX;
+        case HM_T: return HRM_T_IDX;
+        case HM_N: return HRM_N_IDX;
+        case HM_E: return HRM_E_IDX;
+        case HM_I: return HRM_I_IDX;
+        case HM_O: return HRM_O_IDX;
+        default:   return -1;
+    }
+}
+
+static unsigned failures = 0;
+
+static void check(uint16_t kc, keyrecord_t *rec, const char *where) {
+    const char *what = NULL;
+    if (get_tapping_term(kc, rec) != old_get_tapping_term(kc, rec)) {
+        what = "tapping term";
+    } else if (get_permissive_hold(kc, rec) != old_get_permissive_hold(kc, rec)) {
+        what = "permissive hold";
+    } else if (get_hold_on_other_key_press(kc, rec) != old_get_hold_on_other_key_press(kc, rec)) {
+        what = "hold on other key press";
+    } else if (get_quick_tap_term(kc, rec) != old_get_quick_tap_term(kc, rec)) {
+        what = "quick tap term";
+    } else if (key_behavior_hrm(kc, rec) != old_hrm_index_for(kc)) {
+        what = "HRM index";
+    }
+    if (!what) return;
+    if (failures++ < 20) {
+        if (rec) {
+            printf("FAIL %s: keycode 0x%04X at row %u col %u (%s)\n", what, kc, rec->event.key.row, rec->event.key.col, where);
+        } else {
+            printf("FAIL %s: keycode 0x%04X without record (%s)\n", what, kc, where);
+        }
+    }
+}
+
+static unsigned check_all(const char *when) {
+    unsigned queries = 0;
+    for (uint8_t l = 0; l < keymap_layer_count(); l++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keyrecord_t rec = {.event = {.key = {.col = col, .row = row}, .type = KEY_EVENT, .pressed = true}};
+                check(keycode_at_keymap_location_raw(l, row, col), &rec, when);
+                queries++;
+            }
+        }
+    }
+    for (uint32_t kc = 0; kc <= 0xFFFF; kc++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keyrecord_t rec = {.event = {.key = {.col = col, .row = row}, .type = KEY_EVENT, .pressed = true}};
+                check(kc, &rec, when);
+                queries++;
+            }
+        }
+        check(kc, NULL, when);
+        queries++;
+    }
+    return queries;
+}
+
+// Fast taps of every adaptive key, enough for tap_adapt.c to settle below the ceilings
+static void adapt_terms(void) {
+    for (int n = 0; n < 2 * TAP_ADAPT_MIN_SAMPLES; n++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (tap_adapt_index(keycode_at_keymap_location_raw(0, row, col)) < 0) continue;
+                host_event(row, col, true);
+                host_run_until(host_now() + 40 + n % 30);
+                host_event(row, col, false);
+                host_run_until(host_now() + 300);
+            }
+        }
+    }
+}
+
+int main(void) {
+    host_boot(OS_LINUX);
+
+    if (TAP_ADAPT_KEY_COUNT != ARRAY_SIZE(old_tap_adapt_keys)) {
+        printf("FAIL tap_adapt_keys: %d entries, was %zu\n", TAP_ADAPT_KEY_COUNT, ARRAY_SIZE(old_tap_adapt_keys));
+        failures++;
+    }
+    for (size_t i = 0; i < MIN(ARRAY_SIZE(old_tap_adapt_keys), (size_t)TAP_ADAPT_KEY_COUNT); i++) {
+        if (tap_adapt_keys[i].keycode != old_tap_adapt_keys[i].keycode || tap_adapt_keys[i].offset != old_tap_adapt_keys[i].offset) {
+            printf("FAIL tap_adapt_keys[%zu]: keycode 0x%04X, was 0x%04X (or other ceiling)\n", i, tap_adapt_keys[i].keycode, old_tap_adapt_keys[i].keycode);
+            failures++;
+        }
+    }
+
+    unsigned queries = check_all("ceiling terms");
+
+    uint16_t ceiling = get_tapping_term(HM_A, NULL);
+    adapt_terms();
+    if (get_tapping_term(HM_A, NULL) >= ceiling) {
+        printf("FAIL adaptation: HM_A term still %u after fast taps\n", get_tapping_term(HM_A, NULL));
+        failures++;
+    }
+    queries += check_all("adapted terms");
+
+    if (failures) {
+        printf("FAIL key_behavior vs switch tables: %u mismatches\n", failures);
+        return 1;
+    }
+    printf("PASS key_behavior vs switch tables (%u queries, %u layers)\n", queries, keymap_layer_count());
+    return 0;
+}
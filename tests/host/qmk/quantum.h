@@ -0,0 +1,575 @@
+// QMK surface for the host build of the toby keymap (tests/host)
+// The types, keycodes and calls the keymap sources use, with QMK's values.
+// The behavior behind them (tap-hold, layers, reports, deferred executors,
+// leader, timer) is emulated in host_qmk.c; the one-line headers next to this
+// file stand in for QMK's own and all include this one.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------------
+// Platform
+// ---------------------------------------------------------------------------
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+#define memcpy_P(d, s, n) memcpy(d, s, n)
+#define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
+
+#ifndef MIN
+#    define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#    define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+// RP2040 registers the sources read: the 1 MHz timer and the USB SOF frame
+// number, both driven by the virtual clock (reading SOFRD is one µs of polling)
+typedef struct {
+    uint32_t TIMERAWH, TIMERAWL;
+} host_timer_hw_t;
+typedef struct {
+    uint32_t SOFRD;
+} host_usb_hw_t;
+host_timer_hw_t *host_timer_hw(void);
+host_usb_hw_t   *host_usb_hw(void);
+#define TIMER (host_timer_hw())
+#define USB (host_usb_hw())
+
+// Probe clock for cycle_prof.h: CPU cycles of the host
+#ifdef __x86_64__
+#    include <x86intrin.h>
+#    define CYCLE_PROF_CLOCK() ((uint32_t)__rdtsc())
+#else
+uint32_t host_cycles(void);
+#    define CYCLE_PROF_CLOCK() host_cycles()
+#endif
+
+// ---------------------------------------------------------------------------
+// Board (keyboard.json)
+// ---------------------------------------------------------------------------
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 12
+
+// clang-format off
+#define LAYOUT_split_3x5_3( \
+    k00, k01, k02, k03, k04,   k05, k06, k07, k08, k09, \
+    k10, k11, k12, k13, k14,   k15, k16, k17, k18, k19, \
+    k20, k21, k22, k23, k24,   k25, k26, k27, k28, k29, \
+                   k30, k31, k32, k33, k34, k35) \
+    { \
+        {k05, k06, k07, k08, k09, k33, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}, \
+        {k15, k16, k17, k18, k19, k34, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}, \
+        {k25, k26, k27, k28, k29, k35, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}, \
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}, \
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, k04, k03, k02, k01, k00, k32}, \
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, k14, k13, k12, k11, k10, k31}, \
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, k24, k23, k22, k21, k20, k30}, \
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO}, \
+    }
+// clang-format on
+
+// ---------------------------------------------------------------------------
+// Keycodes (quantum/keycodes.h)
+// ---------------------------------------------------------------------------
+
+// clang-format off
+enum qk_keycode_defines {
+    KC_NO = 0x0000, KC_TRANSPARENT = 0x0001,
+    KC_A = 0x0004, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1 = 0x001E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENTER = 0x0028, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE, KC_MINUS, KC_EQUAL,
+    KC_LEFT_BRACKET, KC_RIGHT_BRACKET, KC_BACKSLASH, KC_NONUS_HASH, KC_SEMICOLON, KC_QUOTE,
+    KC_GRAVE, KC_COMMA, KC_DOT, KC_SLASH, KC_CAPS_LOCK,
+    KC_F1 = 0x003A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+    KC_PRINT_SCREEN = 0x0046, KC_SCROLL_LOCK, KC_PAUSE, KC_INSERT, KC_HOME, KC_PAGE_UP, KC_DELETE,
+    KC_END, KC_PAGE_DOWN, KC_RIGHT, KC_LEFT, KC_DOWN, KC_UP,
+    KC_NUM_LOCK = 0x0053, KC_KP_SLASH, KC_KP_ASTERISK, KC_KP_MINUS, KC_KP_PLUS, KC_KP_ENTER,
+    KC_KP_1, KC_KP_2, KC_KP_3, KC_KP_4, KC_KP_5, KC_KP_6, KC_KP_7, KC_KP_8, KC_KP_9, KC_KP_0,
+    KC_KP_DOT, KC_NONUS_BACKSLASH, KC_APPLICATION, KC_KB_POWER, KC_KP_EQUAL,
+    KC_F13 = 0x0068, KC_F14, KC_F15, KC_F16, KC_F17, KC_F18, KC_F19, KC_F20, KC_F21, KC_F22, KC_F23, KC_F24,
+    KC_SYSTEM_POWER = 0x00A5, KC_SYSTEM_SLEEP, KC_SYSTEM_WAKE,
+    KC_AUDIO_MUTE = 0x00A8, KC_AUDIO_VOL_UP, KC_AUDIO_VOL_DOWN, KC_MEDIA_NEXT_TRACK,
+    KC_MEDIA_PREV_TRACK, KC_MEDIA_STOP, KC_MEDIA_PLAY_PAUSE,
+    QK_MOUSE_CURSOR_UP = 0x00CD, QK_MOUSE_CURSOR_DOWN, QK_MOUSE_CURSOR_LEFT, QK_MOUSE_CURSOR_RIGHT,
+    QK_MOUSE_BUTTON_1, QK_MOUSE_BUTTON_2, QK_MOUSE_BUTTON_3, QK_MOUSE_BUTTON_4,
+    QK_MOUSE_BUTTON_5, QK_MOUSE_BUTTON_6, QK_MOUSE_BUTTON_7, QK_MOUSE_BUTTON_8,
+    QK_MOUSE_WHEEL_UP, QK_MOUSE_WHEEL_DOWN, QK_MOUSE_WHEEL_LEFT, QK_MOUSE_WHEEL_RIGHT,
+    QK_MOUSE_ACCELERATION_0, QK_MOUSE_ACCELERATION_1, QK_MOUSE_ACCELERATION_2,
+    KC_LEFT_CTRL = 0x00E0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI,
+    KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI,
+    QK_MODS = 0x0100, QK_MODS_MAX = 0x1FFF,
+    QK_MOD_TAP = 0x2000, QK_MOD_TAP_MAX = 0x3FFF,
+    QK_LAYER_TAP = 0x4000, QK_LAYER_TAP_MAX = 0x4FFF,
+    QK_BOOTLOADER = 0x7C00,
+    QK_LEADER = 0x7C58,
+    QK_AUTOCORRECT_ON = 0x7C74, QK_AUTOCORRECT_OFF, QK_AUTOCORRECT_TOGGLE,
+    QK_REPEAT_KEY = 0x7C79,
+    QK_KB = 0x7E00,
+    QK_USER = 0x7E40,
+};
+// clang-format on
+
+#define SAFE_RANGE QK_USER
+
+#define KC_TRNS KC_TRANSPARENT
+#define _______ KC_TRANSPARENT
+#define XXXXXXX KC_NO
+#define KC_ENT KC_ENTER
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_SCRL KC_SCROLL_LOCK
+#define KC_PAUS KC_PAUSE
+#define KC_INS KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_NUM KC_NUM_LOCK
+#define KC_PSLS KC_KP_SLASH
+#define KC_PAST KC_KP_ASTERISK
+#define KC_PMNS KC_KP_MINUS
+#define KC_PPLS KC_KP_PLUS
+#define KC_PENT KC_KP_ENTER
+#define KC_P1 KC_KP_1
+#define KC_P2 KC_KP_2
+#define KC_P3 KC_KP_3
+#define KC_P4 KC_KP_4
+#define KC_P5 KC_KP_5
+#define KC_P6 KC_KP_6
+#define KC_P7 KC_KP_7
+#define KC_P8 KC_KP_8
+#define KC_P9 KC_KP_9
+#define KC_P0 KC_KP_0
+#define KC_PDOT KC_KP_DOT
+#define KC_NUBS KC_NONUS_BACKSLASH
+#define KC_APP KC_APPLICATION
+#define KC_PEQL KC_KP_EQUAL
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define MS_UP QK_MOUSE_CURSOR_UP
+#define MS_DOWN QK_MOUSE_CURSOR_DOWN
+#define MS_LEFT QK_MOUSE_CURSOR_LEFT
+#define MS_RGHT QK_MOUSE_CURSOR_RIGHT
+#define MS_BTN1 QK_MOUSE_BUTTON_1
+#define MS_BTN2 QK_MOUSE_BUTTON_2
+#define MS_BTN3 QK_MOUSE_BUTTON_3
+#define MS_BTN4 QK_MOUSE_BUTTON_4
+#define MS_BTN5 QK_MOUSE_BUTTON_5
+#define MS_BTN6 QK_MOUSE_BUTTON_6
+#define MS_BTN7 QK_MOUSE_BUTTON_7
+#define MS_BTN8 QK_MOUSE_BUTTON_8
+#define MS_WHLU QK_MOUSE_WHEEL_UP
+#define MS_WHLD QK_MOUSE_WHEEL_DOWN
+#define MS_WHLL QK_MOUSE_WHEEL_LEFT
+#define MS_WHLR QK_MOUSE_WHEEL_RIGHT
+#define MS_ACL0 QK_MOUSE_ACCELERATION_0
+#define MS_ACL1 QK_MOUSE_ACCELERATION_1
+#define MS_ACL2 QK_MOUSE_ACCELERATION_2
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define QK_BOOT QK_BOOTLOADER
+#define QK_REP QK_REPEAT_KEY
+#define AC_ON QK_AUTOCORRECT_ON
+#define AC_OFF QK_AUTOCORRECT_OFF
+#define AC_TOGG QK_AUTOCORRECT_TOGGLE
+
+#define IS_BASIC_KEYCODE(code) ((code) >= KC_A && (code) <= 0x00A4)
+#define IS_SYSTEM_KEYCODE(code) ((code) >= KC_SYSTEM_POWER && (code) <= KC_SYSTEM_WAKE)
+#define IS_CONSUMER_KEYCODE(code) ((code) >= KC_AUDIO_MUTE && (code) <= 0x00BE)
+#define IS_MOUSE_KEYCODE(code) ((code) >= QK_MOUSE_CURSOR_UP && (code) <= QK_MOUSE_ACCELERATION_2)
+#define IS_MODIFIER_KEYCODE(code) ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+#define IS_QK_MODS(code) ((code) >= QK_MODS && (code) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(code) ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+
+// Modifier keycode wrappers
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_RCTL 0x1100
+#define QK_RSFT 0x1200
+#define QK_RALT 0x1400
+#define QK_RGUI 0x1800
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define RCTL(kc) (QK_RCTL | (kc))
+#define RSFT(kc) (QK_RSFT | (kc))
+#define RALT(kc) (QK_RALT | (kc))
+#define RGUI(kc) (QK_RGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+
+#define KC_TILDE S(KC_GRAVE)
+#define KC_TILD KC_TILDE
+#define KC_UNDERSCORE S(KC_MINUS)
+#define KC_UNDS KC_UNDERSCORE
+#define KC_PLUS S(KC_EQUAL)
+
+// 5-bit modifier masks (MT, mod_config)
+enum mods_5bit {
+    MOD_LCTL = 0x01,
+    MOD_LSFT = 0x02,
+    MOD_LALT = 0x04,
+    MOD_LGUI = 0x08,
+    MOD_RCTL = 0x11,
+    MOD_RSFT = 0x12,
+    MOD_RALT = 0x14,
+    MOD_RGUI = 0x18,
+};
+
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LCTL_T(kc) MT(MOD_LCTL, kc)
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define LALT_T(kc) MT(MOD_LALT, kc)
+#define LGUI_T(kc) MT(MOD_LGUI, kc)
+#define RCTL_T(kc) MT(MOD_RCTL, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define RALT_T(kc) MT(MOD_RALT, kc)
+#define RGUI_T(kc) MT(MOD_RGUI, kc)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+
+// 8-bit report modifiers
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_MASK_CTRL (MOD_BIT(KC_LEFT_CTRL) | MOD_BIT(KC_RIGHT_CTRL))
+#define MOD_MASK_SHIFT (MOD_BIT(KC_LEFT_SHIFT) | MOD_BIT(KC_RIGHT_SHIFT))
+#define MOD_MASK_ALT (MOD_BIT(KC_LEFT_ALT) | MOD_BIT(KC_RIGHT_ALT))
+#define MOD_MASK_GUI (MOD_BIT(KC_LEFT_GUI) | MOD_BIT(KC_RIGHT_GUI))
+
+// ---------------------------------------------------------------------------
+// Key events and records (action.h, keyboard.h)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum {
+    TICK_EVENT  = 0,
+    KEY_EVENT   = 1,
+    COMBO_EVENT = 4,
+} keyevent_type_t;
+
+typedef struct {
+    keypos_t        key;
+    uint16_t        time;
+    keyevent_type_t type;
+    bool            pressed;
+} keyevent_t;
+
+typedef struct {
+    bool    interrupted : 1;
+    bool    reserved2 : 1;
+    bool    reserved1 : 1;
+    bool    reserved0 : 1;
+    uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+    keyevent_t event;
+    tap_t      tap;
+    uint16_t   keycode;  // REPEAT_KEY_ENABLE: overrides the keymap lookup
+} keyrecord_t;
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+typedef union {
+    uint16_t raw;
+    struct {
+        bool swap_control_capslock : 1;
+        bool capslock_to_control : 1;
+        bool swap_lalt_lgui : 1;
+        bool swap_ralt_rgui : 1;
+        bool no_gui : 1;
+        bool swap_grave_esc : 1;
+        bool swap_backslash_backspace : 1;
+        bool nkro : 1;
+        bool swap_lctl_lgui : 1;
+        bool swap_rctl_rgui : 1;
+        bool oneshot_enable : 1;
+        bool swap_escape_capslock : 1;
+        bool autocorrect_enable : 1;
+    };
+} keymap_config_t;
+
+extern keymap_config_t keymap_config;
+
+// ---------------------------------------------------------------------------
+// HID reports (report.h, host_driver.h, host.h)
+// ---------------------------------------------------------------------------
+
+#define KEYBOARD_REPORT_KEYS 6
+#define NKRO_REPORT_BITS 30
+
+typedef struct {
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t keys[KEYBOARD_REPORT_KEYS];
+} report_keyboard_t;
+
+typedef struct {
+    uint8_t report_id;
+    uint8_t mods;
+    uint8_t bits[NKRO_REPORT_BITS];
+} report_nkro_t;
+
+typedef struct {
+    uint8_t buttons;
+    int8_t  x;
+    int8_t  y;
+    int8_t  v;
+    int8_t  h;
+} report_mouse_t;
+
+typedef struct {
+    uint8_t  report_id;
+    uint16_t usage;
+} report_extra_t;
+
+typedef struct {
+    uint8_t (*keyboard_leds)(void);
+    void (*send_keyboard)(report_keyboard_t *);
+    void (*send_nkro)(report_nkro_t *);
+    void (*send_mouse)(report_mouse_t *);
+    void (*send_extra)(report_extra_t *);
+} host_driver_t;
+
+host_driver_t *host_get_driver(void);
+void           host_set_driver(host_driver_t *driver);
+void           host_mouse_send(report_mouse_t *report);
+
+typedef union {
+    uint8_t raw;
+    struct {
+        bool    num_lock : 1;
+        bool    caps_lock : 1;
+        bool    scroll_lock : 1;
+        bool    compose : 1;
+        bool    kana : 1;
+        uint8_t reserved : 3;
+    };
+} led_t;
+
+led_t host_keyboard_led_state(void);
+
+enum usb_device_state_t {
+    USB_DEVICE_STATE_NO_INIT    = 0,
+    USB_DEVICE_STATE_INIT       = 1,
+    USB_DEVICE_STATE_CONFIGURED = 2,
+    USB_DEVICE_STATE_SUSPEND    = 3,
+};
+
+struct usb_device_state {
+    enum usb_device_state_t configure_state;
+};
+
+// ---------------------------------------------------------------------------
+// Actions (action.h, action_util.h, action_layer.h, action_tapping.h)
+// ---------------------------------------------------------------------------
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+
+void    add_key(uint8_t key);
+void    del_key(uint8_t key);
+void    send_keyboard_report(void);
+uint8_t get_mods(void);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    set_mods(uint8_t mods);
+void    clear_mods(void);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    set_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void    register_mods(uint8_t mods);
+void    unregister_mods(uint8_t mods);
+void    register_weak_mods(uint8_t mods);
+void    unregister_weak_mods(uint8_t mods);
+
+void          layer_on(uint8_t layer);
+void          layer_off(uint8_t layer);
+void          layer_state_set(layer_state_t state);
+bool          layer_state_is(uint8_t layer);
+uint8_t       get_highest_layer(layer_state_t state);
+layer_state_t update_tri_layer_state(layer_state_t state, uint8_t layer1, uint8_t layer2, uint8_t layer3);
+#define IS_LAYER_ON(layer) layer_state_is(layer)
+
+void action_tapping_process(keyrecord_t record);
+void action_exec(keyevent_t event);
+
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+#define TIMER_DIFF_32(a, b) ((uint32_t)((a) - (b)))
+
+// ---------------------------------------------------------------------------
+// Timer, wait, deferred executors
+// ---------------------------------------------------------------------------
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+void     wait_ms(uint32_t ms);
+void     wait_us(uint32_t us);
+uint32_t last_input_activity_elapsed(void);
+
+typedef uint8_t deferred_token;
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+#define INVALID_DEFERRED_TOKEN 0
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg);
+bool           extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+bool           cancel_deferred_exec(deferred_token token);
+
+// ---------------------------------------------------------------------------
+// Features: leader, OS detection, caps word, key overrides, send_string, ...
+// ---------------------------------------------------------------------------
+
+void leader_start(void);
+void leader_end(void);
+bool leader_sequence_active(void);
+bool leader_sequence_timed_out(void);
+
+typedef enum {
+    OS_UNSURE,
+    OS_LINUX,
+    OS_WINDOWS,
+    OS_MACOS,
+    OS_IOS,
+} os_variant_t;
+
+os_variant_t detected_host_os(void);
+
+bool is_caps_word_on(void);
+
+typedef struct {
+    uint8_t  trigger_mods;
+    uint16_t trigger;
+    uint16_t replacement;
+} key_override_t;
+#define ko_make_basic(mods, key, repl) ((key_override_t){.trigger_mods = (mods), .trigger = (key), .replacement = (repl)})
+
+extern const uint8_t ascii_to_keycode_lut[128];
+extern const uint8_t ascii_to_shift_lut[16];
+
+// keymap_introspection.h, keymap_common.c
+uint8_t  keymap_layer_count(void);
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column);
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+// eeconfig.h (user word + user datablock)
+uint32_t eeconfig_read_user(void);
+void     eeconfig_update_user(uint32_t val);
+void     eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length);
+void     eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length);
+
+// raw_hid.h
+#define RAW_EPSIZE 32
+void raw_hid_send(uint8_t *data, uint8_t length);
+
+// mousekey.h
+void           mousekey_on(uint8_t code);
+void           mousekey_off(uint8_t code);
+void           mousekey_send(void);
+report_mouse_t mousekey_get_report(void);
+
+// color.h, ws2812.h
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} hsv_t;
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} rgb_t;
+rgb_t hsv_to_rgb(hsv_t hsv);
+void  ws2812_init(void);
+void  ws2812_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
+void  ws2812_flush(void);
+
+// ---------------------------------------------------------------------------
+// Keyboard/user hooks the keymap implements or calls
+// ---------------------------------------------------------------------------
+
+bool          pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool          process_record_user(uint16_t keycode, keyrecord_t *record);
+void          post_process_record_kb(uint16_t keycode, keyrecord_t *record);
+void          post_process_record_user(uint16_t keycode, keyrecord_t *record);
+layer_state_t layer_state_set_user(layer_state_t state);
+void          keyboard_pre_init_user(void);
+void          keyboard_post_init_user(void);
+void          matrix_scan_user(void);
+void          housekeeping_task_kb(void);
+void          housekeeping_task_user(void);
+void          notify_usb_device_state_change_user(struct usb_device_state usb_device_state);
+bool          process_detected_host_os_user(os_variant_t os);
+void          leader_start_user(void);
+void          leader_end_user(void);
+bool          leader_add_user(uint16_t keycode);
+uint16_t      get_tapping_term(uint16_t keycode, keyrecord_t *record);
+uint16_t      get_quick_tap_term(uint16_t keycode, keyrecord_t *record);
+bool          get_permissive_hold(uint16_t keycode, keyrecord_t *record);
+bool          get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record);
+bool          get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record, uint16_t other_keycode, keyrecord_t *other_record);
+void          raw_hid_receive(uint8_t *data, uint8_t length);
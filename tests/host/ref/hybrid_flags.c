@@ -0,0 +1,150 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Reference for the hybrid-key equivalence test: the BSPC/DEL flag logic
+// keymap.c had before hybrid_key.c (git show c270653^:.../keymap.c), behind
+// the hybrid_key.h API so the same keymap links against either. The direct
+// calls the flags made (tap_code(KC_BSPC), layer_on/off(_CMD), leader_start(),
+// apply_layer_color()) go through the keys' handlers with the matching
+// HK_TAP / HK_HOLD / HK_UNHOLD / HK_SHOW bit, which run exactly those calls.
+
+#include QMK_KEYBOARD_H
+#include "hybrid_key.h"
+#include "tune.h"
+
+static void ref_run(uint8_t key, uint8_t actions) {
+    hybrid_key_defs[key].handler(actions);
+}
+
+// DEL_FKY hybrid state (tap leader, hold command layer)
+static bool           del_fky_pressed           = false;
+static bool           del_fky_used_as_hold      = false;
+static bool           del_fky_hold_visual       = false;
+static deferred_token del_fky_hold_visual_token = 0;
+
+static uint32_t del_fky_hold_visual_cb(uint32_t t, void *arg) {
+    if (del_fky_pressed && !leader_sequence_active()) {
+        // Crossing the hold threshold counts as a hold, not a tap-leader.
+        del_fky_used_as_hold = true;
+        del_fky_hold_visual  = true;
+        ref_run(HK_DEL, HK_SHOW);
+    }
+    return 0;
+}
+
+// BSPC triple-tap state (bsp_pressed is never cleared, as before)
+static bool           bsp_pressed           = false;
+static uint8_t        bsp_tap_count         = 0;
+static uint16_t       bsp_last_tap_time     = 0;
+static bool           bsp_repeat_active     = false;
+static bool           bsp_triple_pending    = false;
+static deferred_token bsp_triple_hold_token = 0;
+static deferred_token bsp_repeat_token      = 0;
+
+static uint32_t bsp_repeat_cb(uint32_t t, void *arg) {
+    if (bsp_repeat_active && bsp_pressed) {
+        ref_run(HK_BSPC, HK_TAP);
+        return tune.bspc_repeat_ms;
+    }
+    return 0;
+}
+
+static uint32_t bsp_triple_hold_cb(uint32_t t, void *arg) {
+    if (bsp_triple_pending && bsp_pressed && !bsp_repeat_active) {
+        bsp_repeat_active  = true;
+        bsp_repeat_token   = defer_exec(tune.bspc_repeat_ms, bsp_repeat_cb, NULL);
+        bsp_triple_pending = false;
+    }
+    return 0;
+}
+
+void hybrid_key_init(void) {}
+
+static bool del_process(keyrecord_t *record) {
+    if (record->event.pressed) {
+        del_fky_pressed      = true;
+        del_fky_used_as_hold = false;
+        del_fky_hold_visual  = false;
+        ref_run(HK_DEL, HK_HOLD);
+        cancel_deferred_exec(del_fky_hold_visual_token);
+        del_fky_hold_visual_token = defer_exec(tune.del_hold_visual, del_fky_hold_visual_cb, NULL);
+    } else {
+        if (!del_fky_pressed) return false;
+        cancel_deferred_exec(del_fky_hold_visual_token);
+        del_fky_hold_visual = false;
+        del_fky_pressed     = false;
+        ref_run(HK_DEL, HK_UNHOLD | (del_fky_used_as_hold ? 0 : HK_TAP));
+    }
+    return false;
+}
+
+static bool bspc_process(keyrecord_t *record) {
+    if (record->event.pressed) {
+        bsp_pressed = true;
+        if (timer_elapsed(bsp_last_tap_time) < tune.bspc_triple_term) {
+            bsp_tap_count++;
+        } else {
+            bsp_tap_count = 1;
+        }
+        bsp_last_tap_time = timer_read();
+        if (bsp_tap_count >= 3) {
+            bsp_triple_pending = true;
+            bsp_repeat_active  = false;
+            cancel_deferred_exec(bsp_triple_hold_token);
+            bsp_triple_hold_token = defer_exec(tune.bspc_triple_hold, bsp_triple_hold_cb, NULL);
+            return false;
+        }
+        return true;
+    }
+    if (bsp_triple_pending && !bsp_repeat_active) {
+        cancel_deferred_exec(bsp_triple_hold_token);
+        bsp_triple_pending = false;
+        bsp_tap_count      = 0;
+        ref_run(HK_BSPC, HK_TAP);
+        return false;
+    }
+    if (bsp_repeat_active) {
+        bsp_repeat_active = false;
+        cancel_deferred_exec(bsp_repeat_token);
+        bsp_tap_count = 0;
+        return false;
+    }
+    return true;
+}
+
+bool hybrid_key_process(uint8_t key, keyrecord_t *record) {
+    switch (key) {
+        case HK_DEL:  return del_process(record);
+        case HK_BSPC: return bspc_process(record);
+        default:      return true;
+    }
+}
+
+void hybrid_key_other(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) return;
+    if (del_fky_pressed && keycode != hybrid_key_defs[HK_DEL].keycode && !del_fky_used_as_hold) {
+        del_fky_used_as_hold = true;
+        del_fky_hold_visual  = true;
+        cancel_deferred_exec(del_fky_hold_visual_token);
+        ref_run(HK_DEL, HK_SHOW);
+    }
+    // Cancel repeat when other key is pressed
+    if (keycode != hybrid_key_defs[HK_BSPC].keycode && bsp_repeat_active) {
+        bsp_repeat_active = false;
+        cancel_deferred_exec(bsp_repeat_token);
+    }
+}
+
+uint8_t hybrid_key_state(uint8_t key) {
+    switch (key) {
+        case HK_DEL:
+            if (del_fky_hold_visual) return HK_DEL_HELD;
+            return del_fky_pressed ? HK_DEL_DOWN : HK_DEL_IDLE;
+        case HK_BSPC:
+            if (bsp_repeat_active) return HK_BSPC_REPEAT;
+            if (bsp_triple_pending) return HK_BSPC_TRIPLE;
+            return bsp_tap_count == 0 ? HK_BSPC_IDLE : bsp_tap_count == 1 ? HK_BSPC_ONE : HK_BSPC_TWO;
+        default:
+            return 0;
+    }
+}
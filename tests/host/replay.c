@@ -0,0 +1,174 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Replays an event trace through the host build of the keymap and prints
+// the report stream, one report per line: ms since trace start, then the
+// report ("kbd LSFT A", "mouse 01 x=0 y=0 v=0 h=0", "consumer 00E9", ...).
+//
+// Trace lines (JSONL, the format event_trace.c dumps, plus):
+//   # comment
+//   {"os":"macos"}                          host OS (linux, macos, windows; default linux)
+//   {"t":120,"row":1,"col":5,"down":true}   matrix event at trace ms 120
+//   {"t":120,"key":"BSP","down":true}       same, by LAYOUT position name
+//
+// usage: replay [--prof] trace.jsonl
+//   --prof  append the cycle_prof table (CPU cycles per probed handler)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_qmk.h"
+#include "cycle_prof.h"
+
+// Ms after the last event that timers (auto-release, hold repeat) may still fire
+#define REPLAY_TAIL_MS 3000
+
+// LAYOUT_split_3x5_3 positions by their base-layer legend
+static const struct {
+    const char *name;
+    uint8_t     row, col;
+} replay_keys[] = {
+    {"Q", 4, 10},  {"W", 4, 9},   {"F", 4, 8},   {"P", 4, 7},   {"G", 4, 6},
+    {"J", 0, 0},   {"L", 0, 1},   {"U", 0, 2},   {"Y", 0, 3},   {"'", 0, 4},
+    {"A", 5, 10},  {"R", 5, 9},   {"S", 5, 8},   {"T", 5, 7},   {"D", 5, 6},
+    {"H", 1, 0},   {"N", 1, 1},   {"E", 1, 2},   {"I", 1, 3},   {"O", 1, 4},
+    {"Z", 6, 10},  {"X", 6, 9},   {"C", 6, 8},   {"V", 6, 7},   {"B", 6, 6},
+    {"K", 2, 0},   {"M", 2, 1},   {",", 2, 2},   {".", 2, 3},   {"/", 2, 4},
+    {"ESC", 6, 11}, {"SPC", 5, 11}, {"TAB", 4, 11}, {"ENT", 0, 5}, {"BSP", 1, 5}, {"DEL", 2, 5},
+};
+
+static const char *const prof_names[PROF_COUNT] = {
+#define CYCLE_PROF_NAME(id, name) name,
+    CYCLE_PROF_IDS(CYCLE_PROF_NAME)
+#undef CYCLE_PROF_NAME
+};
+
+static uint32_t trace_start;
+
+static void print_report(const host_report_t *report) {
+    if (report->time < trace_start) return;
+    char line[256];
+    host_format(report, line, sizeof(line));
+    printf("%6ld %s\n", (long)(report->time - trace_start), line);
+}
+
+// Value after "KEY": in a flat JSON object (NULL if absent)
+static const char *json_field(const char *line, const char *key) {
+    char pattern[32];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(line, pattern);
+    if (!p) return NULL;
+    p += strlen(pattern);
+    while (*p == ' ') p++;
+    return p;
+}
+
+static bool json_string(const char *line, const char *key, char *out, size_t len) {
+    const char *p = json_field(line, key);
+    if (!p || *p != '"') return false;
+    p++;
+    size_t n = 0;
+    // Legends are single characters or words; '"' is never one
+    while (*p && *p != '"' && n + 1 < len) {
+        if (*p == '\\' && p[1]) p++;
+        out[n++] = *p++;
+    }
+    out[n] = 0;
+    return true;
+}
+
+static bool parse_event(const char *line, uint32_t *t, uint8_t *row, uint8_t *col, bool *down) {
+    const char *pt = json_field(line, "t"), *pd = json_field(line, "down");
+    if (!pt || !pd) return false;
+    *t    = strtoul(pt, NULL, 10);
+    *down = strncmp(pd, "true", 4) == 0;
+
+    char name[8];
+    if (json_string(line, "key", name, sizeof(name))) {
+        for (size_t i = 0; i < ARRAY_SIZE(replay_keys); i++) {
+            if (strcmp(name, replay_keys[i].name) == 0) {
+                *row = replay_keys[i].row;
+                *col = replay_keys[i].col;
+                return true;
+            }
+        }
+        return false;
+    }
+    const char *pr = json_field(line, "row"), *pc = json_field(line, "col");
+    if (!pr || !pc) return false;
+    *row = strtoul(pr, NULL, 10);
+    *col = strtoul(pc, NULL, 10);
+    return true;
+}
+
+static os_variant_t parse_os(const char *name) {
+    if (strcmp(name, "macos") == 0) return OS_MACOS;
+    if (strcmp(name, "windows") == 0) return OS_WINDOWS;
+    if (strcmp(name, "linux") == 0) return OS_LINUX;
+    return OS_UNSURE;
+}
+
+static void print_prof(void) {
+    const cycle_prof_t *prof = cycle_prof_get();
+    printf("\n%-28s %8s %12s %10s %10s\n", "handler", "calls", "cycles", "mean", "max");
+    for (int i = 0; i < PROF_COUNT; i++) {
+        if (!prof[i].count) continue;
+        printf("%-28s %8u %12u %10u %10u\n", prof_names[i], prof[i].count, prof[i].total_us, prof[i].total_us / prof[i].count, prof[i].max_us);
+    }
+}
+
+int main(int argc, char **argv) {
+    bool        prof = false;
+    const char *path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--prof") == 0) {
+            prof = true;
+        } else {
+            path = argv[i];
+        }
+    }
+    FILE *f = path ? fopen(path, "r") : NULL;
+    if (!f) {
+        fprintf(stderr, "usage: %s [--prof] trace.jsonl\n", argv[0]);
+        return 2;
+    }
+
+    // The OS line, if any, has to be known before boot
+    char         line[256];
+    os_variant_t os = OS_LINUX;
+    while (fgets(line, sizeof(line), f)) {
+        char name[16];
+        if (line[0] != '#' && json_string(line, "os", name, sizeof(name))) os = parse_os(name);
+    }
+    rewind(f);
+
+    trace_start = HOST_BOOT_MS;
+    host_set_sink(print_report);
+    host_boot(os);
+    cycle_prof_reset();
+
+    uint32_t last   = 0;
+    int      lineno = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineno++;
+        if (line[0] == '#' || line[0] == '\n' || strstr(line, "\"os\"")) continue;
+        uint32_t t;
+        uint8_t  row, col;
+        bool     down;
+        if (!parse_event(line, &t, &row, &col, &down)) {
+            fprintf(stderr, "%s:%d: bad event\n", path, lineno);
+            return 1;
+        }
+        if (t < last) {
+            fprintf(stderr, "%s:%d: time goes backwards\n", path, lineno);
+            return 1;
+        }
+        host_run_until(trace_start + t);
+        host_event(row, col, down);
+        last = t;
+    }
+    fclose(f);
+    host_run_until(trace_start + last + REPLAY_TAIL_MS);
+
+    if (prof) print_prof();
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// string_out.c report order. Each string is typed through the output queue
+// and the keyboard reports are decoded the way Linux hid-input reads them:
+// modifier field first, then the NKRO bitmap in ascending usage, a press
+// typing its character with the Shift state at that point. The recovered text
+// must equal the string. On Linux, keys are packed ("git status\n" in 9
+// reports); on macOS and Windows (report order not established) no report
+// may press more than one key or hold two down.
+
+#include <stdio.h>
+#include "host_qmk.h"
+#include "os_profile.h"
+#include "string_out.h"
+
+#define MAX_REPORTS 1024
+
+static report_nkro_t reports[MAX_REPORTS];
+static unsigned      report_count;
+
+static void capture(const host_report_t *r) {
+    if (r->kind == HOST_REPORT_KEYBOARD && report_count < MAX_REPORTS) reports[report_count++] = r->keyboard;
+}
+
+static bool bit(const report_nkro_t *r, uint8_t usage) {
+    return r->bits[usage >> 3] & (1 << (usage & 7));
+}
+
+// Character typed by USAGE with SHIFT, from QMK's send_string tables
+static char typed(uint8_t usage, bool shift) {
+    for (int c = 0; c < 128; c++) {
+        if (ascii_to_keycode_lut[c] == usage && PGM_LOADBIT(ascii_to_shift_lut, c) == shift) return (char)c;
+    }
+    return '?';
+}
+
+// hid-input: per report, modifier usages then the key bitmap, lowest usage first
+static void decode(char *text, size_t len, unsigned *max_down, unsigned *max_new) {
+    report_nkro_t prev = {0};
+    size_t        n    = 0;
+    *max_down = *max_new = 0;
+    for (unsigned i = 0; i < report_count; i++) {
+        const report_nkro_t *r     = &reports[i];
+        bool                 shift = r->mods & (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT));
+        unsigned             down = 0, pressed = 0;
+        for (int usage = 0; usage < NKRO_REPORT_BITS * 8; usage++) {
+            if (!bit(r, usage)) continue;
+            down++;
+            if (bit(&prev, usage)) continue;
+            pressed++;
+            if (n + 1 < len) text[n++] = typed(usage, shift);
+        }
+        if (down > *max_down) *max_down = down;
+        if (pressed > *max_new) *max_new = pressed;
+        prev = *r;
+    }
+    text[n] = 0;
+}
+
+static unsigned failures = 0;
+
+// Type STR, check the recovered text; returns the report count (0 on failure)
+static unsigned check(const char *str, const char *os_name, bool packed) {
+    report_count = 0;
+    string_out(str);
+    host_run_until(host_now() + 200 + 10 * (uint32_t)strlen(str));
+
+    char     text[256];
+    unsigned max_down, max_new;
+    decode(text, sizeof(text), &max_down, &max_new);
+    bool ok = strcmp(text, str) == 0 && report_count > 0 && reports[report_count - 1].mods == 0;
+    for (int b = 0; ok && b < NKRO_REPORT_BITS; b++) ok = reports[report_count - 1].bits[b] == 0;
+    if (!ok) {
+        printf("FAIL %s: typed \"%s\", host reads \"%s\" (%u reports)\n", os_name, str, text, report_count);
+        failures++;
+        return 0;
+    }
+    if (!packed && (max_down > 1 || max_new > 1)) {
+        printf("FAIL %s: \"%s\" has a report with %u keys down, %u new (one key per report expected)\n", os_name, str, max_down, max_new);
+        failures++;
+        return 0;
+    }
+    return report_count;
+}
+
+static const char *const strings[] = {
+    "git status\n",
+    "The quick brown fox jumps over the lazy dog.\n",
+    "Hello, World! aaa bb \"quoted\" (x+y)*z = {1,2,3}; ~/path_to/file-name.txt\n",
+    "ssh -p 2222 user@host 'echo $HOME'\t# comment\n",
+};
+
+int main(void) {
+    host_set_sink(capture);
+    host_boot(OS_LINUX);
+
+    // Linux: packed, and exactly the documented count for "git status\n"
+    unsigned linux_reports[ARRAY_SIZE(strings)];
+    for (size_t i = 0; i < ARRAY_SIZE(strings); i++) linux_reports[i] = check(strings[i], "linux", true);
+    if (linux_reports[0] && linux_reports[0] != 9) {
+        printf("FAIL linux: \"git status\\n\" took %u reports, 9 expected\n", linux_reports[0]);
+        failures++;
+    }
+
+    static const struct {
+        os_variant_t os;
+        const char  *name;
+    } others[] = {{OS_MACOS, "macos"}, {OS_WINDOWS, "windows"}};
+    for (size_t o = 0; o < ARRAY_SIZE(others); o++) {
+        os_profile_select(others[o].os);
+        for (size_t i = 0; i < ARRAY_SIZE(strings); i++) {
+            unsigned n = check(strings[i], others[o].name, false);
+            if (n && linux_reports[i] && linux_reports[i] >= n) {
+                printf("FAIL %s: \"%s\" packed on Linux into %u reports, not fewer than %u\n", others[o].name, strings[i], linux_reports[i], n);
+                failures++;
+            }
+        }
+    }
+
+    if (failures) {
+        printf("FAIL string_out report order: %u failures\n", failures);
+        return 1;
+    }
+    printf("PASS string_out report order (\"git status\\n\": %u reports on Linux)\n", linux_reports[0]);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Per-event cost of telemetry.c recording, next to the whole host pipeline
+// it runs in. The keymap boots in the harness; taps on the top and bottom
+// rows go through host_step() (scan pass with one key event: combos,
+// tap-hold, process_record_user and telemetry_key among them), then the
+// recorders are called alone on random events. The bigram table halving
+// (once per 65535 of one bigram) is timed on its own: a two-key loop
+// runs the cell up, read back over TOBY_HID_TELEMETRY.
+
+#include <stdio.h>
+#include "host_qmk.h"
+#include "telemetry.h"
+#include "toby_hid.h"
+#include "bench.h"
+
+#define BENCH_TAPS 20000
+#define BENCH_CALLS 200000
+#define BENCH_HALVINGS 16
+
+// Top and bottom rows: letters and punctuation, no HRMs or thumbs
+static const uint8_t tap_keys[][2] = {
+    {4, 10}, {4, 9}, {4, 8}, {4, 7}, {4, 6}, {0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4},
+    {6, 10}, {6, 9}, {6, 8}, {6, 7}, {6, 6}, {2, 0}, {2, 1}, {2, 2}, {2, 3}, {2, 4},
+};
+
+// LAYOUT_split_3x5_3 order, as telemetry.c counts them
+static const uint8_t layout_keys[TELEMETRY_KEYS][2] = {
+    {4, 10}, {4, 9}, {4, 8}, {4, 7}, {4, 6}, {0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4},
+    {5, 10}, {5, 9}, {5, 8}, {5, 7}, {5, 6}, {1, 0}, {1, 1}, {1, 2}, {1, 3}, {1, 4},
+    {6, 10}, {6, 9}, {6, 8}, {6, 7}, {6, 6}, {2, 0}, {2, 1}, {2, 2}, {2, 3}, {2, 4},
+    {6, 11}, {5, 11}, {4, 11}, {0, 5},  {1, 5}, {2, 5},
+};
+
+// Arena offset of bigram[0][0] (telemetry_arena_t)
+#define BIGRAM_OFFSET (8 + 4 * (TELEMETRY_KEYS + TELEMETRY_LAYERS + 2 * TELEMETRY_HRMS) + 2 * TELEMETRY_LEADER_SLOTS)
+
+static uint32_t samples[2 * BENCH_TAPS + BENCH_CALLS];
+static uint32_t rng = 2654435761u;
+
+static uint32_t next(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static keyrecord_t record(uint8_t key, bool pressed) {
+    return (keyrecord_t){.event = {.key = {.row = layout_keys[key][0], .col = layout_keys[key][1]}, .type = KEY_EVENT, .pressed = pressed}};
+}
+
+static uint16_t bigram(uint8_t prev, uint8_t key) {
+    uint8_t data[32] = {TOBY_HID_TELEMETRY, 0};
+    toby_hid_put_u16(&data[2], BIGRAM_OFFSET + 2 * (prev * TELEMETRY_KEYS + key));
+    telemetry_hid(data, sizeof(data));
+    return toby_hid_get_u16(&data[8]);
+}
+
+static void bench_pipeline(void) {
+    size_t idle = 0, busy = 0;
+    static uint32_t idle_samples[2 * BENCH_TAPS];
+    for (int i = 0; i < BENCH_TAPS; i++) {
+        const uint8_t *k = tap_keys[next() % ARRAY_SIZE(tap_keys)];
+        BENCH_TIME(idle_samples, idle, host_step());
+        idle++;
+        host_event(k[0], k[1], true);
+        BENCH_TIME(samples, busy, host_step());
+        busy++;
+        host_run_until(host_now() + 30 + next() % 60);
+        host_event(k[0], k[1], false);
+        BENCH_TIME(samples, busy, host_step());
+        busy++;
+        host_run_until(host_now() + 20 + next() % 80);
+    }
+    bench_row("host_step, idle", idle_samples, idle);
+    bench_row("host_step, one key event", samples, busy);
+}
+
+static void bench_recorders(void) {
+    size_t n;
+    bool   pressed[2] = {true, false};
+    for (int p = 0; p < 2; p++) {
+        for (n = 0; n < BENCH_CALLS; n++) {
+            keyrecord_t rec = record(next() % TELEMETRY_KEYS, pressed[p]);
+            BENCH_TIME(samples, n, telemetry_key(&rec));
+        }
+        bench_row(p ? "telemetry_key, release" : "telemetry_key, press", samples, n);
+    }
+    for (n = 0; n < BENCH_CALLS; n++) {
+        layer_state_t state = (layer_state_t)1 << (next() % 9) | 1;
+        BENCH_TIME(samples, n, telemetry_layers(state));
+    }
+    bench_row("telemetry_layers", samples, n);
+    for (n = 0; n < BENCH_CALLS; n++) {
+        uint32_t r = next();
+        BENCH_TIME(samples, n, telemetry_hrm(r % TELEMETRY_HRMS, r & 0x100));
+    }
+    bench_row("telemetry_hrm", samples, n);
+}
+
+// Alternate two keys until their bigram cells saturate; time those presses
+static void bench_halving(void) {
+    const uint8_t a = 11, b = 12;  // R, S
+    uint8_t       prev = a, key = b;
+    size_t        n    = 0;
+    keyrecord_t   first = record(a, true);
+    telemetry_key(&first);
+    while (n < BENCH_HALVINGS) {
+        keyrecord_t rec = record(key, true);
+        if (bigram(prev, key) == UINT16_MAX) {
+            BENCH_TIME(samples, n, telemetry_key(&rec));
+            n++;
+        } else {
+            telemetry_key(&rec);
+        }
+        prev = key;
+        key  = key == a ? b : a;
+    }
+    bench_row("telemetry_key, bigram halving", samples, n);
+}
+
+int main(void) {
+    host_boot(OS_LINUX);
+    printf("%u taps on the host pipeline, %u calls per recorder\n", BENCH_TAPS, BENCH_CALLS);
+    bench_header("per event");
+    bench_pipeline();
+    bench_recorders();
+    bench_halving();
+    return 0;
+}
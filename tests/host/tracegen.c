@@ -0,0 +1,67 @@
+// Copyright 2024 Toby
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// Seeded random trace for the hybrid-key equivalence test: presses and
+// releases on BSP and DEL (most of them, in bursts) mixed with a few other
+// keys, with gaps around the triple-tap window, repeat delay and DEL hold
+// threshold. At most three keys are down at once; all are released at the end.
+//
+// usage: tracegen SEED [EVENTS]
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *const keys[]    = {"BSP", "DEL", "Y", "E", "H", "S", "P"};
+static const uint8_t     weights[] = {8, 5, 1, 1, 1, 1, 1};
+#define KEY_COUNT (sizeof(keys) / sizeof(keys[0]))
+
+static uint32_t rng;
+
+static uint32_t next(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static uint32_t gap(void) {
+    switch (next() % 8) {
+        case 0:  return 150 + next() % 450;  // past the triple window / hold thresholds
+        case 1:  return 60 + next() % 140;
+        default: return 5 + next() % 60;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s SEED [EVENTS]\n", argv[0]);
+        return 2;
+    }
+    rng           = (uint32_t)strtoul(argv[1], NULL, 10) * 2654435761u + 1;
+    int    events = argc > 2 ? atoi(argv[2]) : 200;
+    bool   down[KEY_COUNT] = {0};
+    int    held = 0;
+    uint32_t t  = 0;
+
+    printf("# tracegen %s %d\n", argv[1], events);
+    for (int i = 0; i < events; i++) {
+        uint32_t total = 0;
+        for (size_t k = 0; k < KEY_COUNT; k++) total += weights[k];
+        uint32_t pick = next() % total;
+        size_t   k    = 0;
+        while (pick >= weights[k]) pick -= weights[k++];
+        if (!down[k] && held >= 3) continue;
+        down[k] = !down[k];
+        held += down[k] ? 1 : -1;
+        printf("{\"t\":%u,\"key\":\"%s\",\"down\":%s}\n", t, keys[k], down[k] ? "true" : "false");
+        t += gap();
+    }
+    for (size_t k = 0; k < KEY_COUNT; k++) {
+        if (!down[k]) continue;
+        printf("{\"t\":%u,\"key\":\"%s\",\"down\":false}\n", t, keys[k]);
+        t += gap();
+    }
+    return 0;
+}
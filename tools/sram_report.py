@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+# Copyright 2024 Toby
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""SRAM used by the SRAM_HOT_PATH build option (keyboards/cheapinov2/hot_path.h).
+
+Reads the linker map QMK writes next to the firmware and lists every
+.time_critical.* (code) and .data.hot.* (tables) input section with its size.
+
+Usage:
+  tools/sram_report.py [.build/cheapinov2_toby.map]
+"""
+
+import re
+import sys
+from pathlib import Path
+
+# Input section name, then address and size (possibly on the next line), then object
+SECTION = re.compile(r"^\s*(\.(?:time_critical|data\.hot)\.\S+)\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)", re.M)
+
+
+def main():
+    path = Path(sys.argv[1] if len(sys.argv) > 1 else "../qmk_firmware/.build/cheapinov2_toby.map")
+    text = path.read_text(errors="replace")
+    rows = []
+    for name, addr, size, obj in SECTION.findall(text):
+        size = int(size, 16)
+        if size:
+            kind = "code" if name.startswith(".time_critical") else "data"
+            rows.append((kind, name.split(".", 3)[-1] if kind == "data" else name.split(".", 2)[-1], size, Path(obj).name))
+    if not rows:
+        sys.exit(f"{path}: no hot-path sections (built with SRAM_HOT_PATH = yes?)")
+    for kind, name, size, obj in sorted(rows, key=lambda r: (r[0], -r[2])):
+        print(f"  {kind:4s} {name:28s} {size:6d}  {obj}")
+    code = sum(r[2] for r in rows if r[0] == "code")
+    data = sum(r[2] for r in rows if r[0] == "data")
+    print(f"SRAM hot path: {code} bytes code + {data} bytes tables = {code + data} bytes (RP2040 has 264 KB)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,631 @@
+#!/usr/bin/env python3
+# Copyright 2024 Toby
+# SPDX-License-Identifier: GPL-2.0-or-later
+"""Raw HID client for the Cheapino v2 toby keymap (Linux, hidraw, stdlib only).
+
+Protocol: 32-byte reports, byte 0 = command id (see keymaps/toby/toby_hid.h),
+little-endian fields. The keyboard echoes the command id, or 0xFF if unknown.
+
+Usage:
+  toby_hid.py boot [--previous]     boot-phase timestamps (µs since reset)
+  toby_hid.py combo [--reset]       combo buffering latency stats
+  toby_hid.py learned [--merge DICT] [--min N] [--clear]
+                                    typo pairs learned from backspace fixes
+  toby_hid.py terms [--reset]       adaptive tapping terms per key
+  toby_hid.py spec [--reset]        speculative HRM modifier outcomes
+  toby_hid.py telemetry [--save F | --load F] [--top N] [--reset]
+                                    key/bigram/layer/HRM/leader usage counters
+  toby_hid.py eecache [--reset]     EEPROM write-behind cache counters
+  toby_hid.py scan [--save F] [--compare F] [--reset]
+                                    matrix scan-time distribution (SRAM_HOT_PATH before/after)
+  toby_hid.py leds [--reset]        LED compositor frames pushed vs skipped
+  toby_hid.py sof [--save F] [--compare F] [--reset]
+                                    report slack before the next USB SOF (SOF_ALIGNED_SCAN before/after)
+  toby_hid.py tune [NAME [VALUE]] [--defaults]
+                                    runtime timing parameters (applied + persisted at once)
+  toby_hid.py trace [--arm | --stop] [--save F]
+                                    key event capture, JSON lines (EVENT_TRACE builds)
+  toby_hid.py prof [--reset]        time per subsystem: total/calls/max µs (CYCLE_PROF builds)
+  toby_hid.py out [--reset]         output queue: USB reports per character (Unicode, ...)
+"""
+
+import argparse
+import glob
+import json
+import os
+import struct
+import sys
+
+VID = 0xFEE3
+PID = 0x0000
+RAW_USAGE_PAGE = b"\x06\x60\xff"  # QMK raw HID usage page 0xFF60
+REPORT_SIZE = 32
+
+CMD_BOOT_LOG = 0x01
+CMD_COMBO_STATS = 0x02
+CMD_AC_LEARNED = 0x03
+CMD_TAP_TERMS = 0x04
+CMD_SPEC_STATS = 0x05
+CMD_TELEMETRY = 0x06
+CMD_EE_CACHE = 0x07
+CMD_SCAN_HIST = 0x08
+CMD_LED_STATS = 0x09
+CMD_SOF_STATS = 0x0A
+CMD_TUNE = 0x0B
+CMD_EVENT_TRACE = 0x0C
+CMD_CYCLE_PROF = 0x0D
+CMD_OUT_STATS = 0x0E
+
+SPEC_KEYS = ["S (LCtl)", "T (LSft)", "N (RSft)", "E (RCtl)"]  # hrm_spec_keys[] in keymap.c
+UNHANDLED = 0xFF
+
+LEARN_WORD_MAX = 12  # autocorrect_learn.h
+
+BOOT_PHASES = [
+    "pre_init (EEPROM mounted)",
+    "post_init begin (rgblight_init done)",
+    "post_init end",
+    "first scan",
+    "USB configured",
+    "deferred init (FAST_BOOT)",
+    "OS detected",
+    "first key",
+]
+
+
+def find_device():
+    for node in sorted(glob.glob("/sys/class/hidraw/hidraw*")):
+        try:
+            with open(os.path.join(node, "device/uevent")) as f:
+                uevent = f.read()
+            with open(os.path.join(node, "device/report_descriptor"), "rb") as f:
+                desc = f.read()
+        except OSError:
+            continue
+        if f"{VID:08X}:{PID:08X}" in uevent and RAW_USAGE_PAGE in desc:
+            return "/dev/" + os.path.basename(node)
+    sys.exit("cheapino raw HID interface not found (RAW_ENABLE, permissions?)")
+
+
+class Keyboard:
+    def __init__(self, path=None):
+        self.fd = os.open(path or find_device(), os.O_RDWR)
+
+    def request(self, cmd, payload=b""):
+        report = bytes([cmd]) + payload
+        report = report.ljust(REPORT_SIZE, b"\x00")[:REPORT_SIZE]
+        os.write(self.fd, b"\x00" + report)  # report id 0
+        reply = os.read(self.fd, REPORT_SIZE)
+        if reply[0] == UNHANDLED:
+            sys.exit(f"command 0x{cmd:02x} not supported by firmware")
+        return reply
+
+
+def cmd_boot(kb, args):
+    which = 1 if args.previous else 0
+    stamps = []
+    count = boot_count = 0
+    first = 0
+    while True:
+        r = kb.request(CMD_BOOT_LOG, bytes([which, first]))
+        count = r[3]
+        boot_count = struct.unpack_from("<I", r, 4)[0]
+        page = struct.unpack_from("<6I", r, 8)
+        stamps += page[: max(0, count - first)]
+        first += 6
+        if first >= count:
+            break
+    print(f"boot #{boot_count} ({'previous' if which else 'this'} boot)")
+    names = [BOOT_PHASES[i] if i < len(BOOT_PHASES) else f"phase {i}" for i in range(len(stamps))]
+    # Chronological order; phases not reached (0) last
+    prev = 0
+    for us, name in sorted(zip(stamps, names), key=lambda e: (e[0] == 0, e[0])):
+        if us == 0:
+            print(f"  {name:38s}        -")
+            continue
+        delta = f"(+{(us - prev) / 1000:.2f} ms)" if prev else ""
+        print(f"  {name:38s} {us / 1000:9.2f} ms {delta}")
+        prev = us
+
+
+def cmd_combo(kb, args):
+    r = kb.request(CMD_COMBO_STATS, bytes([1 if args.reset else 0]))
+    buffered, early, lat_sum, lat_max, fired, streak = struct.unpack_from("<6I", r, 4)
+    avg = lat_sum / buffered if buffered else 0.0
+    pct = 100.0 * early / buffered if buffered else 0.0
+    print(f"combo-key presses delivered : {buffered}")
+    print(f"  released before COMBO_TERM: {early} ({pct:.1f}%)")
+    print(f"  added latency avg / max   : {avg:.1f} ms / {lat_max} ms")
+    print(f"combos fired                : {fired}")
+    print(f"typing-streak short attempts: {streak}")
+
+
+def read_learned(kb):
+    pairs = []
+    slot, slots = 0, 1
+    while slot < slots:
+        r = kb.request(CMD_AC_LEARNED, bytes([slot]))
+        slots, count, flags = r[2], r[3], r[4]
+        if count:
+            typo = r[5 : 5 + LEARN_WORD_MAX].rstrip(b"\x00").decode("ascii", "replace")
+            fix = r[5 + LEARN_WORD_MAX : 5 + 2 * LEARN_WORD_MAX].rstrip(b"\x00").decode("ascii", "replace")
+            pairs.append((count, bool(flags & 0x01), typo, fix))
+        slot += 1
+    return sorted(pairs, reverse=True)
+
+
+def cmd_learned(kb, args):
+    if args.clear:
+        kb.request(CMD_AC_LEARNED, bytes([0, 1]))
+        print("learned pairs cleared")
+        return
+    pairs = [p for p in read_learned(kb) if p[0] >= args.min]
+    # Whole-word pairs map straight to dictionary entries; mid-word ones need a look
+    lines = [f":{typo}:".ljust(13) + f" -> {fix}" for _, whole, typo, fix in pairs if whole]
+    for count, whole, typo, fix in pairs:
+        kind = "word" if whole else "mid-word, review"
+        print(f"{count:4d}  {typo:12s} -> {fix:12s} ({kind})")
+    if not args.merge:
+        return
+    path = args.merge
+    with open(path, encoding="utf-8") as f:
+        existing = f.read()
+    known = {line.split("->", 1)[0].strip() for line in existing.splitlines() if "->" in line}
+    new = [line for line in lines if line.split("->", 1)[0].strip() not in known]
+    if not new:
+        print(f"{path}: nothing new")
+        return
+    with open(path, "a", encoding="utf-8") as f:
+        if existing and not existing.endswith("\n"):
+            f.write("\n")
+        f.write("\n".join(new) + "\n")
+    print(f"{path}: added {len(new)} entries; run autocorrect_gen.py and rebuild")
+
+
+def keycode_name(kc):
+    # Mod-tap (0x2000) / layer-tap (0x4000) with a basic tap keycode
+    basic = kc & 0xFF
+    name = chr(ord("A") + basic - 0x04) if 0x04 <= basic <= 0x1D else f"0x{basic:02X}"
+    name = {0x28: "ENT", 0x29: "ESC", 0x2A: "BSPC", 0x2B: "TAB", 0x2C: "SPC"}.get(basic, name)
+    if kc & 0xE000 == 0x2000:
+        return f"MT({name})"
+    if kc & 0xF000 == 0x4000:
+        return f"LT{(kc >> 8) & 0x0F}({name})"
+    return f"0x{kc:04X}"
+
+
+def cmd_terms(kb, args):
+    idx, count = 0, 1
+    rows = []
+    while idx < count:
+        r = kb.request(CMD_TAP_TERMS, bytes([idx, 1 if args.reset else 0]))
+        count, pct = r[2], r[3]
+        kc, term, ceiling, p50, ptgt = struct.unpack_from("<5H", r, 4)
+        taps, holds, missed, late = struct.unpack_from("<4I", r, 14)
+        rows.append((keycode_name(kc), term, ceiling, p50, ptgt, taps, holds, missed, late))
+        idx += 1
+    print(f"{'key':10s} {'term':>5s} {'ceil':>5s} {'p50':>5s} {'p' + str(pct):>5s} {'taps':>7s} {'holds':>7s} {'missed':>7s} {'late':>7s}")
+    for name, term, ceiling, p50, ptgt, taps, holds, missed, late in rows:
+        print(f"{name:10s} {term:5d} {ceiling:5d} {p50:5d} {ptgt:5d} {taps:7d} {holds:7d} {missed:7d} {late:7d}")
+    if args.reset:
+        print("stats reset; terms back at their ceilings")
+
+
+def cmd_spec(kb, args):
+    r = kb.request(CMD_SPEC_STATS, bytes([1 if args.reset else 0]))
+    speculated, withdrawn, kept = struct.unpack_from("<3I", r, 4)
+    per_key = struct.unpack_from(f"<{len(SPEC_KEYS)}H", r, 16)
+    pct = 100.0 * withdrawn / speculated if speculated else 0.0
+    print(f"modifiers reported on press : {speculated}")
+    print(f"  withdrawn (key was a tap) : {withdrawn} ({pct:.1f}%)")
+    print(f"  kept (key was a hold)     : {kept}")
+    for name, n in zip(SPEC_KEYS, per_key):
+        print(f"    {name:10s} withdrawn {n}")
+
+
+def cmd_eecache(kb, args):
+    r = kb.request(CMD_EE_CACHE, bytes([1 if args.reset else 0]))
+    flushes, nbytes, stall_max, stall_last = struct.unpack_from("<4I", r, 4)
+    dirty, size = struct.unpack_from("<2H", r, 20)
+    print(f"flush steps        : {flushes}")
+    print(f"bytes written      : {nbytes}")
+    print(f"longest stall      : {stall_max / 1000:.2f} ms (last {stall_last / 1000:.2f} ms)")
+    print(f"dirty blocks       : {dirty} (mirror {size} bytes)")
+
+
+LED_SOURCES = ["leader", "hrm", "cmd", "layer", "os-flash"]
+
+
+def cmd_leds(kb, args):
+    r = kb.request(CMD_LED_STATS, bytes([1 if args.reset else 0]))
+    updates, pushed, skipped, push_max = struct.unpack_from("<4I", r, 4)
+    active = [name for i, name in enumerate(LED_SOURCES) if r[20] & (1 << i)]
+    frames = pushed + skipped
+    pct = 100.0 * skipped / frames if frames else 0.0
+    print(f"slot updates       : {updates}")
+    print(f"frames pushed      : {pushed}")
+    print(f"frames skipped     : {skipped} ({pct:.1f}% unchanged)")
+    print(f"longest push       : {push_max} µs")
+    print(f"active slots       : {', '.join(active) or '-'}")
+
+
+def read_scan_hist(kb):
+    hist, first, count = [], 0, 1
+    while first < count:
+        r = kb.request(CMD_SCAN_HIST, bytes([first]))
+        count, width = r[2], r[3]
+        lo, hi = struct.unpack_from("<2H", r, 4)
+        n = min(6, count - first)
+        hist += struct.unpack_from(f"<{n}I", r, 8)
+        first += n
+    return {"width_us": width, "min_us": lo, "max_us": hi, "hist": hist}
+
+
+def scan_summary(d):
+    total = sum(d["hist"])
+    out = {"scans": total, "min": d["min_us"], "max": d["max_us"]}
+    for p in (50, 90, 99, 99.9):
+        want, seen = total * p / 100.0, 0
+        for i, n in enumerate(d["hist"]):
+            seen += n
+            if seen >= want:
+                out[f"p{p}"] = (i + 1) * d["width_us"]
+                break
+    return out
+
+
+def cmd_scan(kb, args):
+    if args.reset:
+        kb.request(CMD_SCAN_HIST, bytes([0xFF]))
+        print("scan statistics reset")
+        return
+    d = read_scan_hist(kb)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(d, f)
+    cur = scan_summary(d)
+    base = None
+    if args.compare:
+        with open(args.compare) as f:
+            base = scan_summary(json.load(f))
+    print(f"{'':8s} {'now':>9s}" + (f" {'compare':>9s}" if base else ""))
+    for k in ("scans", "min", "p50", "p90", "p99", "p99.9", "max"):
+        unit = "" if k == "scans" else " µs"
+        line = f"{k:8s} {cur.get(k, 0):>9}{unit}"
+        if base:
+            line += f" {base.get(k, 0):>9}{unit}"
+        print(line)
+    peak = max(d["hist"]) or 1
+    for i, n in enumerate(d["hist"]):
+        if n:
+            lo = i * d["width_us"]
+            print(f"  {lo:4d}-{lo + d['width_us'] - 1:<4d} µs {n:9d} {'#' * max(1, 50 * n // peak)}")
+
+
+def read_sof_stats(kb):
+    r = kb.request(CMD_SOF_STATS, bytes([0xFE]))
+    lo, hi, est = struct.unpack_from("<3H", r, 4)
+    events, unsynced, scans, frames = struct.unpack_from("<4I", r, 10)
+    d = {"aligned": bool(r[26]), "min_us": lo if events > unsynced else 0, "max_us": hi, "scan_est_us": est,
+         "events": events, "unsynced": unsynced, "scans": scans, "frames": frames, "hist": []}
+    first, count = 0, 1
+    while first < count:
+        r = kb.request(CMD_SOF_STATS, bytes([first]))
+        count, d["width_us"] = r[2], r[3]
+        n = min(7, count - first)
+        d["hist"] += struct.unpack_from(f"<{n}I", r, 4)
+        first += n
+    return d
+
+
+def sof_summary(d):
+    total = sum(d["hist"])
+    out = {"events": d["events"], "unsynced": d["unsynced"], "min": d["min_us"], "max": d["max_us"]}
+    out["mean"] = round(sum((i + 0.5) * d["width_us"] * n for i, n in enumerate(d["hist"])) / total) if total else 0
+    for p in (1, 10, 50):
+        want, seen = total * p / 100.0, 0
+        for i, n in enumerate(d["hist"]):
+            seen += n
+            if seen >= want:
+                out[f"p{p}"] = i * d["width_us"]
+                break
+    return out
+
+
+def cmd_sof(kb, args):
+    if args.reset:
+        kb.request(CMD_SOF_STATS, bytes([0xFF]))
+        print("SOF statistics reset")
+        return
+    d = read_sof_stats(kb)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump(d, f)
+    print(f"scan schedule      : {'SOF-aligned' if d['aligned'] else 'free-running'}"
+          f" ({d['scans']} scans / {d['frames']} frames, scan estimate {d['scan_est_us']} µs)")
+    cur = sof_summary(d)
+    base = None
+    if args.compare:
+        with open(args.compare) as f:
+            base = sof_summary(json.load(f))
+    print(f"{'slack':8s} {'now':>9s}" + (f" {'compare':>9s}" if base else ""))
+    for k in ("events", "unsynced", "min", "p1", "p10", "p50", "mean", "max"):
+        unit = "" if k in ("events", "unsynced") else " µs"
+        line = f"{k:8s} {cur.get(k, 0):>9}{unit}"
+        if base:
+            line += f" {base.get(k, 0):>9}{unit}"
+        print(line)
+    print("(slack = time from report ready to the next SOF; less is fresher, the report waits that long)")
+
+
+TUNE_GET, TUNE_SET, TUNE_DEFAULTS = 0, 1, 2
+TUNE_STATUS = {1: "unknown parameter", 2: "value out of range"}
+
+
+def tune_request(kb, op, idx, value=0):
+    r = kb.request(CMD_TUNE, bytes([op, idx, 0, 0]) + struct.pack("<H", value))
+    count, status = r[3], r[4]
+    value, lo, hi, default = struct.unpack_from("<4H", r, 5)
+    name = bytes(r[13:]).split(b"\0")[0].decode()
+    return {"count": count, "status": status, "name": name, "value": value, "min": lo, "max": hi, "default": default}
+
+
+def tune_print(p):
+    mark = "" if p["value"] == p["default"] else " *"
+    print(f"{p['name']:18s} {p['value']:6d}   [{p['min']}..{p['max']}, default {p['default']}]{mark}")
+
+
+def cmd_tune(kb, args):
+    first = tune_request(kb, TUNE_DEFAULTS if args.defaults else TUNE_GET, 0)
+    params = [first] + [tune_request(kb, TUNE_GET, i) for i in range(1, first["count"])]
+    if args.name is None:
+        for p in params:
+            tune_print(p)
+        return
+    idx = next((i for i, p in enumerate(params) if p["name"] == args.name), None)
+    if idx is None:
+        sys.exit(f"unknown parameter {args.name!r}; known: {', '.join(p['name'] for p in params)}")
+    p = params[idx]
+    if args.value is not None:
+        p = tune_request(kb, TUNE_SET, idx, args.value)
+        if p["status"]:
+            sys.exit(f"{args.name}: {TUNE_STATUS.get(p['status'], 'error')} (range {p['min']}..{p['max']})")
+    tune_print(p)
+
+
+OUT_SOURCES = ["unicode", "string"]  # out_src_t in keymaps/toby/out_queue.h
+
+
+def cmd_out(kb, args):
+    r = kb.request(CMD_OUT_STATS, bytes([1 if args.reset else 0]))
+    count = r[2]
+    depth = struct.unpack_from("<H", r, 4)[0]
+    dropped, held, lost = struct.unpack_from("<I2H", r, 6)
+    print(f"{'source':10s} {'chars':>8s} {'reports':>9s} {'per char':>8s}")
+    for i in range(count):
+        reports, chars = struct.unpack_from("<2I", r, 14 + 8 * i)
+        name = OUT_SOURCES[i] if i < len(OUT_SOURCES) else f"#{i}"
+        per = f"{reports / chars:8.1f}" if chars else f"{'-':>8s}"
+        print(f"{name:10s} {chars:8d} {reports:9d} {per}")
+    print(f"deepest queue {depth} steps, {dropped} characters dropped (queue full), "
+          f"{held} key events held behind output, {lost} key presses dropped (hold buffer full)")
+    if args.reset:
+        print("counters reset")
+
+
+PROF_NAMES = [  # CYCLE_PROF_IDS in keyboards/cheapinov2/cycle_prof.h
+    "main loop",
+    "scan: rows -> cols",
+    "scan: cols -> rows",
+    "fix_encoder_action",
+    "fix_ghosting",
+    "debounce",
+    "pre_process_record_user",
+    "  combo_index_process",
+    "process_record_user",
+    "  process_autocorrect_ac",
+    "  mouse_engine_process",
+    "defer_exec callbacks",
+    "LED push",
+    "USB send",
+]
+
+
+def cmd_prof(kb, args):
+    if args.reset:
+        kb.request(CMD_CYCLE_PROF, bytes([0xFF]))
+        print("profile reset")
+        return
+    rows, count = [], 1
+    while len(rows) < count:
+        r = kb.request(CMD_CYCLE_PROF, bytes([len(rows)]))
+        count, n = r[2], r[3]
+        if n == 0:
+            break
+        rows += [struct.unpack_from("<3I", r, 4 + 12 * i) for i in range(n)]
+    loop = rows[0][0] if rows and rows[0][0] else 1
+    print(f"{'subsystem':26s} {'total µs':>11s} {'calls':>9s} {'avg µs':>8s} {'max µs':>7s} {'loop %':>6s}")
+    for i, (total, calls, peak) in enumerate(rows):
+        name = PROF_NAMES[i] if i < len(PROF_NAMES) else f"#{i}"
+        avg = total / calls if calls else 0
+        print(f"{name:26s} {total:11d} {calls:9d} {avg:8.2f} {peak:7d} {100.0 * total / loop:6.1f}")
+    print("(inclusive: indented rows and USB/LED are also counted in the row that calls them)")
+
+
+TRACE_STATUS, TRACE_ARM, TRACE_STOP, TRACE_READ = 0, 1, 2, 3
+
+
+def cmd_trace(kb, args):
+    op = TRACE_ARM if args.arm else TRACE_STOP if args.stop else TRACE_STATUS
+    r = kb.request(CMD_EVENT_TRACE, bytes([op]))
+    armed, count, cap = r[2], *struct.unpack_from("<2H", r, 3)
+    print(f"capture {'armed' if armed else 'stopped'}: {count} / {cap} events")
+    if not args.save:
+        return
+    events, t_prev, t_base = [], None, 0
+    while len(events) < count:
+        r = kb.request(CMD_EVENT_TRACE, bytes([TRACE_READ, 0]) + struct.pack("<H", len(events)))
+        n = r[7]
+        if n == 0:
+            break
+        for i in range(n):
+            t, row, col = struct.unpack_from("<H2B", r, 8 + 4 * i)
+            if t_prev is not None and t < t_prev:
+                t_base += 0x10000  # u16 event time wrapped
+            t_prev = t
+            events.append({"t": t_base + t, "row": row, "col": col & 0x7F, "down": bool(col & 0x80)})
+    t0 = events[0]["t"] if events else 0
+    with open(args.save, "w") as f:
+        for e in events:
+            f.write(json.dumps(dict(e, t=e["t"] - t0)) + "\n")
+    print(f"wrote {len(events)} events to {args.save} (t = ms from the first event)")
+
+
+# Base-layer legends in LAYOUT_split_3x5_3 order (telemetry key index)
+KEY_NAMES = (
+    "Q W F P G J L U Y ' "
+    "A R S T D H N E I O "
+    "Z X C V B K M , . / "
+    "ESC SPC TAB ENT BSP DEL"
+).split()
+LAYER_NAMES = ["BASE", "MEDIA", "NAV", "MOUSE", "SYM_R", "NUM", "FKEY", "EXTRA", "CMD"]
+HRM_NAMES = ["A", "R", "S", "T", "N", "E", "I", "O"]
+
+
+def decode_telemetry(blob):
+    magic, version, keys, layers, hrms, leader_slots = struct.unpack_from("<6B", blob, 0)
+    if magic != 0x7E or version != 1:
+        sys.exit(f"unknown telemetry arena (magic 0x{magic:02x}, version {version})")
+    off = 8
+    def take(fmt, n):
+        nonlocal off
+        vals = struct.unpack_from(f"<{n}{fmt}", blob, off)
+        off += struct.calcsize(f"<{n}{fmt}")
+        return list(vals)
+    t = {
+        "presses": take("I", keys),
+        "layer_on": take("I", layers),
+        "hrm_tap": take("I", hrms),
+        "hrm_hold": take("I", hrms),
+        "leader": take("H", leader_slots),
+    }
+    flat = take("H", keys * keys)
+    t["bigram"] = [flat[i * keys : (i + 1) * keys] for i in range(keys)]
+    return t
+
+
+def cmd_telemetry(kb_factory, args):
+    if args.load:
+        with open(args.load, "rb") as f:
+            blob = f.read()
+    else:
+        kb = kb_factory()
+        if args.reset:
+            kb.request(CMD_TELEMETRY, bytes([1, 0, 0]))
+            print("telemetry reset")
+            return
+        blob, size, offset = b"", 1, 0
+        while offset < size:
+            r = kb.request(CMD_TELEMETRY, bytes([0]) + struct.pack("<H", offset))
+            size, n = struct.unpack_from("<H", r, 4)[0], r[6]
+            if n == 0:
+                break
+            blob += r[8 : 8 + n]
+            offset += n
+        if args.save:
+            with open(args.save, "wb") as f:
+                f.write(blob)
+    t = decode_telemetry(blob)
+    name = lambda i: KEY_NAMES[i] if i < len(KEY_NAMES) else f"#{i}"
+
+    total = sum(t["presses"]) or 1
+    print(f"key presses: {sum(t['presses'])}")
+    ranked = sorted(range(len(t["presses"])), key=lambda i: -t["presses"][i])
+    for i in ranked[: args.top]:
+        print(f"  {name(i):4s} {t['presses'][i]:9d}  {100.0 * t['presses'][i] / total:5.1f}%")
+    pairs = [(n, a, b) for a, row in enumerate(t["bigram"]) for b, n in enumerate(row) if n]
+    print("bigrams (relative counts):")
+    for n, a, b in sorted(pairs, reverse=True)[: args.top]:
+        print(f"  {name(a):>4s} -> {name(b):4s} {n:7d}")
+    print("layer activations:")
+    for l, n in enumerate(t["layer_on"]):
+        if n:
+            print(f"  {LAYER_NAMES[l] if l < len(LAYER_NAMES) else l:6} {n:9d}")
+    print("HRM tap / hold:")
+    for h, (tap, hold) in enumerate(zip(t["hrm_tap"], t["hrm_hold"])):
+        print(f"  {HRM_NAMES[h]}  {tap:8d} / {hold:6d}")
+    used = [(n, i) for i, n in enumerate(t["leader"]) if n]
+    if used:
+        print("leader entries (leader_map.h order):")
+        for n, i in sorted(used, reverse=True):
+            print(f"  #{i:2d} {n:7d}")
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--device", help="hidraw node (default: auto-detect)")
+    sub = p.add_subparsers(dest="cmd", required=True)
+    b = sub.add_parser("boot", help="boot-phase timestamps")
+    b.add_argument("--previous", action="store_true", help="log of the previous (warm) boot")
+    b.set_defaults(func=cmd_boot)
+    c = sub.add_parser("combo", help="combo buffering latency stats")
+    c.add_argument("--reset", action="store_true", help="reset counters after reading")
+    c.set_defaults(func=cmd_combo)
+    lr = sub.add_parser("learned", help="typo pairs learned from backspace fixes")
+    lr.add_argument("--merge", metavar="DICT", help="append new whole-word pairs to autocorrect_dictionary.txt")
+    lr.add_argument("--min", type=int, default=2, help="only pairs seen at least N times (default 2)")
+    lr.add_argument("--clear", action="store_true", help="forget all learned pairs (RAM and flash)")
+    lr.set_defaults(func=cmd_learned)
+    t = sub.add_parser("terms", help="adaptive tapping terms per key")
+    t.add_argument("--reset", action="store_true", help="forget histograms after reading")
+    t.set_defaults(func=cmd_terms)
+    sp = sub.add_parser("spec", help="speculative HRM modifier outcomes")
+    sp.add_argument("--reset", action="store_true", help="reset counters after reading")
+    sp.set_defaults(func=cmd_spec)
+    tm = sub.add_parser("telemetry", help="key/bigram/layer/HRM/leader usage counters")
+    tm.add_argument("--save", metavar="FILE", help="also write the raw arena to FILE")
+    tm.add_argument("--load", metavar="FILE", help="decode a saved arena instead of reading the keyboard")
+    tm.add_argument("--top", type=int, default=15, help="rows per ranking (default 15)")
+    tm.add_argument("--reset", action="store_true", help="clear all counters")
+    tm.set_defaults(func=cmd_telemetry)
+    ec = sub.add_parser("eecache", help="EEPROM write-behind cache counters")
+    ec.add_argument("--reset", action="store_true", help="reset counters after reading")
+    ec.set_defaults(func=cmd_eecache)
+    sc = sub.add_parser("scan", help="matrix scan-time distribution")
+    sc.add_argument("--save", metavar="FILE", help="save the histogram (JSON) for a later --compare")
+    sc.add_argument("--compare", metavar="FILE", help="show a saved histogram side by side")
+    sc.add_argument("--reset", action="store_true", help="clear the histogram")
+    sc.set_defaults(func=cmd_scan)
+    ld = sub.add_parser("leds", help="LED compositor frames pushed vs skipped")
+    ld.add_argument("--reset", action="store_true", help="reset counters after reading")
+    ld.set_defaults(func=cmd_leds)
+    so = sub.add_parser("sof", help="report slack before the next USB SOF")
+    so.add_argument("--save", metavar="FILE", help="save the statistics (JSON) for a later --compare")
+    so.add_argument("--compare", metavar="FILE", help="show saved statistics side by side")
+    so.add_argument("--reset", action="store_true", help="clear the statistics")
+    so.set_defaults(func=cmd_sof)
+    tu = sub.add_parser("tune", help="runtime timing parameters (list, read or set)")
+    tu.add_argument("name", nargs="?", help="parameter (omit to list all)")
+    tu.add_argument("value", nargs="?", type=int, help="new value: applied and persisted at once")
+    tu.add_argument("--defaults", action="store_true", help="restore all compile-time defaults first")
+    tu.set_defaults(func=cmd_tune)
+    tr = sub.add_parser("trace", help="key event capture (EVENT_TRACE builds)")
+    tr.add_argument("--arm", action="store_true", help="clear the buffer and start capturing")
+    tr.add_argument("--stop", action="store_true", help="stop capturing")
+    tr.add_argument("--save", metavar="FILE", help="write captured events as JSON lines")
+    tr.set_defaults(func=cmd_trace)
+    pf = sub.add_parser("prof", help="time per subsystem (CYCLE_PROF builds)")
+    pf.add_argument("--reset", action="store_true", help="clear all counters")
+    pf.set_defaults(func=cmd_prof)
+    ou = sub.add_parser("out", help="output queue: USB reports per character")
+    ou.add_argument("--reset", action="store_true", help="reset counters after reading")
+    ou.set_defaults(func=cmd_out)
+    args = p.parse_args()
+    if args.func is cmd_telemetry:
+        args.func(lambda: Keyboard(args.device), args)
+    else:
+        args.func(Keyboard(args.device), args)
+
+
+if __name__ == "__main__":
+    main()